@@ -0,0 +1,259 @@
+/**
+ * @file billing.h
+ * @brief Header file for tuition and fee billing
+ *
+ * This file contains the data structures used to maintain per-student
+ * tuition charges from course enrollments, both incrementally on every
+ * enroll/drop and as a full parallel recomputation for audit.
+ *
+ * @version 1.0
+ * @date 2026-10-18
+ */
+
+// Included first so that university_management.h, which includes this
+// header after its own classes, is complete before the guard is set.
+#include "university_management.h"
+
+#ifndef BILLING_H
+#define BILLING_H
+
+#include <algorithm>
+#include <cstdint>
+#include <cstddef>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#include <shared_mutex>
+#include <stdexcept>
+
+/**
+ * @brief Structure to represent the billing metadata of a course.
+ *
+ * Amounts are in the smallest currency unit to keep totals exact.
+ */
+struct CourseFee {
+    int course_id;                  ///< Unique identifier for the course
+    int credits;                    ///< Credit hours of the course
+    std::int64_t per_credit_fee;    ///< Tuition charged per credit hour
+    std::int64_t flat_fee;          ///< Fixed lab/activity fee charged per enrollment
+};
+
+/**
+ * @brief Structure to represent a student's current invoice.
+ */
+struct Invoice {
+    int student_id;             ///< Unique identifier for the student
+    int total_credits;          ///< Sum of credits over enrolled courses
+    std::int64_t total_amount;  ///< Sum of charges over enrolled courses
+    std::uint64_t revision;     ///< Incremented whenever the invoice changes
+};
+
+/**
+ * @brief Class to maintain tuition charges from enrollments.
+ *
+ * Attached to a UniversityManager via setBillingEngine(), it applies the
+ * charge of each enrolled or dropped course to the student's invoice in
+ * O(1), and records the student as changed so that only changed invoices
+ * are emitted. recomputeAll() rebuilds every invoice from the enrollment
+ * data in parallel and reports the ones that disagree.
+ */
+class BillingEngine {
+public:
+    /**
+     * @brief Set or replace the billing metadata of a course.
+     *
+     * Existing invoices are not rebilled; run recomputeAll() after fee changes.
+     *
+     * @param fee The course's credit and fee metadata.
+     */
+    void setCourseFee(const CourseFee &fee) {
+        std::unique_lock<std::shared_mutex> lock(mtx);
+        course_fees[fee.course_id] = fee;
+    }
+
+    /**
+     * @brief Check whether a course has billing metadata.
+     *
+     * UniversityManager checks this before applying an enrollment, so
+     * onEnroll() is only called for billable courses. Fees are never
+     * removed, so a course that passes stays billable.
+     *
+     * @param course_id The unique identifier for the course.
+     * @return true if setCourseFee() has been called for the course.
+     */
+    bool isBillable(int course_id) const {
+        std::shared_lock<std::shared_mutex> lock(mtx);
+        return course_fees.count(course_id) != 0;
+    }
+
+    /**
+     * @brief Apply the charge of a newly enrolled course.
+     *
+     * Does not throw for a course that passed isBillable().
+     *
+     * @param student_id The unique identifier for the student.
+     * @param course_id The unique identifier for the course.
+     * @throws std::runtime_error if the course has no billing metadata.
+     */
+    void onEnroll(int student_id, int course_id) {
+        std::unique_lock<std::shared_mutex> lock(mtx);
+        auto fee = course_fees.find(course_id);
+        if (fee == course_fees.end()) {
+            throw std::runtime_error("Course has no billing metadata");
+        }
+        applyCharge(student_id, fee->second, 1);
+    }
+
+    /**
+     * @brief Reverse the charge of a dropped course.
+     *
+     * A course without billing metadata was never charged, e.g. because it
+     * was enrolled before the engine was attached, so it is ignored.
+     *
+     * @param student_id The unique identifier for the student.
+     * @param course_id The unique identifier for the course.
+     */
+    void onDrop(int student_id, int course_id) {
+        std::unique_lock<std::shared_mutex> lock(mtx);
+        auto fee = course_fees.find(course_id);
+        if (fee != course_fees.end()) {
+            applyCharge(student_id, fee->second, -1);
+        }
+    }
+
+    /**
+     * @brief Get a student's current invoice.
+     * @param student_id The unique identifier for the student.
+     * @return The invoice; zero totals if the student has no charges.
+     */
+    Invoice getInvoice(int student_id) const {
+        std::shared_lock<std::shared_mutex> lock(mtx);
+        auto it = invoices.find(student_id);
+        return it == invoices.end() ? Invoice{student_id, 0, 0, 0} : it->second;
+    }
+
+    /**
+     * @brief Take the invoices that changed since the last call.
+     * @return Changed invoices, after which the changed set is cleared.
+     */
+    std::vector<Invoice> takeChangedInvoices() {
+        std::unique_lock<std::shared_mutex> lock(mtx);
+        std::vector<Invoice> changed;
+        changed.reserve(changed_students.size());
+        for (int student_id : changed_students) {
+            changed.push_back(invoices.at(student_id));
+        }
+        changed_students.clear();
+        return changed;
+    }
+
+    /**
+     * @brief Recompute every invoice from the university's enrollments for audit.
+     *
+     * Each of @p threads workers makes one forEachStudent() pass and
+     * totals, in place and without copying course sets, the students whose
+     * ID falls in its shard (student_id modulo @p threads). Invoices whose
+     * totals differ from the incrementally maintained ones are replaced and
+     * returned. Workers read a copy of the fee table and hold no billing
+     * lock while they run; an invoice updated by onEnroll()/onDrop() during
+     * the pass keeps its incremental value, since the pass may have seen
+     * the enrollment on either side of the update.
+     *
+     * @param university The university whose enrollments are billed.
+     * @param threads Number of worker threads, 0 for std::thread::hardware_concurrency().
+     * @return The invoices that changed as a result of the recomputation.
+     */
+    std::vector<Invoice> recomputeAll(const UniversityManager &university, unsigned threads = 0) {
+        if (threads == 0) {
+            threads = std::max(1u, std::thread::hardware_concurrency());
+        }
+        std::unordered_map<int, CourseFee> fees;
+        std::unordered_map<int, std::uint64_t> revisions;
+        {
+            std::shared_lock<std::shared_mutex> lock(mtx);
+            fees = course_fees;
+            revisions.reserve(invoices.size());
+            for (const auto &entry : invoices) {
+                revisions.emplace(entry.first, entry.second.revision);
+            }
+        }
+
+        std::vector<std::vector<Invoice>> shards(threads);
+        std::vector<std::thread> workers;
+        for (unsigned shard = 0; shard < threads; ++shard) {
+            workers.emplace_back([&, shard] {
+                university.forEachStudent([&](const Student &student) {
+                    if (static_cast<std::uint32_t>(student.student_id) % threads != shard) {
+                        return;
+                    }
+                    Invoice invoice{student.student_id, 0, 0, 0};
+                    for (int course_id : student.courses) {
+                        auto fee = fees.find(course_id);
+                        if (fee != fees.end()) {
+                            invoice.total_credits += fee->second.credits;
+                            invoice.total_amount += fee->second.credits * fee->second.per_credit_fee + fee->second.flat_fee;
+                        }
+                    }
+                    shards[shard].push_back(invoice);
+                });
+            });
+        }
+        for (std::thread &worker : workers) {
+            worker.join();
+        }
+
+        std::vector<Invoice> changed;
+        std::unique_lock<std::shared_mutex> lock(mtx);
+        for (const std::vector<Invoice> &shard : shards) {
+            for (const Invoice &computed : shard) {
+                auto it = invoices.find(computed.student_id);
+                auto seen = revisions.find(computed.student_id);
+                std::uint64_t current = it == invoices.end() ? 0 : it->second.revision;
+                if (current != (seen == revisions.end() ? 0 : seen->second)) {
+                    continue; // updated incrementally during the pass
+                }
+                if (it == invoices.end()) {
+                    if (computed.total_credits == 0 && computed.total_amount == 0) {
+                        continue;
+                    }
+                    it = invoices.emplace(computed.student_id, Invoice{computed.student_id, 0, 0, 0}).first;
+                }
+                Invoice &invoice = it->second;
+                if (invoice.total_credits == computed.total_credits && invoice.total_amount == computed.total_amount) {
+                    continue;
+                }
+                invoice.total_credits = computed.total_credits;
+                invoice.total_amount = computed.total_amount;
+                ++invoice.revision;
+                changed_students.insert(invoice.student_id);
+                changed.push_back(invoice);
+            }
+        }
+        return changed;
+    }
+
+private:
+    /**
+     * @brief Add (@p sign = 1) or remove (@p sign = -1) one course's charge; caller holds mtx exclusively.
+     */
+    void applyCharge(int student_id, const CourseFee &fee, int sign) {
+        auto it = invoices.find(student_id);
+        if (it == invoices.end()) {
+            it = invoices.emplace(student_id, Invoice{student_id, 0, 0, 0}).first;
+        }
+        Invoice &invoice = it->second;
+        invoice.total_credits += sign * fee.credits;
+        invoice.total_amount += sign * (fee.credits * fee.per_credit_fee + fee.flat_fee);
+        ++invoice.revision;
+        changed_students.insert(student_id);
+    }
+
+    std::unordered_map<int, CourseFee> course_fees; ///< Billing metadata by course ID
+    std::unordered_map<int, Invoice> invoices;      ///< Current invoice by student ID
+    std::unordered_set<int> changed_students;       ///< Students whose invoice changed since the last take
+    mutable std::shared_mutex mtx; ///< Shared mutex for thread safety
+};
+
+#endif // BILLING_H
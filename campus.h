@@ -0,0 +1,235 @@
+/**
+ * @file campus.h
+ * @brief Header file for multi-campus hosting
+ *
+ * This file contains the data structures used to host several campuses in
+ * one process, each with isolated records, a memory quota and its own
+ * throughput metrics, while sharing the persistence pipeline.
+ *
+ * @version 1.0
+ * @date 2026-10-18
+ */
+
+#ifndef CAMPUS_H
+#define CAMPUS_H
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <shared_mutex>
+#include <stdexcept>
+#include <utility>
+
+#include "university_management.h"
+
+/**
+ * @brief Structure to represent per-campus metrics.
+ */
+struct CampusMetrics {
+    int campus_id;                ///< Unique identifier for the campus
+    std::size_t memory_usage;     ///< Approximate bytes held by the campus's records
+    std::size_t memory_quota;     ///< Configured quota in bytes, 0 for unlimited
+    OperationCounters operations; ///< Read/write counters of the campus
+};
+
+/**
+ * @brief Class to host several campuses in one process.
+ *
+ * Each campus is a separate UniversityManager, so records and locks are
+ * never shared between campuses and one campus's writers cannot block
+ * another's readers. Campuses are created once and never removed, so
+ * references returned by campus() stay valid for the registry's lifetime.
+ */
+class CampusRegistry {
+public:
+    /**
+     * @brief Create a campus.
+     * @param campus_id The unique identifier for the campus.
+     * @param memory_quota Memory quota in bytes, 0 for unlimited.
+     * @return The new campus's manager.
+     * @throws std::runtime_error if the campus already exists.
+     */
+    UniversityManager &addCampus(int campus_id, std::size_t memory_quota) {
+        std::unique_lock<std::shared_mutex> lock(mtx);
+        if (campuses.count(campus_id) != 0) {
+            throw std::runtime_error("Campus already exists");
+        }
+        std::unique_ptr<UniversityManager> manager(new UniversityManager());
+        manager->setMemoryQuota(memory_quota);
+        UniversityManager &added = *manager;
+        campuses.emplace(campus_id, std::move(manager));
+        memory_quotas[campus_id] = memory_quota;
+        return added;
+    }
+
+    /**
+     * @brief Get a campus's manager.
+     * @param campus_id The unique identifier for the campus.
+     * @return The campus's manager.
+     * @throws std::runtime_error if the campus does not exist.
+     */
+    UniversityManager &campus(int campus_id) {
+        std::shared_lock<std::shared_mutex> lock(mtx);
+        return requireCampus(campus_id);
+    }
+
+    /**
+     * @brief Get a campus's manager.
+     * @param campus_id The unique identifier for the campus.
+     * @return The campus's manager.
+     * @throws std::runtime_error if the campus does not exist.
+     */
+    const UniversityManager &campus(int campus_id) const {
+        std::shared_lock<std::shared_mutex> lock(mtx);
+        return requireCampus(campus_id);
+    }
+
+    /**
+     * @brief Change a campus's memory quota.
+     * @param campus_id The unique identifier for the campus.
+     * @param memory_quota Memory quota in bytes, 0 for unlimited.
+     * @throws std::runtime_error if the campus does not exist.
+     */
+    void setMemoryQuota(int campus_id, std::size_t memory_quota) {
+        std::unique_lock<std::shared_mutex> lock(mtx);
+        requireCampus(campus_id).setMemoryQuota(memory_quota);
+        memory_quotas[campus_id] = memory_quota;
+    }
+
+    /**
+     * @brief Snapshot every campus through the shared persistence pipeline.
+     *
+     * A Full save starts a new generation per campus and writes
+     * "<directory>/campus-<id>-g<generation>.base". Each Incremental save
+     * writes the next delta of the current generation,
+     * "<directory>/campus-<id>-g<generation>-d<n>.delta" with n counting
+     * from 1, so no save ever overwrites a base image or an earlier delta.
+     * Files of older generations are left for the caller to remove.
+     *
+     * @param directory Destination directory.
+     * @param mode Whether to write full base images or incremental deltas.
+     * @return Combined record count, write volume and elapsed time.
+     * @throws std::runtime_error if a file cannot be written, or if an Incremental save is requested for a campus with no base image yet.
+     */
+    SnapshotStats saveSnapshots(const std::string &directory, SnapshotMode mode) {
+        auto start = std::chrono::steady_clock::now();
+        std::lock_guard<std::mutex> save_lock(snapshot_mtx);
+        std::vector<std::pair<int, UniversityManager *>> targets;
+        {
+            std::shared_lock<std::shared_mutex> lock(mtx);
+            for (const auto &entry : campuses) {
+                if (mode == SnapshotMode::Incremental) {
+                    auto chain = snapshot_chains.find(entry.first);
+                    if (chain == snapshot_chains.end() || chain->second.generation == 0) {
+                        throw std::runtime_error("Campus " + std::to_string(entry.first) + " has no base snapshot");
+                    }
+                }
+                targets.emplace_back(entry.first, entry.second.get());
+            }
+        }
+        std::sort(targets.begin(), targets.end());
+
+        SnapshotStats total;
+        for (const auto &target : targets) {
+            SnapshotChain next;
+            {
+                std::shared_lock<std::shared_mutex> lock(mtx);
+                auto chain = snapshot_chains.find(target.first);
+                if (chain != snapshot_chains.end()) {
+                    next = chain->second;
+                }
+            }
+            if (mode == SnapshotMode::Full) {
+                ++next.generation;
+                next.deltas = 0;
+            } else {
+                ++next.deltas;
+            }
+            addSnapshotStats(total, target.second->saveSnapshot(snapshotPath(directory, target.first, next), mode));
+            std::unique_lock<std::shared_mutex> lock(mtx);
+            snapshot_chains[target.first] = next;
+        }
+        total.elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+        return total;
+    }
+
+    /**
+     * @brief Get the files that restore a campus to its latest save.
+     * @param directory Directory passed to saveSnapshots().
+     * @param campus_id The unique identifier for the campus.
+     * @return The current generation's base image followed by its deltas, oldest first; empty if the campus was never saved.
+     * @throws std::runtime_error if the campus does not exist.
+     */
+    std::vector<std::string> getSnapshotChain(const std::string &directory, int campus_id) const {
+        std::shared_lock<std::shared_mutex> lock(mtx);
+        requireCampus(campus_id);
+        std::vector<std::string> files;
+        auto chain = snapshot_chains.find(campus_id);
+        if (chain == snapshot_chains.end() || chain->second.generation == 0) {
+            return files;
+        }
+        SnapshotChain position{chain->second.generation, 0};
+        files.push_back(snapshotPath(directory, campus_id, position));
+        for (position.deltas = 1; position.deltas <= chain->second.deltas; ++position.deltas) {
+            files.push_back(snapshotPath(directory, campus_id, position));
+        }
+        return files;
+    }
+
+    /**
+     * @brief Get metrics for every campus.
+     * @return One entry per campus.
+     */
+    std::vector<CampusMetrics> getMetrics() const {
+        std::shared_lock<std::shared_mutex> lock(mtx);
+        std::vector<CampusMetrics> metrics;
+        metrics.reserve(campuses.size());
+        for (const auto &entry : campuses) {
+            metrics.push_back(CampusMetrics{entry.first, entry.second->getMemoryUsage(), memory_quotas.at(entry.first), entry.second->getOperationCounters()});
+        }
+        return metrics;
+    }
+
+private:
+    /**
+     * @brief Position of a campus in its snapshot file sequence.
+     */
+    struct SnapshotChain {
+        std::uint64_t generation = 0; ///< Generation of the latest base image, 0 if none
+        std::uint64_t deltas = 0;     ///< Deltas written in that generation
+    };
+
+    /**
+     * @brief Look up a campus; caller holds mtx.
+     * @throws std::runtime_error if the campus does not exist.
+     */
+    UniversityManager &requireCampus(int campus_id) const {
+        auto it = campuses.find(campus_id);
+        if (it == campuses.end()) {
+            throw std::runtime_error("Campus not found");
+        }
+        return *it->second;
+    }
+
+    /**
+     * @brief File name of a base image (deltas == 0) or delta.
+     */
+    static std::string snapshotPath(const std::string &directory, int campus_id, const SnapshotChain &position) {
+        std::string path = directory + "/campus-" + std::to_string(campus_id) + "-g" + std::to_string(position.generation);
+        return position.deltas == 0 ? path + ".base" : path + "-d" + std::to_string(position.deltas) + ".delta";
+    }
+
+    std::unordered_map<int, std::unique_ptr<UniversityManager>> campuses; ///< Managers by campus ID
+    std::unordered_map<int, std::size_t> memory_quotas;    ///< Configured quota by campus ID
+    std::unordered_map<int, SnapshotChain> snapshot_chains; ///< Snapshot file sequence by campus ID
+    std::mutex snapshot_mtx;       ///< Serializes saveSnapshots() so file names are assigned once
+    mutable std::shared_mutex mtx; ///< Shared mutex guarding the campus map and snapshot_chains
+};
+
+#endif // CAMPUS_H
@@ -0,0 +1,360 @@
+/**
+ * @file epoch.h
+ * @brief Header file for epoch-based memory reclamation
+ *
+ * This file contains an epoch-based reclamation domain used by lock-free
+ * read paths to free replaced objects once no reader can still hold them.
+ *
+ * @version 1.0
+ * @date 2026-10-18
+ */
+
+#ifndef EPOCH_H
+#define EPOCH_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Reclamation counters of an epoch domain.
+ */
+struct EpochStats {
+    std::uint64_t retired = 0;  ///< Objects handed to retire()
+    std::uint64_t freed = 0;    ///< Objects whose deleter has run
+    std::uint64_t advances = 0; ///< Successful global epoch advances
+};
+
+/**
+ * @brief Epoch-based reclamation domain.
+ *
+ * Readers call pin() for the duration of a lock-free traversal. Writers
+ * unlink an object and pass it to retire(), which tags it with the current
+ * global epoch and appends it to the calling thread's retire list. The
+ * global epoch only advances once every pinned thread has observed it, so
+ * an object retired in epoch e is unreachable by any reader once the global
+ * epoch reaches e + 2 and is freed then.
+ *
+ * Pinning costs one store to a per-thread cache line and a fence; it never
+ * touches a shared counter, unlike copying a std::shared_ptr. A thread's
+ * retire list is scanned after every retire_threshold retirements, so
+ * garbage per thread stays bounded unless a reader stays pinned. Thread
+ * records are reused after their thread exits, and the reusing thread
+ * inherits and frees the leftover garbage.
+ */
+class EpochDomain {
+    struct ThreadRecord;
+
+public:
+    /**
+     * @brief RAII pin that keeps retired objects alive while held.
+     */
+    class Guard {
+    public:
+        Guard(Guard &&other) noexcept : record(std::exchange(other.record, nullptr)) {}
+        Guard(const Guard &) = delete;
+        Guard &operator=(const Guard &) = delete;
+        Guard &operator=(Guard &&) = delete;
+
+        /**
+         * @brief Unpin the calling thread when the outermost guard is released.
+         */
+        ~Guard() {
+            if (record != nullptr && --record->nesting == 0) {
+                record->local_epoch.store(0, std::memory_order_release);
+            }
+        }
+
+    private:
+        friend class EpochDomain;
+        explicit Guard(ThreadRecord *pinned) : record(pinned) {}
+
+        ThreadRecord *record; ///< Record of the pinned thread, null once moved from
+    };
+
+    /**
+     * @brief Construct an empty domain.
+     * @param retire_threshold Retirements between scans of a thread's retire list.
+     */
+    explicit EpochDomain(std::size_t retire_threshold = 64)
+        : threshold(retire_threshold == 0 ? 1 : retire_threshold), id(next_domain_id.fetch_add(1)) {
+        LiveDomains &live = liveDomains();
+        std::lock_guard<std::mutex> lock(live.mtx);
+        live.ids.insert(id);
+    }
+
+    /**
+     * @brief Free every retired object. No thread may be pinned.
+     */
+    ~EpochDomain() {
+        {
+            LiveDomains &live = liveDomains();
+            std::lock_guard<std::mutex> lock(live.mtx);
+            live.ids.erase(id);
+        }
+        ThreadRecord *record = head.load(std::memory_order_acquire);
+        while (record != nullptr) {
+            for (Retired &item : record->garbage) {
+                item.deleter(item.object);
+            }
+            ThreadRecord *next = record->next;
+            delete record;
+            record = next;
+        }
+    }
+
+    EpochDomain(const EpochDomain &) = delete;
+    EpochDomain &operator=(const EpochDomain &) = delete;
+
+    /**
+     * @brief Pin the calling thread to the current epoch. Guards may nest.
+     * @return A guard that unpins when destroyed.
+     */
+    Guard pin() {
+        ThreadRecord *record = localRecord();
+        if (record->nesting++ == 0) {
+            std::uint64_t epoch = global_epoch.load(std::memory_order_seq_cst);
+            record->local_epoch.store((epoch << 1) | 1, std::memory_order_seq_cst);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+        }
+        return Guard(record);
+    }
+
+    /**
+     * @brief Retire an unlinked object, deleting it once no reader can hold it.
+     * @tparam T The object type.
+     * @param object The object, already unreachable for new readers.
+     */
+    template <typename T>
+    void retire(T *object) {
+        retire(object, [](void *p) { delete static_cast<T *>(p); });
+    }
+
+    /**
+     * @brief Retire an unlinked object with a custom deleter.
+     * @param object The object, already unreachable for new readers.
+     * @param deleter Called with @p object once it is safe to free.
+     */
+    void retire(void *object, void (*deleter)(void *)) {
+        ThreadRecord *record = localRecord();
+        record->garbage.push_back(Retired{object, deleter, global_epoch.load(std::memory_order_seq_cst)});
+        retired_count.fetch_add(1, std::memory_order_relaxed);
+        if (++record->since_scan >= threshold) {
+            record->since_scan = 0;
+            tryAdvance();
+            collect(record);
+        }
+    }
+
+    /**
+     * @brief Advance the global epoch if every pinned thread has observed it.
+     * @return true if the epoch advanced.
+     */
+    bool tryAdvance() {
+        std::uint64_t epoch = global_epoch.load(std::memory_order_seq_cst);
+        for (ThreadRecord *record = head.load(std::memory_order_acquire); record != nullptr; record = record->next) {
+            std::uint64_t local = record->local_epoch.load(std::memory_order_seq_cst);
+            if ((local & 1) && (local >> 1) != epoch) {
+                return false;
+            }
+        }
+        if (global_epoch.compare_exchange_strong(epoch, epoch + 1, std::memory_order_seq_cst)) {
+            advance_count.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+        return false;
+    }
+
+    /**
+     * @brief Free every retired object that no reader can still hold.
+     *
+     * Tries to advance the global epoch twice, then scans the calling
+     * thread's retire list and the lists left behind by exited threads.
+     * Use after a rare retirement, such as a table replaced on growth, that
+     * would otherwise wait for retire_threshold further retirements. An
+     * object stays retired only while a reader that may hold it is pinned.
+     *
+     * @return Number of objects freed.
+     */
+    std::size_t reclaim() {
+        tryAdvance();
+        tryAdvance();
+        std::size_t freed = collect(localRecord());
+        for (ThreadRecord *record = head.load(std::memory_order_acquire); record != nullptr; record = record->next) {
+            bool expected = false;
+            if (record->in_use.compare_exchange_strong(expected, true, std::memory_order_acq_rel)) {
+                freed += collect(record);
+                record->in_use.store(false, std::memory_order_release);
+            }
+        }
+        return freed;
+    }
+
+    /**
+     * @brief Get reclamation counters.
+     * @return A snapshot of the counters.
+     */
+    EpochStats getStats() const {
+        EpochStats stats;
+        stats.retired = retired_count.load(std::memory_order_relaxed);
+        stats.freed = freed_count.load(std::memory_order_relaxed);
+        stats.advances = advance_count.load(std::memory_order_relaxed);
+        return stats;
+    }
+
+private:
+    /**
+     * @brief An object waiting to be freed.
+     */
+    struct Retired {
+        void *object;            ///< The retired object
+        void (*deleter)(void *); ///< Frees the object
+        std::uint64_t epoch;     ///< Global epoch when retired
+    };
+
+    /**
+     * @brief Per-thread state, linked into the domain and never unlinked.
+     */
+    struct alignas(64) ThreadRecord {
+        std::atomic<std::uint64_t> local_epoch{0}; ///< (epoch << 1) | 1 while pinned, 0 otherwise
+        std::atomic<bool> in_use{true};            ///< False once the owning thread has exited
+        unsigned nesting = 0;                      ///< Depth of nested guards
+        std::size_t since_scan = 0;                ///< Retirements since the last scan
+        std::vector<Retired> garbage;              ///< Objects retired by the owning thread
+        ThreadRecord *next = nullptr;              ///< Next record in the domain
+    };
+
+    /**
+     * @brief IDs of domains not yet destroyed, so exiting threads skip freed records.
+     */
+    struct LiveDomains {
+        std::mutex mtx;                     ///< Guards ids against concurrent domain destruction
+        std::unordered_set<std::uint64_t> ids; ///< IDs of live domains
+    };
+
+    /**
+     * @brief Get the process-wide registry of live domains.
+     * @return The registry.
+     */
+    static LiveDomains &liveDomains() {
+        static LiveDomains live;
+        return live;
+    }
+
+    /**
+     * @brief Releases a thread's records for reuse when the thread exits.
+     *
+     * The most recently used domain is cached so pin() is one compare on
+     * the fast path. Entries of destroyed domains are pruned whenever a
+     * record is acquired, so records holds only live domains no matter how
+     * many domains the thread has outlived.
+     */
+    struct ThreadCache {
+        std::uint64_t last_id = 0;                                     ///< Domain of last, 0 if none
+        ThreadRecord *last = nullptr;                                  ///< Record in the most recently used domain
+        std::vector<std::pair<std::uint64_t, ThreadRecord *>> records; ///< (domain id, record) pairs of live domains
+
+        ~ThreadCache() {
+            LiveDomains &live = liveDomains();
+            std::lock_guard<std::mutex> lock(live.mtx);
+            for (auto &entry : records) {
+                if (live.ids.count(entry.first) != 0) {
+                    entry.second->in_use.store(false, std::memory_order_release);
+                }
+            }
+        }
+    };
+
+    /**
+     * @brief Find or acquire the calling thread's record in this domain.
+     * @return The record.
+     */
+    ThreadRecord *localRecord() {
+        static thread_local ThreadCache cache;
+        if (cache.last_id == id) {
+            return cache.last;
+        }
+        ThreadRecord *record = nullptr;
+        for (auto &entry : cache.records) {
+            if (entry.first == id) {
+                record = entry.second;
+                break;
+            }
+        }
+        if (record == nullptr) {
+            record = acquireRecord();
+            {
+                LiveDomains &live = liveDomains();
+                std::lock_guard<std::mutex> lock(live.mtx);
+                std::size_t kept = 0;
+                for (auto &entry : cache.records) {
+                    if (live.ids.count(entry.first) != 0) {
+                        cache.records[kept++] = entry;
+                    }
+                }
+                cache.records.resize(kept);
+            }
+            cache.records.emplace_back(id, record);
+        }
+        cache.last_id = id;
+        cache.last = record;
+        return record;
+    }
+
+    /**
+     * @brief Claim a record released by an exited thread, or link a new one.
+     * @return A record owned by the calling thread.
+     */
+    ThreadRecord *acquireRecord() {
+        for (ThreadRecord *candidate = head.load(std::memory_order_acquire); candidate != nullptr; candidate = candidate->next) {
+            bool expected = false;
+            if (candidate->in_use.compare_exchange_strong(expected, true, std::memory_order_acq_rel)) {
+                return candidate;
+            }
+        }
+        ThreadRecord *record = new ThreadRecord();
+        ThreadRecord *first = head.load(std::memory_order_relaxed);
+        do {
+            record->next = first;
+        } while (!head.compare_exchange_weak(first, record, std::memory_order_release, std::memory_order_relaxed));
+        return record;
+    }
+
+    /**
+     * @brief Free a thread's retired objects that are two epochs old.
+     * @param record A record owned by the calling thread.
+     * @return Number of objects freed.
+     */
+    std::size_t collect(ThreadRecord *record) {
+        std::uint64_t epoch = global_epoch.load(std::memory_order_seq_cst);
+        std::size_t kept = 0;
+        std::size_t freed = 0;
+        for (Retired &item : record->garbage) {
+            if (item.epoch + 2 <= epoch) {
+                item.deleter(item.object);
+                ++freed;
+            } else {
+                record->garbage[kept++] = item;
+            }
+        }
+        record->garbage.resize(kept);
+        freed_count.fetch_add(freed, std::memory_order_relaxed);
+        return freed;
+    }
+
+    static inline std::atomic<std::uint64_t> next_domain_id{1}; ///< Source of unique domain IDs, never reused
+
+    std::size_t threshold;                      ///< Retirements between scans
+    std::uint64_t id;                           ///< Unique ID of this domain
+    std::atomic<std::uint64_t> global_epoch{1}; ///< Current global epoch
+    std::atomic<ThreadRecord *> head{nullptr};  ///< List of thread records
+    std::atomic<std::uint64_t> retired_count{0}; ///< Objects retired
+    std::atomic<std::uint64_t> freed_count{0};   ///< Objects freed
+    std::atomic<std::uint64_t> advance_count{0}; ///< Epoch advances
+};
+
+#endif // EPOCH_H
@@ -0,0 +1,189 @@
+/**
+ * @file evaluations.h
+ * @brief Header file for course evaluation survey ingestion
+ *
+ * This file contains the data structures used to ingest end-of-term course
+ * evaluation responses in bulk and aggregate them per course and per
+ * faculty member.
+ *
+ * @version 1.0
+ * @date 2026-10-18
+ */
+
+#ifndef EVALUATIONS_H
+#define EVALUATIONS_H
+
+#include <array>
+#include <cstdint>
+#include <cstddef>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#include <mutex>
+#include <shared_mutex>
+
+#include "university_management.h"
+
+constexpr std::size_t kEvaluationQuestions = 16; ///< Number of questions on the evaluation form
+constexpr std::size_t kEvaluationScale = 5;      ///< Answers are on a 1..kEvaluationScale scale, 0 means unanswered
+
+/**
+ * @brief Structure to represent one student's evaluation of one course.
+ */
+struct EvaluationResponse {
+    int student_id;  ///< Unique identifier for the responding student
+    int course_id;   ///< Unique identifier for the evaluated course
+    std::array<std::uint8_t, kEvaluationQuestions> answers; ///< Answer per question, 0 if unanswered
+};
+
+/**
+ * @brief Structure to represent per-question answer distributions.
+ */
+struct EvaluationSummary {
+    std::uint32_t responses = 0; ///< Number of accepted responses
+    std::array<std::array<std::uint32_t, kEvaluationScale + 1>, kEvaluationQuestions> counts{}; ///< counts[q][a] responses answering a to question q
+};
+
+/**
+ * @brief Outcome counts of an ingestion batch.
+ */
+struct IngestResult {
+    std::size_t accepted = 0;     ///< Responses validated and aggregated
+    std::size_t duplicates = 0;   ///< Responses for a (student, course) pair already seen
+    std::size_t not_enrolled = 0; ///< Responses from students not enrolled in the course
+    std::size_t malformed = 0;    ///< Responses with an answer outside the scale
+};
+
+/**
+ * @brief Class to ingest and aggregate course evaluations.
+ *
+ * Responses are validated against the course roster and deduplicated per
+ * (student, course). Accepted responses of each course are transposed
+ * into per-question byte columns, and each histogram bucket is counted as
+ * a compare-and-add reduction over a contiguous std::uint8_t column, a
+ * loop GCC and Clang vectorize at -O3 (a scatter increment per answer
+ * would not vectorize). Summaries can be read while ingestion is running
+ * and reflect every batch that has completed.
+ */
+class EvaluationAggregator {
+public:
+    /**
+     * @brief Construct an aggregator validating against a university's rosters.
+     * @param university The university whose rosters and course assignments are used. Must outlive the aggregator.
+     */
+    explicit EvaluationAggregator(const UniversityManager &university) : university(university) {}
+
+    /**
+     * @brief Validate, deduplicate and aggregate a batch of responses.
+     *
+     * Safe to call from several threads at once; each call publishes its
+     * partial aggregates once the whole batch has been folded in.
+     *
+     * @param batch The responses to ingest.
+     * @return Counts of accepted and rejected responses.
+     */
+    IngestResult ingest(const std::vector<EvaluationResponse> &batch) {
+        IngestResult result;
+        std::unordered_map<int, std::vector<const EvaluationResponse *>> by_course;
+        for (const EvaluationResponse &response : batch) {
+            bool in_scale = true;
+            for (std::uint8_t answer : response.answers) {
+                in_scale = in_scale && answer <= kEvaluationScale;
+            }
+            if (!in_scale) {
+                ++result.malformed;
+                continue;
+            }
+            if (!university.isEnrolled(response.student_id, response.course_id)) {
+                ++result.not_enrolled;
+                continue;
+            }
+            std::uint64_t pair = (static_cast<std::uint64_t>(static_cast<std::uint32_t>(response.student_id)) << 32) | static_cast<std::uint32_t>(response.course_id);
+            {
+                std::lock_guard<std::mutex> lock(seen_mtx);
+                if (!seen.insert(pair).second) {
+                    ++result.duplicates;
+                    continue;
+                }
+            }
+            by_course[response.course_id].push_back(&response);
+            ++result.accepted;
+        }
+
+        std::unordered_map<int, EvaluationSummary> course_partials;
+        std::unordered_map<int, EvaluationSummary> faculty_partials;
+        std::vector<std::uint8_t> column;
+        for (const auto &course : by_course) {
+            const std::vector<const EvaluationResponse *> &responses = course.second;
+            EvaluationSummary &summary = course_partials[course.first];
+            summary.responses = static_cast<std::uint32_t>(responses.size());
+            column.resize(responses.size());
+            for (std::size_t q = 0; q < kEvaluationQuestions; ++q) {
+                for (std::size_t i = 0; i < responses.size(); ++i) {
+                    column[i] = responses[i]->answers[q];
+                }
+                const std::uint8_t *answers = column.data();
+                std::size_t count = column.size();
+                for (std::size_t a = 0; a <= kEvaluationScale; ++a) {
+                    const std::uint8_t value = static_cast<std::uint8_t>(a);
+                    std::uint32_t matches = 0;
+                    for (std::size_t i = 0; i < count; ++i) {
+                        matches += answers[i] == value ? 1u : 0u;
+                    }
+                    summary.counts[q][a] = matches;
+                }
+            }
+            addSummary(faculty_partials[university.getCourseFaculty(course.first)], summary);
+        }
+
+        std::unique_lock<std::shared_mutex> lock(mtx);
+        for (const auto &partial : course_partials) {
+            addSummary(course_summaries[partial.first], partial.second);
+        }
+        for (const auto &partial : faculty_partials) {
+            addSummary(faculty_summaries[partial.first], partial.second);
+        }
+        return result;
+    }
+
+    /**
+     * @brief Get the current aggregate for a course.
+     * @param course_id The unique identifier for the course.
+     * @return The per-question distributions of responses ingested so far.
+     */
+    EvaluationSummary getCourseSummary(int course_id) const {
+        std::shared_lock<std::shared_mutex> lock(mtx);
+        auto it = course_summaries.find(course_id);
+        return it == course_summaries.end() ? EvaluationSummary() : it->second;
+    }
+
+    /**
+     * @brief Get the current aggregate over all courses a faculty member teaches.
+     * @param faculty_id The unique identifier for the faculty member.
+     * @return The per-question distributions of responses ingested so far.
+     */
+    EvaluationSummary getFacultySummary(int faculty_id) const {
+        std::shared_lock<std::shared_mutex> lock(mtx);
+        auto it = faculty_summaries.find(faculty_id);
+        return it == faculty_summaries.end() ? EvaluationSummary() : it->second;
+    }
+
+private:
+    static void addSummary(EvaluationSummary &into, const EvaluationSummary &from) {
+        into.responses += from.responses;
+        for (std::size_t q = 0; q < kEvaluationQuestions; ++q) {
+            for (std::size_t a = 0; a <= kEvaluationScale; ++a) {
+                into.counts[q][a] += from.counts[q][a];
+            }
+        }
+    }
+
+    const UniversityManager &university; ///< Source of rosters and course assignments
+    std::unordered_set<std::uint64_t> seen; ///< (student, course) pairs already accepted
+    std::mutex seen_mtx; ///< Mutex guarding seen
+    std::unordered_map<int, EvaluationSummary> course_summaries;  ///< Aggregates by course ID
+    std::unordered_map<int, EvaluationSummary> faculty_summaries; ///< Aggregates by faculty ID
+    mutable std::shared_mutex mtx; ///< Shared mutex guarding the summaries
+};
+
+#endif // EVALUATIONS_H
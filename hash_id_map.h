@@ -0,0 +1,111 @@
+/**
+ * @file hash_id_map.h
+ * @brief Header file for the default record map
+ *
+ * This file contains the std::unordered_map-based record map used as the
+ * managers' default storage backend, exposing the interface shared by all
+ * record map backends.
+ *
+ * @version 1.0
+ * @date 2026-10-18
+ */
+
+#ifndef HASH_ID_MAP_H
+#define HASH_ID_MAP_H
+
+#include <cstddef>
+#include <unordered_map>
+#include <utility>
+
+/**
+ * @brief Hash table from int IDs to values over std::unordered_map.
+ *
+ * Not thread-safe; the owning manager guards it with its shared_mutex.
+ * Shares its interface with LockFreeIdMap and IncrementalIdMap (see RecordMap).
+ *
+ * @tparam V The value type, e.g. std::shared_ptr<Student>.
+ */
+template <typename V>
+class HashIdMap {
+public:
+    /**
+     * @brief Look up a value.
+     * @param id The record ID.
+     * @return Pointer to the value, or nullptr if absent.
+     */
+    V *find(int id) {
+        auto it = map.find(id);
+        return it == map.end() ? nullptr : &it->second;
+    }
+
+    /**
+     * @brief Look up a value.
+     * @param id The record ID.
+     * @return Pointer to the value, or nullptr if absent.
+     */
+    const V *find(int id) const {
+        auto it = map.find(id);
+        return it == map.end() ? nullptr : &it->second;
+    }
+
+    /**
+     * @brief Insert a value if the ID is not present.
+     * @param id The record ID.
+     * @param value The value to store.
+     * @return Pointer to the stored value and whether it was inserted.
+     */
+    std::pair<V *, bool> emplace(int id, V value) {
+        auto result = map.emplace(id, std::move(value));
+        return {&result.first->second, result.second};
+    }
+
+    /**
+     * @brief Insert a value, replacing any value already stored for the ID.
+     * @param id The record ID.
+     * @param value The value to store.
+     */
+    void assign(int id, V value) {
+        map.insert_or_assign(id, std::move(value));
+    }
+
+    /**
+     * @brief Remove an ID.
+     * @param id The record ID.
+     * @return true if the ID was present.
+     */
+    bool erase(int id) {
+        return map.erase(id) != 0;
+    }
+
+    /**
+     * @brief Pre-size the table for an expected number of entries.
+     * @param count Expected total number of entries.
+     */
+    void reserve(std::size_t count) {
+        map.reserve(count);
+    }
+
+    /**
+     * @brief Number of entries.
+     * @return The entry count.
+     */
+    std::size_t size() const {
+        return map.size();
+    }
+
+    /**
+     * @brief Visit every entry.
+     * @param visitor Called as visitor(id, value) in unspecified order.
+     */
+    template <typename Visitor>
+    void forEach(Visitor &&visitor) const {
+        for (const auto &entry : map) {
+            visitor(entry.first, entry.second);
+        }
+    }
+
+private:
+    std::unordered_map<int, V> map; ///< Underlying hash table
+};
+
+#endif // HASH_ID_MAP_H
@@ -0,0 +1,411 @@
+/**
+ * @file incremental_map.h
+ * @brief Header file for the incrementally rehashing record map
+ *
+ * This file contains a hash table keyed by integer record IDs that grows
+ * by migrating a bounded number of buckets per mutation instead of
+ * rehashing everything at once, usable as a storage backend for the record
+ * managers.
+ *
+ * @version 1.0
+ * @date 2026-10-18
+ */
+
+#ifndef INCREMENTAL_MAP_H
+#define INCREMENTAL_MAP_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Hash table from int IDs to values with incremental growth.
+ *
+ * Like Redis's dict, the map holds two tables while growing. When the load
+ * factor reaches 1, a table of twice the size is allocated and every later
+ * insert or erase first moves up to migrate_per_op buckets from the old
+ * table to the new one by relinking nodes, with no per-node allocation. A
+ * lookup probes both tables. No single operation ever rehashes the whole
+ * map, so latency stays flat while the dataset grows. reserve() sizes the
+ * table up front so that a known bulk load does not grow at all.
+ *
+ * Bucket heads live in fixed-size chunks of kChunkBuckets, allocated
+ * zeroed by std::calloc the first time a node is linked into them, and the
+ * old table's chunks are freed as migration passes them. Starting or
+ * finishing a growth step therefore only sizes a small chunk directory,
+ * and no single operation zeroes or frees more than one chunk, whether the
+ * table has 2^10 or 2^24 buckets. A lookup costs one extra load from the
+ * directory.
+ *
+ * Lookups are const and never migrate, so they can run concurrently under
+ * a shared lock; mutations need exclusive access, as with std::unordered_map.
+ * Shares its interface with HashIdMap and LockFreeIdMap (see RecordMap).
+ *
+ * @tparam V The value type, e.g. std::shared_ptr<Student>.
+ */
+template <typename V>
+class IncrementalIdMap {
+public:
+    /**
+     * @brief Construct an empty map.
+     * @param migrate_per_op Non-empty buckets moved per insert or erase while growing.
+     */
+    explicit IncrementalIdMap(std::size_t migrate_per_op = 4)
+        : step_size(migrate_per_op == 0 ? 1 : migrate_per_op) {
+        tables[0].allocate(16);
+    }
+
+    IncrementalIdMap(const IncrementalIdMap &) = delete;
+    IncrementalIdMap &operator=(const IncrementalIdMap &) = delete;
+    IncrementalIdMap(IncrementalIdMap &&) = default;
+    IncrementalIdMap &operator=(IncrementalIdMap &&) = default;
+
+    /**
+     * @brief Look up a value.
+     * @param id The record ID.
+     * @return Pointer to the value, or nullptr if absent.
+     */
+    V *find(int id) {
+        Node *node = findNode(id);
+        return node == nullptr ? nullptr : &node->value;
+    }
+
+    /**
+     * @brief Look up a value.
+     * @param id The record ID.
+     * @return Pointer to the value, or nullptr if absent.
+     */
+    const V *find(int id) const {
+        Node *node = findNode(id);
+        return node == nullptr ? nullptr : &node->value;
+    }
+
+    /**
+     * @brief Insert a value if the ID is not present.
+     * @param id The record ID.
+     * @param value The value to store.
+     * @return Pointer to the stored value and whether it was inserted.
+     */
+    std::pair<V *, bool> emplace(int id, V value) {
+        migrate();
+        if (Node *existing = findNode(id)) {
+            return {&existing->value, false};
+        }
+        if (!rehashing() && tables[0].used >= tables[0].bucket_count) {
+            startRehash(tables[0].bucket_count * 2);
+            migrate();
+        }
+        Table &target = rehashing() ? tables[1] : tables[0];
+        Node *&head = target.slot(bucketOf(id, target));
+        head = new Node{id, std::move(value), head};
+        ++target.used;
+        return {&head->value, true};
+    }
+
+    /**
+     * @brief Insert a value, replacing any value already stored for the ID.
+     * @param id The record ID.
+     * @param value The value to store.
+     */
+    void assign(int id, V value) {
+        if (V *existing = find(id)) {
+            *existing = std::move(value);
+            return;
+        }
+        emplace(id, std::move(value));
+    }
+
+    /**
+     * @brief Remove an ID.
+     * @param id The record ID.
+     * @return true if the ID was present.
+     */
+    bool erase(int id) {
+        migrate();
+        for (Table &table : tables) {
+            if (table.bucket_count == 0) {
+                continue;
+            }
+            std::size_t bucket = bucketOf(id, table);
+            if (table.head(bucket) == nullptr) {
+                continue;
+            }
+            Node **link = &table.slot(bucket);
+            while (*link != nullptr) {
+                if ((*link)->key == id) {
+                    Node *node = *link;
+                    *link = node->next;
+                    delete node;
+                    --table.used;
+                    return true;
+                }
+                link = &(*link)->next;
+            }
+        }
+        return false;
+    }
+
+    /**
+     * @brief Pre-size the table for an expected number of entries.
+     *
+     * Finishes any growth in progress and rehashes once to fit @p count
+     * entries, so call it before a bulk load rather than during one.
+     *
+     * @param count Expected total number of entries.
+     */
+    void reserve(std::size_t count) {
+        while (rehashing()) {
+            migrate();
+        }
+        std::size_t wanted = tables[0].bucket_count;
+        while (wanted < count) {
+            wanted <<= 1;
+        }
+        if (wanted == tables[0].bucket_count) {
+            return;
+        }
+        startRehash(wanted);
+        while (rehashing()) {
+            migrate();
+        }
+    }
+
+    /**
+     * @brief Number of entries.
+     * @return The entry count.
+     */
+    std::size_t size() const {
+        return tables[0].used + tables[1].used;
+    }
+
+    /**
+     * @brief Whether a growth step is in progress.
+     * @return true while entries are split across two tables.
+     */
+    bool rehashing() const {
+        return tables[1].bucket_count != 0;
+    }
+
+    /**
+     * @brief Visit every entry.
+     * @param visitor Called as visitor(id, value) in unspecified order.
+     */
+    template <typename Visitor>
+    void forEach(Visitor &&visitor) const {
+        for (const Table &table : tables) {
+            for (std::size_t b = 0; b < table.bucket_count; ++b) {
+                for (const Node *node = table.head(b); node != nullptr; node = node->next) {
+                    visitor(node->key, node->value);
+                }
+            }
+        }
+    }
+
+private:
+    /**
+     * @brief One chained entry.
+     */
+    struct Node {
+        int key;    ///< Record ID
+        V value;    ///< Stored value
+        Node *next; ///< Next entry in the bucket, owned by this node's table
+    };
+
+    static constexpr std::size_t kChunkBuckets = std::size_t(1) << 16; ///< Bucket heads per chunk, 512 KiB on 64-bit
+
+    /**
+     * @brief Releases a chunk of bucket heads obtained from std::calloc.
+     */
+    struct FreeChunk {
+        void operator()(Node **chunk) const {
+            std::free(chunk);
+        }
+    };
+
+    using Chunk = std::unique_ptr<Node *[], FreeChunk>;
+
+    /**
+     * @brief One bucket array and the nodes chained from it.
+     */
+    struct Table {
+        std::vector<Chunk> chunks;    ///< Chunks of bucket heads, null until first linked into or once migrated
+        std::size_t bucket_count = 0; ///< Number of buckets, a power of two, 0 if unused
+        std::size_t chunk_mask = 0;   ///< Buckets per chunk minus one
+        unsigned chunk_shift = 0;     ///< log2 of buckets per chunk
+        std::size_t used = 0;         ///< Entries in this table
+
+        Table() = default;
+        Table(const Table &) = delete;
+        Table &operator=(const Table &) = delete;
+
+        Table(Table &&other) noexcept
+            : chunks(std::move(other.chunks)),
+              bucket_count(std::exchange(other.bucket_count, 0)),
+              chunk_mask(std::exchange(other.chunk_mask, 0)),
+              chunk_shift(std::exchange(other.chunk_shift, 0)),
+              used(std::exchange(other.used, 0)) {}
+
+        Table &operator=(Table &&other) noexcept {
+            if (this != &other) {
+                clear();
+                chunks = std::move(other.chunks);
+                bucket_count = std::exchange(other.bucket_count, 0);
+                chunk_mask = std::exchange(other.chunk_mask, 0);
+                chunk_shift = std::exchange(other.chunk_shift, 0);
+                used = std::exchange(other.used, 0);
+            }
+            return *this;
+        }
+
+        ~Table() {
+            clear();
+        }
+
+        /**
+         * @brief Size an unused table for @p count empty buckets without allocating them.
+         * @param count Number of buckets, a power of two.
+         */
+        void allocate(std::size_t count) {
+            std::size_t per_chunk = count < kChunkBuckets ? count : kChunkBuckets;
+            chunk_shift = 0;
+            while ((std::size_t(1) << chunk_shift) < per_chunk) {
+                ++chunk_shift;
+            }
+            chunk_mask = per_chunk - 1;
+            chunks.resize(count >> chunk_shift);
+            bucket_count = count;
+        }
+
+        /**
+         * @brief Get the head of a bucket.
+         * @param bucket The bucket index.
+         * @return The first node, or nullptr if the bucket or its chunk is empty.
+         */
+        Node *head(std::size_t bucket) const {
+            const Chunk &chunk = chunks[bucket >> chunk_shift];
+            return chunk ? chunk[bucket & chunk_mask] : nullptr;
+        }
+
+        /**
+         * @brief Get a bucket's head for relinking, allocating its chunk if needed.
+         * @param bucket The bucket index.
+         * @return Reference to the head pointer.
+         */
+        Node *&slot(std::size_t bucket) {
+            Chunk &chunk = chunks[bucket >> chunk_shift];
+            if (!chunk) {
+                Node **heads = static_cast<Node **>(std::calloc(chunk_mask + 1, sizeof(Node *)));
+                if (heads == nullptr) {
+                    throw std::bad_alloc();
+                }
+                chunk.reset(heads);
+            }
+            return chunk[bucket & chunk_mask];
+        }
+
+        /**
+         * @brief Delete every node and release every chunk.
+         */
+        void clear() {
+            for (Chunk &chunk : chunks) {
+                if (!chunk) {
+                    continue;
+                }
+                for (std::size_t b = 0; b <= chunk_mask; ++b) {
+                    Node *node = chunk[b];
+                    while (node != nullptr) {
+                        Node *next = node->next;
+                        delete node;
+                        node = next;
+                    }
+                }
+            }
+            chunks.clear();
+            bucket_count = 0;
+            used = 0;
+        }
+    };
+
+    static std::size_t bucketOf(int id, const Table &table) {
+        std::uint64_t h = static_cast<std::uint64_t>(static_cast<std::uint32_t>(id)) * 0x9E3779B97F4A7C15ULL;
+        return static_cast<std::size_t>(h >> 17) & (table.bucket_count - 1);
+    }
+
+    Node *findNode(int id) const {
+        for (const Table &table : tables) {
+            if (table.bucket_count == 0) {
+                continue;
+            }
+            for (Node *node = table.head(bucketOf(id, table)); node != nullptr; node = node->next) {
+                if (node->key == id) {
+                    return node;
+                }
+            }
+        }
+        return nullptr;
+    }
+
+    void startRehash(std::size_t bucket_count) {
+        tables[1].allocate(bucket_count);
+        rehash_index = 0;
+    }
+
+    /**
+     * @brief Move up to step_size non-empty buckets, visiting at most 10x as many empty ones.
+     */
+    void migrate() {
+        if (!rehashing()) {
+            return;
+        }
+        std::size_t moved = 0;
+        std::size_t empty_visits = step_size * 10;
+        Table &old_table = tables[0];
+        while (moved < step_size && rehash_index < old_table.bucket_count) {
+            if (old_table.head(rehash_index) == nullptr) {
+                advanceRehashIndex();
+                if (--empty_visits == 0) {
+                    break;
+                }
+                continue;
+            }
+            Node *&head = old_table.slot(rehash_index);
+            while (head != nullptr) {
+                Node *node = head;
+                head = node->next;
+                Node *&target = tables[1].slot(bucketOf(node->key, tables[1]));
+                node->next = target;
+                target = node;
+                --tables[0].used;
+                ++tables[1].used;
+            }
+            advanceRehashIndex();
+            ++moved;
+        }
+        if (rehash_index == old_table.bucket_count) {
+            tables[0] = std::move(tables[1]);
+            tables[1] = Table();
+            rehash_index = 0;
+        }
+    }
+
+    /**
+     * @brief Step past a migrated bucket, freeing its chunk once every bucket in it has moved.
+     */
+    void advanceRehashIndex() {
+        Table &old_table = tables[0];
+        ++rehash_index;
+        if ((rehash_index & old_table.chunk_mask) == 0) {
+            old_table.chunks[(rehash_index - 1) >> old_table.chunk_shift].reset();
+        }
+    }
+
+    Table tables[2];             ///< Old table [0] and, while growing, new table [1]
+    std::size_t rehash_index = 0; ///< Next bucket of tables[0] to migrate while growing
+    std::size_t step_size;       ///< Non-empty buckets moved per mutation
+};
+
+#endif // INCREMENTAL_MAP_H
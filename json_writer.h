@@ -0,0 +1,511 @@
+/**
+ * @file json_writer.h
+ * @brief Header file for streaming JSON/NDJSON serialization
+ *
+ * This file contains the serializer used to write student, faculty and
+ * course records and rosters as JSON or NDJSON directly from the managers'
+ * storage, without building an intermediate document.
+ *
+ * @version 1.0
+ * @date 2026-10-18
+ */
+
+#ifndef JSON_WRITER_H
+#define JSON_WRITER_H
+
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <unistd.h>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include "university_management.h"
+
+/**
+ * @brief Output framing for bulk dumps.
+ */
+enum class JsonFormat {
+    Array,  ///< One JSON array holding every record
+    NDJson  ///< One JSON object per line
+};
+
+/**
+ * @brief Class to stream JSON into a caller-provided buffer or file descriptor.
+ *
+ * In file-descriptor mode output is staged in a buffer of staging_size
+ * bytes and flushed when full. While a record is serialized under a
+ * manager's lock (hold_flush), the buffer grows instead of being written,
+ * so it can exceed staging_size by the largest single record or roster;
+ * it is not shrunk afterwards. Memory use therefore does not grow with
+ * the number of records dumped, but does with the size of the largest
+ * one. In buffer mode the writer stops at the end of the caller's buffer
+ * and reports overflow instead of allocating.
+ *
+ * String escaping scans 16 bytes at a time with SSE2 where the compiler
+ * targets it (a scalar loop elsewhere) for quotes, backslashes and control
+ * characters, and copies clean runs with memcpy. Integers are formatted two
+ * digits at a time from a lookup table.
+ */
+class JsonWriter {
+public:
+    /**
+     * @brief Construct a writer over a caller-provided buffer.
+     * @param buffer Destination buffer.
+     * @param capacity Size of @p buffer in bytes.
+     */
+    JsonWriter(char *buffer, std::size_t capacity) : out(buffer), capacity(capacity) {}
+
+    /**
+     * @brief Construct a writer that streams to a file descriptor.
+     * @param fd Open, writable file descriptor; not closed by the writer.
+     * @param staging_size Size of the internal staging buffer in bytes.
+     */
+    explicit JsonWriter(int fd, std::size_t staging_size = 64 * 1024)
+        : out(nullptr), capacity(staging_size == 0 ? 1 : staging_size), staging_size(capacity), fd(fd), staging(capacity) {
+        out = staging.data();
+    }
+
+    /**
+     * @brief Flush staged output to the file descriptor, if any.
+     *
+     * Never throws: a write error during the final flush is recorded and
+     * can no longer be observed, so call flush() first to see it.
+     */
+    ~JsonWriter() {
+        try {
+            flush();
+        } catch (const std::runtime_error &) {
+            // Recorded in write_error; a destructor must not throw.
+        }
+    }
+
+    JsonWriter(const JsonWriter &) = delete;
+    JsonWriter &operator=(const JsonWriter &) = delete;
+
+    /**
+     * @brief Write a student as {"student_id":..,"name":..,"courses":[..]}.
+     * @param student The student record.
+     */
+    void writeStudent(const Student &student) {
+        appendLiteral("{\"student_id\":");
+        writeInt(student.student_id);
+        appendLiteral(",\"name\":");
+        writeString(student.name);
+        appendLiteral(",\"courses\":");
+        writeIds(student.courses);
+        put('}');
+    }
+
+    /**
+     * @brief Write a faculty member as {"faculty_id":..,"name":..,"courses":[..]}.
+     * @param faculty The faculty record.
+     */
+    void writeFaculty(const Faculty &faculty) {
+        appendLiteral("{\"faculty_id\":");
+        writeInt(faculty.faculty_id);
+        appendLiteral(",\"name\":");
+        writeString(faculty.name);
+        appendLiteral(",\"courses\":");
+        writeIds(faculty.courses);
+        put('}');
+    }
+
+    /**
+     * @brief Write a course as {"course_id":..,"name":..,"faculty_id":..,"capacity":..,"students":[..]}.
+     * @param course The course record.
+     */
+    void writeCourse(const Course &course) {
+        appendLiteral("{\"course_id\":");
+        writeInt(course.course_id);
+        appendLiteral(",\"name\":");
+        writeString(course.name);
+        appendLiteral(",\"faculty_id\":");
+        writeInt(course.faculty_id);
+        appendLiteral(",\"capacity\":");
+        writeInt(course.capacity);
+        appendLiteral(",\"students\":");
+        writeIds(course.students);
+        put('}');
+    }
+
+    /**
+     * @brief Write a course roster as a JSON array of student IDs, read in place.
+     * @param university The university holding the course.
+     * @param course_id The unique identifier for the course.
+     * @return false if the course does not exist.
+     */
+    bool writeRoster(const UniversityManager &university, int course_id) {
+        hold_flush = true;
+        bool found = university.visitCourse(course_id, [this](const Course &course) { writeIds(course.roster_by_id); });
+        hold_flush = false;
+        flushIfFull();
+        return found;
+    }
+
+    /**
+     * @brief Write every student of a university.
+     *
+     * Takes the student IDs, then serializes the records one batch at a time
+     * through visitStudent(), each under a short shared lock. Output goes
+     * only into the staging buffer while a lock is held; the buffer is
+     * written to the file descriptor between batches, after the lock is
+     * released, so a slow reader of the file descriptor never stalls the
+     * manager's writers. Students added during the dump may be missed.
+     *
+     * @param university The university to dump.
+     * @param format Array or NDJSON framing.
+     * @throws std::runtime_error if writing to the file descriptor fails.
+     */
+    void writeAllStudents(const UniversityManager &university, JsonFormat format) {
+        writeAll(university.getStudentIds(), format, [this, &university](int id, const std::function<void()> &separator) {
+            return university.visitStudent(id, [this, &separator](const Student &student) {
+                separator();
+                writeStudent(student);
+            });
+        });
+    }
+
+    /**
+     * @brief Write every faculty member of a university.
+     *
+     * Staged in batches as writeAllStudents(), so no write to the file
+     * descriptor happens under a manager's lock.
+     *
+     * @param university The university to dump.
+     * @param format Array or NDJSON framing.
+     * @throws std::runtime_error if writing to the file descriptor fails.
+     */
+    void writeAllFaculty(const UniversityManager &university, JsonFormat format) {
+        std::vector<int> ids;
+        university.forEachFaculty([&ids](const Faculty &faculty) { ids.push_back(faculty.faculty_id); });
+        writeAll(ids, format, [this, &university](int id, const std::function<void()> &separator) {
+            return university.visitFaculty(id, [this, &separator](const Faculty &faculty) {
+                separator();
+                writeFaculty(faculty);
+            });
+        });
+    }
+
+    /**
+     * @brief Write every course of a university.
+     *
+     * Staged in batches as writeAllStudents(), so no write to the file
+     * descriptor happens under a manager's lock.
+     *
+     * @param university The university to dump.
+     * @param format Array or NDJSON framing.
+     * @throws std::runtime_error if writing to the file descriptor fails.
+     */
+    void writeAllCourses(const UniversityManager &university, JsonFormat format) {
+        writeAll(university.getCourseIds(), format, [this, &university](int id, const std::function<void()> &separator) {
+            return university.visitCourse(id, [this, &separator](const Course &course) {
+                separator();
+                writeCourse(course);
+            });
+        });
+    }
+
+    /**
+     * @brief Flush staged output to the file descriptor.
+     * @throws std::runtime_error if the write fails; the error is also recorded for error().
+     */
+    void flush() {
+        if (fd < 0 || used == 0) {
+            return;
+        }
+        writeFully(out, used);
+        used = 0;
+    }
+
+    /**
+     * @brief First write error seen by the writer, including one in the destructor's flush.
+     * @return The errno value of the failed write, 0 if every write succeeded.
+     */
+    int error() const {
+        return write_error;
+    }
+
+    /**
+     * @brief Number of bytes produced so far.
+     * @return Total output size, including bytes already flushed.
+     */
+    std::size_t size() const {
+        return flushed + used;
+    }
+
+    /**
+     * @brief Whether output was truncated because the caller's buffer was full.
+     * @return true if the buffer overflowed.
+     */
+    bool overflowed() const {
+        return overflow;
+    }
+
+    /**
+     * @brief Append @p text as a JSON string literal with escaping.
+     * @param text The raw string.
+     */
+    void writeString(std::string_view text) {
+        put('"');
+        const char *data = text.data();
+        std::size_t length = text.size();
+        std::size_t run = 0;
+        std::size_t i = 0;
+        while (i < length) {
+#if defined(__SSE2__) && (defined(__GNUC__) || defined(__clang__))
+            const __m128i quote = _mm_set1_epi8('"');
+            const __m128i backslash = _mm_set1_epi8('\\');
+            const __m128i control_max = _mm_set1_epi8(0x1F);
+            while (i + 16 <= length) {
+                __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + i));
+                // Unsigned byte <= 0x1F exactly when max(byte, 0x1F) == 0x1F.
+                __m128i special = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(chunk, quote), _mm_cmpeq_epi8(chunk, backslash)),
+                    _mm_cmpeq_epi8(_mm_max_epu8(chunk, control_max), control_max));
+                int mask = _mm_movemask_epi8(special);
+                if (mask != 0) {
+                    i += static_cast<std::size_t>(__builtin_ctz(static_cast<unsigned>(mask)));
+                    break;
+                }
+                i += 16;
+            }
+#endif
+            while (i < length && !needsEscape(data[i])) {
+                ++i;
+            }
+            append(data + run, i - run);
+            if (i < length) {
+                writeEscape(data[i]);
+                run = ++i;
+            }
+        }
+        put('"');
+    }
+
+    /**
+     * @brief Append an integer in decimal.
+     * @param value The integer.
+     */
+    void writeInt(std::int64_t value) {
+        static const char kDigitPairs[] =
+            "00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+            "40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+            "8081828384858687888990919293949596979899";
+        char digits[20];
+        char *end = digits + sizeof(digits);
+        char *p = end;
+        std::uint64_t magnitude = value < 0 ? 0 - static_cast<std::uint64_t>(value) : static_cast<std::uint64_t>(value);
+        while (magnitude >= 100) {
+            std::size_t pair = static_cast<std::size_t>(magnitude % 100) * 2;
+            magnitude /= 100;
+            *--p = kDigitPairs[pair + 1];
+            *--p = kDigitPairs[pair];
+        }
+        if (magnitude >= 10) {
+            std::size_t pair = static_cast<std::size_t>(magnitude) * 2;
+            *--p = kDigitPairs[pair + 1];
+            *--p = kDigitPairs[pair];
+        } else {
+            *--p = static_cast<char>('0' + magnitude);
+        }
+        if (value < 0) {
+            put('-');
+        }
+        append(p, static_cast<std::size_t>(end - p));
+    }
+
+private:
+    static bool needsEscape(char c) {
+        return c == '"' || c == '\\' || static_cast<unsigned char>(c) < 0x20;
+    }
+
+    /**
+     * @brief Append the JSON escape sequence of a quote, backslash or control character.
+     */
+    void writeEscape(char c) {
+        switch (c) {
+        case '"':
+            appendLiteral("\\\"");
+            return;
+        case '\\':
+            appendLiteral("\\\\");
+            return;
+        case '\n':
+            appendLiteral("\\n");
+            return;
+        case '\r':
+            appendLiteral("\\r");
+            return;
+        case '\t':
+            appendLiteral("\\t");
+            return;
+        case '\b':
+            appendLiteral("\\b");
+            return;
+        case '\f':
+            appendLiteral("\\f");
+            return;
+        default: {
+            static const char kHex[] = "0123456789abcdef";
+            char escape[6] = {'\\', 'u', '0', '0', kHex[(static_cast<unsigned char>(c) >> 4) & 0xF], kHex[static_cast<unsigned char>(c) & 0xF]};
+            append(escape, sizeof(escape));
+            return;
+        }
+        }
+    }
+
+    /**
+     * @brief Append a JSON array of IDs from any container of int.
+     */
+    template <typename Ids>
+    void writeIds(const Ids &ids) {
+        put('[');
+        bool first = true;
+        for (int id : ids) {
+            if (!first) {
+                put(',');
+            }
+            first = false;
+            writeInt(id);
+        }
+        put(']');
+    }
+
+    /**
+     * @brief Dump records one at a time; @p visit serializes one record under its manager's lock.
+     *
+     * @p visit calls the separator it is given just before writing, so a
+     * record removed since the IDs were taken leaves no stray comma.
+     */
+    template <typename Visit>
+    void writeAll(const std::vector<int> &ids, JsonFormat format, Visit visit) {
+        bool first = true;
+        std::function<void()> separator = [this, format, &first] {
+            if (format == JsonFormat::Array) {
+                put(first ? '[' : ',');
+            }
+            first = false;
+        };
+        for (int id : ids) {
+            hold_flush = true;
+            bool found = visit(id, separator);
+            hold_flush = false;
+            if (found && format == JsonFormat::NDJson) {
+                put('\n');
+            }
+            flushIfFull();
+        }
+        if (format == JsonFormat::Array) {
+            if (first) {
+                put('[');
+            }
+            put(']');
+        }
+        flush();
+    }
+
+    template <std::size_t N>
+    void appendLiteral(const char (&literal)[N]) {
+        append(literal, N - 1);
+    }
+
+    void put(char c) {
+        if (used < capacity) {
+            out[used++] = c;
+            return;
+        }
+        append(&c, 1);
+    }
+
+    /**
+     * @brief Flush once a held record has pushed the staging buffer to its size.
+     */
+    void flushIfFull() {
+        if (fd >= 0 && used >= staging_size) {
+            flush();
+        }
+    }
+
+    /**
+     * @brief write() all of @p length bytes, retrying on EINTR.
+     * @throws std::runtime_error on a write error, recorded for error().
+     */
+    void writeFully(const char *data, std::size_t length) {
+        while (length != 0) {
+            ssize_t written = ::write(fd, data, length);
+            if (written < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                if (write_error == 0) {
+                    write_error = errno;
+                }
+                throw std::runtime_error(std::string("JSON write failed: ") + std::strerror(errno));
+            }
+            data += written;
+            length -= static_cast<std::size_t>(written);
+            flushed += static_cast<std::size_t>(written);
+        }
+    }
+
+    /**
+     * @brief Append raw bytes, flushing or flagging overflow as needed.
+     *
+     * While hold_flush is set the staging buffer grows instead of being
+     * written, so output produced under a manager's lock never blocks on
+     * the file descriptor.
+     *
+     * @param data Bytes to append.
+     * @param length Number of bytes.
+     */
+    void append(const char *data, std::size_t length) {
+        if (used + length <= capacity) {
+            std::memcpy(out + used, data, length);
+            used += length;
+            return;
+        }
+        if (fd < 0) {
+            std::size_t fits = capacity - used;
+            std::memcpy(out + used, data, fits);
+            used = capacity;
+            overflow = true;
+            return;
+        }
+        if (hold_flush) {
+            staging.resize(std::max(staging.size() * 2, used + length));
+            out = staging.data();
+            capacity = staging.size();
+        } else {
+            flush();
+            if (length > capacity) {
+                writeFully(data, length);
+                return;
+            }
+        }
+        std::memcpy(out + used, data, length);
+        used += length;
+    }
+
+    char *out;                 ///< Start of the destination or staging buffer
+    std::size_t capacity;      ///< Size of the buffer at out
+    std::size_t staging_size = 0; ///< Requested staging size; the buffer is flushed once it holds this much
+    std::size_t used = 0;      ///< Bytes currently in the buffer
+    std::size_t flushed = 0;   ///< Bytes already written to fd
+    int fd = -1;               ///< Destination file descriptor, -1 in buffer mode
+    bool overflow = false;     ///< Set when buffer mode runs out of space
+    bool hold_flush = false;   ///< Set while serializing under a manager's lock
+    int write_error = 0;       ///< errno of the first failed write, 0 if none
+    std::vector<char> staging; ///< Owned staging buffer in file-descriptor mode
+};
+
+#endif // JSON_WRITER_H
@@ -0,0 +1,422 @@
+/**
+ * @file lockfree_map.h
+ * @brief Header file for the lock-free record map
+ *
+ * This file contains a concurrent open-addressing hash table keyed by
+ * integer record IDs, usable as an alternative storage backend for the
+ * record managers.
+ *
+ * @version 1.0
+ * @date 2026-10-18
+ */
+
+#ifndef LOCKFREE_MAP_H
+#define LOCKFREE_MAP_H
+
+#include <atomic>
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "epoch.h"
+
+/**
+ * @brief Concurrent hash table from int IDs to values.
+ *
+ * Lookups never lock or write to cache lines shared with other threads.
+ * A mutation claims the ID's slot with a compare-and-swap on the key and
+ * then publishes, replaces or clears the slot's value pointer atomically,
+ * so a lookup that races with a mutation sees either the old or the new
+ * value, never a partial one. An erased ID leaves its key behind as a
+ * tombstone until the next growth.
+ *
+ * Growth doubles the table: the resizing thread raises a flag, waits for
+ * in-flight mutations to drain, copies the live entries and swaps the
+ * table pointer, so an in-flight mutation never sees its table retired.
+ * Lookups keep going throughout, on whichever table they loaded, under an
+ * EpochDomain pin. Replaced tables, and values replaced by assign() or
+ * removed by erase(), are retired to the domain and freed once no lookup
+ * can still reach them. A pointer returned by find() therefore stays valid
+ * while the caller holds a pin() guard, or indefinitely if its entry is
+ * never replaced or erased.
+ *
+ * Growth happens only about log2(n) times, far too rarely to reach the
+ * domain's retire threshold, so grow() calls EpochDomain::reclaim() right
+ * after retiring the old table. The table is freed at once unless a lookup
+ * pinned before the swap is still running, in which case the next growth
+ * or reclaim() frees it.
+ *
+ * Shares its interface with HashIdMap and IncrementalIdMap (see RecordMap).
+ *
+ * @tparam T The value type, e.g. std::shared_ptr<Student>.
+ */
+template <typename T>
+class LockFreeIdMap {
+public:
+    /**
+     * @brief Construct an empty map.
+     * @param initial_capacity Expected number of entries.
+     */
+    explicit LockFreeIdMap(std::size_t initial_capacity = 1024) {
+        current.store(new Table(slotsFor(initial_capacity)), std::memory_order_release);
+    }
+
+    /**
+     * @brief Destroy the map and every value in it.
+     */
+    ~LockFreeIdMap() {
+        Table *table = current.load(std::memory_order_acquire);
+        for (std::size_t i = 0; i < table->capacity; ++i) {
+            delete table->slots[i].value.load(std::memory_order_relaxed);
+        }
+        delete table;
+    }
+
+    LockFreeIdMap(const LockFreeIdMap &) = delete;
+    LockFreeIdMap &operator=(const LockFreeIdMap &) = delete;
+
+    /**
+     * @brief Insert a value if the ID is not present.
+     * @param id The record ID; must not be INT_MIN.
+     * @param value The value to store.
+     * @return Pointer to the stored value and whether it was inserted.
+     * @throws std::invalid_argument if @p id is INT_MIN.
+     */
+    std::pair<T *, bool> emplace(int id, T value) {
+        checkId(id);
+        std::unique_ptr<T> boxed(new T(std::move(value)));
+        for (;;) {
+            enterWriter();
+            Table *table = current.load(std::memory_order_acquire);
+            Slot *slot = table->claim(id, needsGrowth(table));
+            if (slot == nullptr) {
+                leaveWriter();
+                grow(table);
+                continue;
+            }
+            T *expected = nullptr;
+            bool inserted = slot->value.compare_exchange_strong(expected, boxed.get(), std::memory_order_acq_rel);
+            leaveWriter();
+            if (!inserted) {
+                return {expected, false};
+            }
+            entries.fetch_add(1, std::memory_order_relaxed);
+            return {boxed.release(), true};
+        }
+    }
+
+    /**
+     * @brief Insert a value, replacing any value already stored for the ID.
+     *
+     * A replaced value is retired and freed once no pinned lookup can hold it.
+     *
+     * @param id The record ID; must not be INT_MIN.
+     * @param value The value to store.
+     * @throws std::invalid_argument if @p id is INT_MIN.
+     */
+    void assign(int id, T value) {
+        checkId(id);
+        std::unique_ptr<T> boxed(new T(std::move(value)));
+        for (;;) {
+            enterWriter();
+            Table *table = current.load(std::memory_order_acquire);
+            Slot *slot = table->claim(id, needsGrowth(table));
+            if (slot == nullptr) {
+                leaveWriter();
+                grow(table);
+                continue;
+            }
+            T *previous = slot->value.exchange(boxed.release(), std::memory_order_acq_rel);
+            leaveWriter();
+            if (previous != nullptr) {
+                reclamation.retire(previous);
+            } else {
+                entries.fetch_add(1, std::memory_order_relaxed);
+            }
+            return;
+        }
+    }
+
+    /**
+     * @brief Remove an ID.
+     *
+     * The removed value is retired and freed once no pinned lookup can hold it.
+     *
+     * @param id The record ID.
+     * @return true if the ID was present.
+     */
+    bool erase(int id) {
+        if (id == kEmpty) {
+            return false;
+        }
+        enterWriter();
+        Slot *slot = current.load(std::memory_order_acquire)->findSlot(id);
+        T *previous = slot == nullptr ? nullptr : slot->value.exchange(nullptr, std::memory_order_acq_rel);
+        leaveWriter();
+        if (previous == nullptr) {
+            return false;
+        }
+        entries.fetch_sub(1, std::memory_order_relaxed);
+        reclamation.retire(previous);
+        return true;
+    }
+
+    /**
+     * @brief Look up a value without locking.
+     * @param id The record ID.
+     * @return Pointer to the value, or nullptr if absent; see the class notes on its lifetime.
+     */
+    const T *find(int id) const {
+        EpochDomain::Guard guard = reclamation.pin();
+        const Slot *slot = current.load(std::memory_order_acquire)->findSlot(id);
+        return slot == nullptr ? nullptr : slot->value.load(std::memory_order_acquire);
+    }
+
+    /**
+     * @brief Look up a value without locking.
+     * @param id The record ID.
+     * @return Pointer to the value, or nullptr if absent; see the class notes on its lifetime.
+     */
+    T *find(int id) {
+        EpochDomain::Guard guard = reclamation.pin();
+        Slot *slot = current.load(std::memory_order_acquire)->findSlot(id);
+        return slot == nullptr ? nullptr : slot->value.load(std::memory_order_acquire);
+    }
+
+    /**
+     * @brief Pin the calling thread so that values found meanwhile stay valid.
+     * @return A guard that unpins when destroyed.
+     */
+    EpochDomain::Guard pin() const {
+        return reclamation.pin();
+    }
+
+    /**
+     * @brief Grow the table up front to hold an expected number of entries.
+     * @param count Expected total number of entries.
+     */
+    void reserve(std::size_t count) {
+        for (;;) {
+            Table *table = current.load(std::memory_order_acquire);
+            if (table->capacity >= slotsFor(count)) {
+                return;
+            }
+            grow(table);
+        }
+    }
+
+    /**
+     * @brief Number of entries.
+     * @return The entry count; approximate while mutations are in flight.
+     */
+    std::size_t size() const {
+        return entries.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Free replaced tables and values that no lookup can still hold.
+     * @return Number of objects freed.
+     */
+    std::size_t reclaim() {
+        return reclamation.reclaim();
+    }
+
+    /**
+     * @brief Get reclamation counters for replaced tables and values.
+     * @return A snapshot of the epoch domain's counters.
+     */
+    EpochStats getReclamationStats() const {
+        return reclamation.getStats();
+    }
+
+    /**
+     * @brief Visit every published entry.
+     * @param visitor Called as visitor(id, value) in unspecified order.
+     */
+    template <typename Visitor>
+    void forEach(Visitor &&visitor) const {
+        EpochDomain::Guard guard = reclamation.pin();
+        const Table *table = current.load(std::memory_order_acquire);
+        for (std::size_t i = 0; i < table->capacity; ++i) {
+            const T *value = table->slots[i].value.load(std::memory_order_acquire);
+            if (value != nullptr) {
+                visitor(table->slots[i].key.load(std::memory_order_relaxed), *value);
+            }
+        }
+    }
+
+private:
+    static constexpr int kEmpty = INT_MIN; ///< Key of an unclaimed slot
+
+    /**
+     * @brief One key/value slot.
+     */
+    struct Slot {
+        std::atomic<int> key{kEmpty};   ///< Claimed key, kEmpty if free
+        std::atomic<T *> value{nullptr}; ///< Published value, null until inserted or after erase
+    };
+
+    /**
+     * @brief One generation of the open-addressing table.
+     */
+    struct Table {
+        explicit Table(std::size_t slot_count)
+            : capacity(slot_count), mask(slot_count - 1), slots(new Slot[slot_count]) {}
+
+        static std::size_t hash(int id) {
+            return static_cast<std::size_t>((static_cast<std::uint64_t>(static_cast<std::uint32_t>(id)) * 0x9E3779B97F4A7C15ULL) >> 17);
+        }
+
+        /**
+         * @brief Find the slot holding @p id, claiming a free one if absent.
+         * @param id The record ID.
+         * @param full True if the table is too full to claim a new slot.
+         * @return The slot, or nullptr if @p id is absent and no slot may be claimed.
+         */
+        Slot *claim(int id, bool full) {
+            std::size_t start = hash(id);
+            for (std::size_t i = 0; i < capacity; ++i) {
+                Slot &slot = slots[(start + i) & mask];
+                int key = slot.key.load(std::memory_order_acquire);
+                if (key == kEmpty) {
+                    if (full) {
+                        return nullptr;
+                    }
+                    if (slot.key.compare_exchange_strong(key, id, std::memory_order_acq_rel)) {
+                        used.fetch_add(1, std::memory_order_relaxed);
+                        return &slot;
+                    }
+                }
+                if (key == id) {
+                    return &slot;
+                }
+            }
+            return nullptr;
+        }
+
+        /**
+         * @brief Find the slot holding @p id.
+         * @param id The record ID.
+         * @return The slot, or nullptr if @p id was never claimed in this table.
+         */
+        Slot *findSlot(int id) const {
+            std::size_t start = hash(id);
+            for (std::size_t i = 0; i < capacity; ++i) {
+                Slot &slot = slots[(start + i) & mask];
+                int key = slot.key.load(std::memory_order_acquire);
+                if (key == id) {
+                    return &slot;
+                }
+                if (key == kEmpty) {
+                    return nullptr;
+                }
+            }
+            return nullptr;
+        }
+
+        std::size_t capacity;          ///< Number of slots, a power of two
+        std::size_t mask;              ///< capacity - 1
+        std::unique_ptr<Slot[]> slots; ///< Slot array
+        std::atomic<std::size_t> used{0}; ///< Claimed slots, including tombstones
+    };
+
+    /**
+     * @brief Smallest slot count that holds @p count entries at a load factor of 3/4.
+     * @param count Number of entries.
+     * @return A power of two of at least 16.
+     */
+    static std::size_t slotsFor(std::size_t count) {
+        std::size_t capacity = 16;
+        while ((count + 1) * 4 > capacity * 3) {
+            capacity <<= 1;
+        }
+        return capacity;
+    }
+
+    static void checkId(int id) {
+        if (id == kEmpty) {
+            throw std::invalid_argument("LockFreeIdMap: reserved ID");
+        }
+    }
+
+    /**
+     * @brief Whether claiming one more slot would pass a load factor of 3/4.
+     * @param table The table to check.
+     * @return true if the table should grow before a new slot is claimed.
+     */
+    static bool needsGrowth(const Table *table) {
+        return (table->used.load(std::memory_order_relaxed) + 1) * 4 > table->capacity * 3;
+    }
+
+    /**
+     * @brief Register an in-flight mutation, waiting out any resize.
+     */
+    void enterWriter() {
+        for (;;) {
+            writers.fetch_add(1, std::memory_order_seq_cst);
+            if (!resizing.load(std::memory_order_seq_cst)) {
+                return;
+            }
+            writers.fetch_sub(1, std::memory_order_seq_cst);
+            while (resizing.load(std::memory_order_acquire)) {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    /**
+     * @brief Deregister an in-flight mutation.
+     */
+    void leaveWriter() {
+        writers.fetch_sub(1, std::memory_order_seq_cst);
+    }
+
+    /**
+     * @brief Replace @p seen with a table of twice the capacity, unless another thread already did.
+     *
+     * Only live entries are copied, so tombstones left by erase() are dropped.
+     *
+     * @param seen The table the caller found too full.
+     */
+    void grow(Table *seen) {
+        std::lock_guard<std::mutex> lock(resize_mtx);
+        if (current.load(std::memory_order_acquire) != seen) {
+            return;
+        }
+        resizing.store(true, std::memory_order_seq_cst);
+        while (writers.load(std::memory_order_seq_cst) != 0) {
+            std::this_thread::yield();
+        }
+        std::size_t live = entries.load(std::memory_order_relaxed);
+        std::size_t capacity = seen->capacity * 2;
+        if (capacity < slotsFor(live)) {
+            capacity = slotsFor(live);
+        }
+        auto bigger = std::make_unique<Table>(capacity);
+        for (std::size_t i = 0; i < seen->capacity; ++i) {
+            T *value = seen->slots[i].value.load(std::memory_order_relaxed);
+            if (value != nullptr) {
+                bigger->claim(seen->slots[i].key.load(std::memory_order_relaxed), false)->value.store(value, std::memory_order_relaxed);
+            }
+        }
+        current.store(bigger.release(), std::memory_order_release);
+        resizing.store(false, std::memory_order_release);
+        reclamation.retire(seen);
+        reclamation.reclaim();
+    }
+
+    std::atomic<Table *> current{nullptr};      ///< Table used by new lookups and mutations, owned by the map
+    mutable EpochDomain reclamation;            ///< Defers freeing replaced tables and values until no lookup can hold them
+    std::atomic<std::size_t> entries{0};        ///< Number of live entries
+    std::atomic<std::size_t> writers{0};        ///< Mutations currently in flight
+    std::atomic<bool> resizing{false};          ///< Set while a resize waits for or copies entries
+    std::mutex resize_mtx;                      ///< Serializes resizes
+};
+
+#endif // LOCKFREE_MAP_H
@@ -0,0 +1,163 @@
+/**
+ * @file perfect_hash.h
+ * @brief Header file for minimal perfect hashing of record IDs
+ *
+ * This file contains a BBHash-style minimal perfect hash function over a
+ * fixed set of integer IDs, used to index frozen per-term catalogs densely.
+ *
+ * @version 1.0
+ * @date 2026-10-18
+ */
+
+#ifndef PERFECT_HASH_H
+#define PERFECT_HASH_H
+
+#include <bitset>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+/**
+ * @brief Minimal perfect hash function over a fixed set of int IDs.
+ *
+ * Built as in BBHash: each level hashes the remaining IDs into a bit array
+ * of gamma * remaining bits; IDs that land alone set their bit and are
+ * placed, colliding IDs move on to the next level. An ID's index is the
+ * rank of its bit across all levels, computed from per-word popcount
+ * prefix sums, so indexes are exactly 0..size()-1. The few IDs still
+ * colliding after kMaxLevels go to a small fallback map.
+ *
+ * lookup() of an ID outside the set returns an arbitrary index; callers
+ * confirm the match against the ID stored at that index.
+ */
+class MinimalPerfectHash {
+public:
+    /**
+     * @brief Build the function over a set of distinct IDs.
+     * @param ids The IDs to index.
+     * @param gamma Bits per remaining ID at each level; larger builds faster and looks up in fewer levels but uses more memory.
+     * @throws std::invalid_argument if @p ids contains duplicates or gamma < 1.
+     */
+    explicit MinimalPerfectHash(const std::vector<int> &ids, double gamma = 2.0) : key_count(ids.size()) {
+        if (gamma < 1.0) {
+            throw std::invalid_argument("MinimalPerfectHash: gamma must be at least 1");
+        }
+        if (std::unordered_set<int>(ids.begin(), ids.end()).size() != ids.size()) {
+            throw std::invalid_argument("MinimalPerfectHash: duplicate ID");
+        }
+        std::vector<int> remaining = ids;
+        for (unsigned level = 0; level < kMaxLevels && !remaining.empty(); ++level) {
+            std::size_t level_bits = static_cast<std::size_t>(static_cast<double>(remaining.size()) * gamma) + 64;
+            level_bits = (level_bits + 63) & ~static_cast<std::size_t>(63);
+            std::vector<std::uint64_t> placed(level_bits / 64, 0);
+            std::vector<std::uint64_t> collided(level_bits / 64, 0);
+            for (int id : remaining) {
+                std::size_t pos = position(id, level, level_bits);
+                std::uint64_t mask = std::uint64_t(1) << (pos & 63);
+                if (placed[pos >> 6] & mask) {
+                    collided[pos >> 6] |= mask;
+                } else {
+                    placed[pos >> 6] |= mask;
+                }
+            }
+            for (std::size_t w = 0; w < placed.size(); ++w) {
+                placed[w] &= ~collided[w];
+            }
+            std::vector<int> next;
+            for (int id : remaining) {
+                std::size_t pos = position(id, level, level_bits);
+                if (!(placed[pos >> 6] & (std::uint64_t(1) << (pos & 63)))) {
+                    next.push_back(id);
+                }
+            }
+            levels.push_back(Level{bits.size() * 64, level_bits});
+            bits.insert(bits.end(), placed.begin(), placed.end());
+            remaining.swap(next);
+        }
+        ranks.resize(bits.size() + 1, 0);
+        for (std::size_t w = 0; w < bits.size(); ++w) {
+            ranks[w + 1] = ranks[w] + static_cast<std::uint32_t>(popcount(bits[w]));
+        }
+        std::size_t next_index = ranks.back();
+        for (int id : remaining) {
+            fallback.emplace(id, next_index++);
+        }
+    }
+
+    /**
+     * @brief Map an ID to its dense index.
+     * @param id The ID.
+     * @return An index in [0, size()); meaningful only if @p id was in the build set.
+     */
+    std::size_t lookup(int id) const {
+        for (unsigned level = 0; level < levels.size(); ++level) {
+            std::size_t pos = levels[level].offset + position(id, level, levels[level].bits);
+            std::uint64_t word = bits[pos >> 6];
+            std::uint64_t mask = std::uint64_t(1) << (pos & 63);
+            if (word & mask) {
+                return ranks[pos >> 6] + static_cast<std::size_t>(popcount(word & (mask - 1)));
+            }
+        }
+        auto it = fallback.find(id);
+        return it == fallback.end() ? 0 : it->second;
+    }
+
+    /**
+     * @brief Number of IDs in the build set.
+     * @return The size of the index range.
+     */
+    std::size_t size() const {
+        return key_count;
+    }
+
+    /**
+     * @brief Memory used by the function, excluding the fallback map.
+     * @return Bits per ID across all levels and rank tables.
+     */
+    double bitsPerKey() const {
+        return key_count == 0 ? 0.0 : static_cast<double>((bits.size() * 64) + (ranks.size() * 32)) / static_cast<double>(key_count);
+    }
+
+private:
+    static constexpr unsigned kMaxLevels = 24; ///< Levels before remaining IDs go to the fallback map
+
+    /**
+     * @brief Bit range of one level within bits.
+     */
+    struct Level {
+        std::size_t offset; ///< First bit of the level
+        std::size_t bits;   ///< Number of bits in the level
+    };
+
+    /**
+     * @brief Count set bits; a single instruction where the compiler exposes one.
+     */
+    static unsigned popcount(std::uint64_t word) {
+#if defined(__GNUC__) || defined(__clang__)
+        return static_cast<unsigned>(__builtin_popcountll(word));
+#else
+        return static_cast<unsigned>(std::bitset<64>(word).count());
+#endif
+    }
+
+    static std::size_t position(int id, unsigned level, std::size_t level_bits) {
+        std::uint64_t h = static_cast<std::uint64_t>(static_cast<std::uint32_t>(id)) + (static_cast<std::uint64_t>(level) + 1) * 0x9E3779B97F4A7C15ULL;
+        h ^= h >> 30;
+        h *= 0xBF58476D1CE4E5B9ULL;
+        h ^= h >> 27;
+        h *= 0x94D049BB133111EBULL;
+        h ^= h >> 31;
+        return static_cast<std::size_t>(h % level_bits);
+    }
+
+    std::size_t key_count;              ///< Number of IDs indexed
+    std::vector<Level> levels;          ///< Level layout within bits
+    std::vector<std::uint64_t> bits;    ///< Placement bits of all levels, concatenated
+    std::vector<std::uint32_t> ranks;   ///< ranks[w] = set bits in bits[0..w)
+    std::unordered_map<int, std::size_t> fallback; ///< Indexes of IDs not placed in any level
+};
+
+#endif // PERFECT_HASH_H
@@ -0,0 +1,423 @@
+/**
+ * @file schedule_builder.h
+ * @brief Header file for the conflict-free schedule builder
+ *
+ * This file contains the data structures used to enumerate timetable
+ * compatible section combinations for a student's wishlist and return the
+ * best-ranked schedules.
+ *
+ * @version 1.0
+ * @date 2026-10-18
+ */
+
+#ifndef SCHEDULE_BUILDER_H
+#define SCHEDULE_BUILDER_H
+
+#include <algorithm>
+#include <atomic>
+#include <bitset>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <limits>
+#include <mutex>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+#include "university_management.h"
+
+/**
+ * @brief Structure to represent a student's wishlist.
+ */
+struct Wishlist {
+    int student_id = 0;            ///< Unique identifier for the student
+    std::vector<int> family_ids;   ///< Catalog courses wanted, most wanted first
+    std::size_t min_courses = 1;   ///< Smallest acceptable number of courses in a schedule
+    MeetingMask blocked;           ///< Slots the student cannot attend, e.g. work hours
+    bool open_sections_only = true; ///< Skip sections with no open seats
+};
+
+/**
+ * @brief Structure to represent one conflict-free schedule.
+ */
+struct Schedule {
+    std::vector<int> course_ids; ///< One section per chosen family, in wishlist order
+    MeetingMask meetings;        ///< Union of the sections' meeting times
+    double score;                ///< Ranking score, higher is better
+};
+
+/**
+ * @brief Weights of the schedule ranking.
+ */
+struct ScheduleRanking {
+    double per_course = 100.0;       ///< Reward per course included
+    double wishlist_rank = 10.0;     ///< Reward for earlier wishlist entries, scaled by 1 / (position + 1)
+    double per_day = -5.0;           ///< Penalty per distinct day with classes
+    double per_gap_slot = -1.0;      ///< Penalty per empty half-hour between classes on the same day
+};
+
+/**
+ * @brief Class to enumerate conflict-free schedules for a wishlist.
+ *
+ * Families are ordered so the one with the fewest candidate sections is
+ * tried first, and each section's MeetingMask is checked against the
+ * running union with one bitset AND. A branch is pruned as soon as its
+ * score upper bound cannot beat the current k-th best schedule, or the
+ * remaining families cannot reach min_courses. The top level is split
+ * across worker threads, which share the k-th best score through an
+ * atomic to prune each other's branches.
+ *
+ * Schedules with equal scores are ordered by course_ids compared
+ * lexicographically, smallest first, in every worker's top-k heap and in
+ * the final merge. A branch is pruned only when its bound is strictly
+ * below the k-th best score, so tied schedules always reach that
+ * comparison. The result is therefore the same for any thread count and
+ * any scheduling of the workers.
+ */
+class ScheduleBuilder {
+public:
+    /**
+     * @brief Construct a builder reading sections and seats from a university.
+     * @param university The university holding the sections. Must outlive the builder.
+     */
+    explicit ScheduleBuilder(const UniversityManager &university) : university(university) {}
+
+    /**
+     * @brief Find the best conflict-free schedules for a wishlist.
+     * @param wishlist The student's wishlist.
+     * @param top_k Number of schedules to return.
+     * @param ranking Weights of the ranking score.
+     * @param threads Worker threads, 0 for std::thread::hardware_concurrency().
+     * @return Up to @p top_k schedules, best first, ties broken by ascending course_ids.
+     */
+    std::vector<Schedule> build(const Wishlist &wishlist, std::size_t top_k, const ScheduleRanking &ranking = ScheduleRanking(), unsigned threads = 0) const {
+        if (top_k == 0) {
+            return std::vector<Schedule>();
+        }
+        Search search(wishlist, top_k, ranking);
+        std::unordered_set<int> seen_families;
+        for (std::size_t position = 0; position < wishlist.family_ids.size(); ++position) {
+            if (!seen_families.insert(wishlist.family_ids[position]).second) {
+                continue;
+            }
+            Family family;
+            family.position = position;
+            family.gain = ranking.per_course + ranking.wishlist_rank / static_cast<double>(position + 1);
+            for (int course_id : university.getFamilySections(wishlist.family_ids[position])) {
+                Section section{course_id, MeetingMask(), 0};
+                bool open = false;
+                bool found = university.visitCourse(course_id, [&](const Course &course) {
+                    section.meetings = course.meetings;
+                    open = openSeatsOf(course) > 0;
+                });
+                if (!found || (section.meetings & wishlist.blocked).any() || (wishlist.open_sections_only && !open)) {
+                    continue;
+                }
+                section.days = dayMask(section.meetings);
+                family.sections.push_back(section);
+            }
+            // A family with no usable section can only be skipped, so it is left out of the search.
+            if (!family.sections.empty()) {
+                search.families.push_back(std::move(family));
+            }
+        }
+        std::stable_sort(search.families.begin(), search.families.end(), [](const Family &a, const Family &b) {
+            return a.sections.size() < b.sections.size();
+        });
+        search.optimistic.assign(search.families.size() + 1, 0.0);
+        for (std::size_t depth = search.families.size(); depth-- > 0;) {
+            search.optimistic[depth] = search.optimistic[depth + 1] + std::max(0.0, search.families[depth].gain);
+        }
+        search.by_position.assign(wishlist.family_ids.size(), -1);
+        for (std::size_t depth = 0; depth < search.families.size(); ++depth) {
+            search.by_position[search.families[depth].position] = static_cast<int>(depth);
+        }
+
+        std::vector<Worker> workers;
+        if (search.families.empty()) {
+            workers.emplace_back(search);
+            explore(workers.back(), 0);
+        } else {
+            // Top-level options: each section of the first family, then skipping it.
+            std::size_t options = search.families[0].sections.size() + 1;
+            if (threads == 0) {
+                threads = std::max(1u, std::thread::hardware_concurrency());
+            }
+            std::size_t worker_count = std::min<std::size_t>(threads, options);
+            for (std::size_t w = 0; w < worker_count; ++w) {
+                workers.emplace_back(search);
+            }
+            std::atomic<std::size_t> next_option{0};
+            std::exception_ptr error;
+            std::mutex error_mtx;
+            auto work = [&](Worker &worker) {
+                try {
+                    for (std::size_t option = next_option.fetch_add(1); option < options; option = next_option.fetch_add(1)) {
+                        branch(worker, 0, option);
+                    }
+                } catch (...) {
+                    std::lock_guard<std::mutex> lock(error_mtx);
+                    if (!error) {
+                        error = std::current_exception();
+                    }
+                }
+            };
+            std::vector<std::thread> pool;
+            for (std::size_t w = 1; w < worker_count; ++w) {
+                pool.emplace_back(work, std::ref(workers[w]));
+            }
+            work(workers[0]);
+            for (std::thread &thread : pool) {
+                thread.join();
+            }
+            if (error) {
+                std::rethrow_exception(error);
+            }
+        }
+
+        std::vector<Schedule> merged;
+        for (Worker &worker : workers) {
+            merged.insert(merged.end(), std::make_move_iterator(worker.heap.begin()), std::make_move_iterator(worker.heap.end()));
+        }
+        std::sort(merged.begin(), merged.end(), better);
+        if (merged.size() > top_k) {
+            merged.resize(top_k);
+        }
+        return merged;
+    }
+
+private:
+    /**
+     * @brief A candidate section of a wished family.
+     */
+    struct Section {
+        int course_id;        ///< Unique identifier for the section
+        MeetingMask meetings; ///< Weekly meeting times
+        std::uint8_t days;    ///< Bit d set if the section meets on day d
+    };
+
+    /**
+     * @brief A wished family and its usable sections.
+     */
+    struct Family {
+        std::size_t position = 0;      ///< Position in the wishlist
+        double gain = 0.0;             ///< Score added by including the family
+        std::vector<Section> sections; ///< Sections not blocked and, if required, open
+    };
+
+    /**
+     * @brief Inputs and pruning bound shared by every worker.
+     */
+    struct Search {
+        Search(const Wishlist &wishlist, std::size_t top_k, const ScheduleRanking &ranking)
+            : top_k(top_k), min_courses(wishlist.min_courses), ranking(ranking) {}
+
+        std::size_t top_k;               ///< Number of schedules wanted
+        std::size_t min_courses;         ///< Smallest acceptable schedule
+        ScheduleRanking ranking;         ///< Weights of the score
+        std::vector<Family> families;    ///< Families in search order, fewest sections first
+        std::vector<double> optimistic;  ///< optimistic[d]: largest score families d.. can still add
+        std::vector<int> by_position;    ///< Search depth of each wishlist position, -1 if not searched
+        std::atomic<double> threshold{-std::numeric_limits<double>::infinity()}; ///< Highest k-th best score of any worker's full heap
+    };
+
+    /**
+     * @brief One worker's branch state and top-k heap.
+     */
+    struct Worker {
+        explicit Worker(Search &search) : search(&search), chosen(search.families.size(), -1) {}
+
+        Search *search;              ///< Shared inputs
+        std::vector<int> chosen;     ///< Section index per search depth, -1 if the family is skipped
+        MeetingMask meetings;        ///< Union of the chosen sections' meetings
+        std::uint8_t days = 0;       ///< Days of the week with a chosen section
+        std::size_t count = 0;       ///< Number of chosen sections
+        double gain = 0.0;           ///< Sum of the chosen families' gains
+        std::vector<Schedule> heap;  ///< Best schedules found, worst on top
+    };
+
+    /**
+     * @brief Ranking order: higher score first, then ascending course_ids.
+     */
+    static bool better(const Schedule &a, const Schedule &b) {
+        if (a.score != b.score) {
+            return a.score > b.score;
+        }
+        return a.course_ids < b.course_ids;
+    }
+
+    /**
+     * @brief Days of the week a mask meets on.
+     * @param mask The meeting times.
+     * @return Bit d set if any slot of day d is set.
+     */
+    static std::uint8_t dayMask(const MeetingMask &mask) {
+        std::uint8_t days = 0;
+        for (std::size_t slot = 0; slot < kWeekSlots; ++slot) {
+            if (mask.test(slot)) {
+                days |= static_cast<std::uint8_t>(1u << (slot / 48));
+            }
+        }
+        return days;
+    }
+
+    /**
+     * @brief Empty half-hours between the first and last class of each day.
+     * @param mask The meeting times.
+     * @return The number of gap slots over the week.
+     */
+    static int gapSlots(const MeetingMask &mask) {
+        int gaps = 0;
+        for (std::size_t day = 0; day < 7; ++day) {
+            int first = -1;
+            int last = -1;
+            int busy = 0;
+            for (int slot = 0; slot < 48; ++slot) {
+                if (mask.test(day * 48 + static_cast<std::size_t>(slot))) {
+                    first = first < 0 ? slot : first;
+                    last = slot;
+                    ++busy;
+                }
+            }
+            if (first >= 0) {
+                gaps += last - first + 1 - busy;
+            }
+        }
+        return gaps;
+    }
+
+    /**
+     * @brief Whether a branch can neither reach min_courses nor beat the k-th best schedule.
+     * @param worker The worker's branch state.
+     * @param depth Search depth of the next family to decide.
+     * @return true if the branch can be abandoned.
+     */
+    static bool prunable(const Worker &worker, std::size_t depth) {
+        const Search &search = *worker.search;
+        if (worker.count + (search.families.size() - depth) < search.min_courses) {
+            return true;
+        }
+        double threshold = search.threshold.load(std::memory_order_relaxed);
+        if (worker.heap.size() == search.top_k) {
+            threshold = std::max(threshold, worker.heap.front().score);
+        }
+        if (threshold == -std::numeric_limits<double>::infinity()) {
+            return false;
+        }
+        const ScheduleRanking &ranking = search.ranking;
+        double bound = worker.gain + search.optimistic[depth];
+        bound += ranking.per_day <= 0.0 ? ranking.per_day * static_cast<double>(std::bitset<7>(worker.days).count()) : ranking.per_day * 7.0;
+        bound += ranking.per_gap_slot <= 0.0 ? 0.0 : ranking.per_gap_slot * static_cast<double>(kWeekSlots);
+        // Prune only on a strictly lower bound, with slack for rounding, so ties are always compared.
+        return bound < threshold - 1e-9 * (1.0 + std::abs(threshold));
+    }
+
+    /**
+     * @brief Decide the families from @p depth on, recording every complete schedule.
+     * @param worker The worker's branch state.
+     * @param depth Search depth of the next family to decide.
+     */
+    static void explore(Worker &worker, std::size_t depth) {
+        const Search &search = *worker.search;
+        if (depth == search.families.size()) {
+            if (worker.count >= search.min_courses) {
+                offer(worker);
+            }
+            return;
+        }
+        if (prunable(worker, depth)) {
+            return;
+        }
+        std::size_t options = search.families[depth].sections.size() + 1;
+        for (std::size_t option = 0; option < options; ++option) {
+            branch(worker, depth, option);
+        }
+    }
+
+    /**
+     * @brief Take one option for the family at @p depth and explore below it.
+     * @param worker The worker's branch state.
+     * @param depth Search depth of the family.
+     * @param option Index of the section to choose, or the section count to skip the family.
+     */
+    static void branch(Worker &worker, std::size_t depth, std::size_t option) {
+        const Family &family = worker.search->families[depth];
+        if (option == family.sections.size()) {
+            worker.chosen[depth] = -1;
+            explore(worker, depth + 1);
+            return;
+        }
+        const Section &section = family.sections[option];
+        if ((section.meetings & worker.meetings).any()) {
+            return;
+        }
+        MeetingMask saved_meetings = worker.meetings;
+        std::uint8_t saved_days = worker.days;
+        double saved_gain = worker.gain;
+        worker.meetings |= section.meetings;
+        worker.days |= section.days;
+        worker.gain += family.gain;
+        ++worker.count;
+        worker.chosen[depth] = static_cast<int>(option);
+        explore(worker, depth + 1);
+        worker.chosen[depth] = -1;
+        --worker.count;
+        worker.gain = saved_gain;
+        worker.days = saved_days;
+        worker.meetings = saved_meetings;
+    }
+
+    /**
+     * @brief Score the worker's complete schedule and keep it if it ranks in the top k.
+     *
+     * The score is recomputed in wishlist order, so a schedule scores the
+     * same bits whichever worker and search order found it.
+     *
+     * @param worker The worker holding a complete branch.
+     */
+    static void offer(Worker &worker) {
+        Search &search = *worker.search;
+        const ScheduleRanking &ranking = search.ranking;
+        double score = 0.0;
+        for (int depth : search.by_position) {
+            if (depth >= 0 && worker.chosen[depth] >= 0) {
+                score += search.families[depth].gain;
+            }
+        }
+        score += ranking.per_day * static_cast<double>(std::bitset<7>(worker.days).count());
+        score += ranking.per_gap_slot * static_cast<double>(gapSlots(worker.meetings));
+        bool full = worker.heap.size() == search.top_k;
+        if (full && score < worker.heap.front().score) {
+            return;
+        }
+        Schedule schedule;
+        for (int depth : search.by_position) {
+            if (depth >= 0 && worker.chosen[depth] >= 0) {
+                schedule.course_ids.push_back(search.families[depth].sections[worker.chosen[depth]].course_id);
+            }
+        }
+        schedule.meetings = worker.meetings;
+        schedule.score = score;
+        if (full) {
+            if (!better(schedule, worker.heap.front())) {
+                return;
+            }
+            std::pop_heap(worker.heap.begin(), worker.heap.end(), better);
+            worker.heap.back() = std::move(schedule);
+        } else {
+            worker.heap.push_back(std::move(schedule));
+        }
+        std::push_heap(worker.heap.begin(), worker.heap.end(), better);
+        if (worker.heap.size() == search.top_k) {
+            double kth = worker.heap.front().score;
+            double current = search.threshold.load(std::memory_order_relaxed);
+            while (kth > current && !search.threshold.compare_exchange_weak(current, kth, std::memory_order_relaxed)) {
+            }
+        }
+    }
+
+    const UniversityManager &university; ///< Source of sections, meeting times and open seats
+};
+
+#endif // SCHEDULE_BUILDER_H
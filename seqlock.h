@@ -0,0 +1,121 @@
+/**
+ * @file seqlock.h
+ * @brief Header file for sequence-lock protected values
+ *
+ * This file contains a sequence lock used to publish small, rarely changing
+ * record metadata to readers that retry optimistically instead of locking.
+ *
+ * @version 1.0
+ * @date 2026-10-18
+ */
+
+#ifndef SEQLOCK_H
+#define SEQLOCK_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+/**
+ * @brief Value protected by a sequence lock.
+ *
+ * load() reads the sequence number, copies the value and re-reads the
+ * sequence number, retrying if a write was in progress or completed in
+ * between. Readers never write shared memory, so they do not bounce cache
+ * lines between cores. The value is held in relaxed atomic words, so a read
+ * that races with a write is well defined and simply retried.
+ *
+ * store() is not safe against concurrent stores; callers serialize writers,
+ * e.g. under the owning manager's exclusive lock.
+ *
+ * @tparam T A trivially copyable value type.
+ */
+template <typename T>
+class SeqLocked {
+    static_assert(std::is_trivially_copyable<T>::value, "SeqLocked requires a trivially copyable type");
+
+public:
+    /**
+     * @brief Construct holding a value-initialized T.
+     */
+    SeqLocked() {
+        store(T{});
+    }
+
+    /**
+     * @brief Construct holding @p value.
+     * @param value The initial value.
+     */
+    explicit SeqLocked(const T &value) {
+        store(value);
+    }
+
+    /**
+     * @brief Copy the current value of another instance.
+     * @param other The instance to copy.
+     */
+    SeqLocked(const SeqLocked &other) {
+        store(other.load());
+    }
+
+    /**
+     * @brief Replace the value with the current value of another instance.
+     * @param other The instance to copy.
+     * @return This instance.
+     */
+    SeqLocked &operator=(const SeqLocked &other) {
+        if (this != &other) {
+            store(other.load());
+        }
+        return *this;
+    }
+
+    /**
+     * @brief Read a consistent copy of the value, retrying while a write is in progress.
+     * @return The value.
+     */
+    T load() const {
+        for (;;) {
+            std::uint64_t before = sequence.load(std::memory_order_acquire);
+            if (before & 1) {
+                continue;
+            }
+            std::uint64_t buffer[kWords];
+            for (std::size_t i = 0; i < kWords; ++i) {
+                buffer[i] = words[i].load(std::memory_order_relaxed);
+            }
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (sequence.load(std::memory_order_relaxed) == before) {
+                T value;
+                std::memcpy(&value, buffer, sizeof(T));
+                return value;
+            }
+        }
+    }
+
+    /**
+     * @brief Publish a new value. Writers must be serialized by the caller.
+     * @param value The new value.
+     */
+    void store(const T &value) {
+        std::uint64_t current = sequence.load(std::memory_order_relaxed);
+        sequence.store(current + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        std::uint64_t buffer[kWords] = {};
+        std::memcpy(buffer, &value, sizeof(T));
+        for (std::size_t i = 0; i < kWords; ++i) {
+            words[i].store(buffer[i], std::memory_order_relaxed);
+        }
+        sequence.store(current + 2, std::memory_order_release);
+    }
+
+private:
+    static constexpr std::size_t kWords = (sizeof(T) + sizeof(std::uint64_t) - 1) / sizeof(std::uint64_t); ///< Words needed to hold T
+
+    std::atomic<std::uint64_t> sequence{0}; ///< Odd while a write is in progress
+    std::atomic<std::uint64_t> words[kWords]; ///< Value storage
+};
+
+#endif // SEQLOCK_H
@@ -0,0 +1,603 @@
+/**
+ * @file shared_state.h
+ * @brief Header file for shared-memory publication of university state
+ *
+ * This file contains the pointer-free layout and the publisher/reader pair
+ * used to serve read-only roster and schedule queries from a POSIX
+ * shared-memory segment to other processes without IPC or copies.
+ *
+ * @version 1.0
+ * @date 2026-10-18
+ */
+
+#ifndef SHARED_STATE_H
+#define SHARED_STATE_H
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "university_management.h"
+
+constexpr std::uint64_t kSharedStateMagic = 0x4E53555354415445ULL; ///< "NSUSTATE"
+constexpr std::uint32_t kSharedStateLayoutVersion = 1;             ///< Bumped on any layout change
+
+/**
+ * @brief Location of a variable-length array inside a segment.
+ *
+ * Offsets are relative to the start of the segment, so the layout holds no
+ * pointers and is valid at any mapping address.
+ */
+struct ShmSpan {
+    std::uint64_t offset; ///< Byte offset from the segment start
+    std::uint64_t count;  ///< Number of elements
+};
+
+/**
+ * @brief One slot of an open-addressing ID index inside a segment.
+ */
+struct ShmIndexSlot {
+    std::int32_t id;      ///< Record ID, INT32_MIN for an empty slot
+    std::uint32_t record; ///< Position of the record in its record array
+};
+
+/**
+ * @brief Home slot of an ID in an index; collisions probe linearly from it.
+ * @param id The record ID.
+ * @param slot_count Number of slots in the index, a power of two.
+ * @return The slot position.
+ */
+inline std::uint64_t shmHomeSlot(std::int32_t id, std::uint64_t slot_count) {
+    std::uint64_t h = static_cast<std::uint64_t>(static_cast<std::uint32_t>(id)) * 0x9E3779B97F4A7C15ULL;
+    return (h >> 32) & (slot_count - 1);
+}
+
+/**
+ * @brief Structure to represent a student in a segment.
+ */
+struct ShmStudent {
+    std::int32_t student_id; ///< Unique identifier for the student
+    ShmSpan name;            ///< Name bytes in the string pool
+    ShmSpan courses;         ///< Course IDs in the ID pool, ascending
+};
+
+/**
+ * @brief Structure to represent a faculty member in a segment.
+ */
+struct ShmFaculty {
+    std::int32_t faculty_id; ///< Unique identifier for the faculty member
+    ShmSpan name;            ///< Name bytes in the string pool
+    ShmSpan courses;         ///< Course IDs in the ID pool, ascending
+};
+
+/**
+ * @brief Structure to represent a course in a segment.
+ */
+struct ShmCourse {
+    std::int32_t course_id;  ///< Unique identifier for the course
+    std::int32_t faculty_id; ///< Faculty member ID who teaches the course
+    std::int32_t capacity;   ///< Maximum number of enrolled students, 0 for unlimited
+    ShmSpan name;            ///< Name bytes in the string pool
+    ShmSpan students;        ///< Student IDs in the ID pool, ascending
+};
+
+/**
+ * @brief Header at offset 0 of a published segment.
+ */
+struct ShmHeader {
+    std::uint64_t magic;         ///< kSharedStateMagic
+    std::uint32_t layout_version; ///< kSharedStateLayoutVersion
+    std::uint64_t generation;    ///< Generation number of this image
+    std::uint64_t total_size;    ///< Size of the segment in bytes
+    ShmSpan students;            ///< ShmStudent array
+    ShmSpan faculty;             ///< ShmFaculty array
+    ShmSpan courses;             ///< ShmCourse array
+    ShmSpan student_index;       ///< ShmIndexSlot table over students, power-of-two size
+    ShmSpan faculty_index;       ///< ShmIndexSlot table over faculty, power-of-two size
+    ShmSpan course_index;        ///< ShmIndexSlot table over courses, power-of-two size
+    ShmSpan id_pool;             ///< std::int32_t pool referenced by course/student lists
+    ShmSpan string_pool;         ///< char pool referenced by names
+};
+
+/**
+ * @brief Control segment naming the current generation.
+ *
+ * Lives in its own small segment; generation is a lock-free atomic, so
+ * readers in other processes observe the swap without locking.
+ */
+struct ShmControl {
+    std::uint64_t magic;                   ///< kSharedStateMagic
+    std::atomic<std::uint64_t> generation; ///< Generation readers should map, 0 if none yet
+};
+
+// Another process reads generation through its own mapping, so the atomic
+// must not fall back to a process-local lock.
+static_assert(std::atomic<std::uint64_t>::is_always_lock_free, "ShmControl::generation must be lock-free to be shared across processes");
+
+/**
+ * @brief Class to publish a university's state into shared memory.
+ *
+ * Each publish() serializes the managers into a new segment named
+ * "<prefix>-<generation>", then stores the generation in the control
+ * segment "<prefix>-ctl" with release ordering. The previous segment is
+ * unlinked; readers that still map it keep a valid view until they remap,
+ * since POSIX keeps unlinked segments alive while mapped.
+ *
+ * The segment is written by a child process started with
+ * UniversityManager::forkAnalyze(), so every record array, index and
+ * roster comes from one image taken with all three managers locked, and
+ * writers only pause for the fork().
+ */
+class SharedStatePublisher {
+public:
+    /**
+     * @brief Create or open the control segment.
+     * @param prefix Segment name prefix, starting with '/'.
+     * @throws std::runtime_error if the control segment cannot be created.
+     */
+    explicit SharedStatePublisher(const std::string &prefix) : prefix(prefix) {
+        std::string name = prefix + "-ctl";
+        int fd = ::shm_open(name.c_str(), O_CREAT | O_RDWR, 0644);
+        if (fd < 0) {
+            throw std::runtime_error("Failed to open control segment " + name + ": " + std::strerror(errno));
+        }
+        struct stat info;
+        bool created = ::fstat(fd, &info) == 0 && info.st_size == 0;
+        if (created && ::ftruncate(fd, sizeof(ShmControl)) != 0) {
+            ::close(fd);
+            throw std::runtime_error("Failed to size control segment " + name);
+        }
+        void *mapped = ::mmap(nullptr, sizeof(ShmControl), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (mapped == MAP_FAILED) {
+            throw std::runtime_error("Failed to map control segment " + name);
+        }
+        if (created) {
+            control = new (mapped) ShmControl{kSharedStateMagic, {0}};
+        } else {
+            control = static_cast<ShmControl *>(mapped);
+            if (control->magic != kSharedStateMagic) {
+                ::munmap(mapped, sizeof(ShmControl));
+                throw std::runtime_error("Segment " + name + " is not a control segment");
+            }
+            // Continue after a previous publisher so readers never see a generation reused.
+            generation = control->generation.load(std::memory_order_acquire);
+        }
+    }
+
+    /**
+     * @brief Unlink the current segment and the control segment.
+     */
+    ~SharedStatePublisher() {
+        if (generation != 0) {
+            ::shm_unlink(segmentName(prefix, generation).c_str());
+        }
+        ::munmap(control, sizeof(ShmControl));
+        ::shm_unlink((prefix + "-ctl").c_str());
+    }
+
+    SharedStatePublisher(const SharedStatePublisher &) = delete;
+    SharedStatePublisher &operator=(const SharedStatePublisher &) = delete;
+
+    /**
+     * @brief Publish a consistent image of a university as a new generation.
+     * @param university The university to publish.
+     * @return The new generation number.
+     * @throws std::runtime_error if the segment cannot be created or mapped.
+     */
+    std::uint64_t publish(const UniversityManager &university) {
+        std::uint64_t next = generation + 1;
+        std::string name = segmentName(prefix, next);
+        ForkSnapshotReport report = university.forkAnalyze([&name, next](const ForkedUniversityView &view) {
+            return writeSegment(view, name, next) ? 0 : 1;
+        }).get();
+        if (report.exit_status != 0) {
+            ::shm_unlink(name.c_str());
+            throw std::runtime_error("Failed to write shared state segment " + name);
+        }
+        control->generation.store(next, std::memory_order_release);
+        if (generation != 0) {
+            ::shm_unlink(segmentName(prefix, generation).c_str());
+        }
+        generation = next;
+        return next;
+    }
+
+    /**
+     * @brief Name of the data segment of a generation.
+     * @param prefix Segment name prefix.
+     * @param generation The generation number.
+     * @return "<prefix>-<generation>".
+     */
+    static std::string segmentName(const std::string &prefix, std::uint64_t generation) {
+        return prefix + "-" + std::to_string(generation);
+    }
+
+private:
+    /**
+     * @brief Serialize an image into a new segment. Runs in the forked child.
+     * @param view The child's image of the university.
+     * @param name Name of the segment to create.
+     * @param generation Generation number stored in the header.
+     * @return true if the segment was fully written.
+     */
+    static bool writeSegment(const ForkedUniversityView &view, const std::string &name, std::uint64_t generation) {
+        // Spans are first relative to their pool, then rebased once the layout is known.
+        std::vector<ShmStudent> students;
+        std::vector<ShmFaculty> faculty;
+        std::vector<ShmCourse> courses;
+        std::vector<std::int32_t> ids;
+        std::string strings;
+        auto addName = [&strings](const std::string &value) {
+            ShmSpan span{strings.size(), value.size()};
+            strings += value;
+            return span;
+        };
+        auto addIds = [&ids](const std::unordered_set<int> &values) {
+            ShmSpan span{ids.size(), values.size()};
+            ids.insert(ids.end(), values.begin(), values.end());
+            std::sort(ids.begin() + static_cast<std::ptrdiff_t>(span.offset), ids.end());
+            return span;
+        };
+        view.forEachStudent([&](const Student &student) {
+            students.push_back(ShmStudent{student.student_id, addName(student.name), addIds(student.courses)});
+        });
+        view.forEachFaculty([&](const Faculty &member) {
+            faculty.push_back(ShmFaculty{member.faculty_id, addName(member.name), addIds(member.courses)});
+        });
+        view.forEachCourse([&](const Course &course) {
+            courses.push_back(ShmCourse{course.course_id, course.faculty_id, course.capacity, addName(course.name), addIds(course.students)});
+        });
+
+        auto slotsFor = [](std::size_t records) {
+            std::size_t slots = 2;
+            while (slots < records * 2) {
+                slots <<= 1;
+            }
+            return slots;
+        };
+        std::uint64_t size = 0;
+        auto place = [&size](std::size_t bytes) {
+            size = (size + 7) & ~std::uint64_t(7);
+            std::uint64_t offset = size;
+            size += bytes;
+            return offset;
+        };
+        ShmHeader header{};
+        header.magic = kSharedStateMagic;
+        header.layout_version = kSharedStateLayoutVersion;
+        header.generation = generation;
+        place(sizeof(ShmHeader));
+        header.students = {place(students.size() * sizeof(ShmStudent)), students.size()};
+        header.faculty = {place(faculty.size() * sizeof(ShmFaculty)), faculty.size()};
+        header.courses = {place(courses.size() * sizeof(ShmCourse)), courses.size()};
+        header.student_index.count = slotsFor(students.size());
+        header.student_index.offset = place(header.student_index.count * sizeof(ShmIndexSlot));
+        header.faculty_index.count = slotsFor(faculty.size());
+        header.faculty_index.offset = place(header.faculty_index.count * sizeof(ShmIndexSlot));
+        header.course_index.count = slotsFor(courses.size());
+        header.course_index.offset = place(header.course_index.count * sizeof(ShmIndexSlot));
+        header.id_pool = {place(ids.size() * sizeof(std::int32_t)), ids.size()};
+        header.string_pool = {place(strings.size()), strings.size()};
+        header.total_size = size;
+
+        auto rebase = [&header](ShmSpan &name_span, ShmSpan &id_span) {
+            name_span.offset += header.string_pool.offset;
+            id_span.offset = header.id_pool.offset + id_span.offset * sizeof(std::int32_t);
+        };
+        for (ShmStudent &student : students) {
+            rebase(student.name, student.courses);
+        }
+        for (ShmFaculty &member : faculty) {
+            rebase(member.name, member.courses);
+        }
+        for (ShmCourse &course : courses) {
+            rebase(course.name, course.students);
+        }
+
+        int fd = ::shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0644);
+        if (fd < 0) {
+            return false;
+        }
+        if (::ftruncate(fd, static_cast<off_t>(size)) != 0) {
+            ::close(fd);
+            return false;
+        }
+        void *mapped = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (mapped == MAP_FAILED) {
+            return false;
+        }
+        char *base = static_cast<char *>(mapped);
+        auto copy = [base](const ShmSpan &span, const void *data, std::size_t element_size) {
+            if (span.count != 0) {
+                std::memcpy(base + span.offset, data, span.count * element_size);
+            }
+        };
+        std::memcpy(base, &header, sizeof(header));
+        copy(header.students, students.data(), sizeof(ShmStudent));
+        copy(header.faculty, faculty.data(), sizeof(ShmFaculty));
+        copy(header.courses, courses.data(), sizeof(ShmCourse));
+        copy(header.id_pool, ids.data(), sizeof(std::int32_t));
+        copy(header.string_pool, strings.data(), 1);
+        auto buildIndex = [base](const ShmSpan &index, std::size_t records, auto idOf) {
+            ShmIndexSlot *slots = reinterpret_cast<ShmIndexSlot *>(base + index.offset);
+            for (std::uint64_t i = 0; i < index.count; ++i) {
+                slots[i] = ShmIndexSlot{INT32_MIN, 0};
+            }
+            for (std::size_t r = 0; r < records; ++r) {
+                std::int32_t id = idOf(r);
+                std::uint64_t slot = shmHomeSlot(id, index.count);
+                while (slots[slot].id != INT32_MIN) {
+                    slot = (slot + 1) & (index.count - 1);
+                }
+                slots[slot] = ShmIndexSlot{id, static_cast<std::uint32_t>(r)};
+            }
+        };
+        buildIndex(header.student_index, students.size(), [&](std::size_t r) { return students[r].student_id; });
+        buildIndex(header.faculty_index, faculty.size(), [&](std::size_t r) { return faculty[r].faculty_id; });
+        buildIndex(header.course_index, courses.size(), [&](std::size_t r) { return courses[r].course_id; });
+        ::munmap(mapped, size);
+        return true;
+    }
+
+    std::string prefix;           ///< Segment name prefix
+    ShmControl *control = nullptr; ///< Mapped control segment
+    std::uint64_t generation = 0; ///< Last published generation
+};
+
+/**
+ * @brief Class to query a published university state from another process.
+ *
+ * Queries read the mapped segment directly: an ID lookup is a probe of the
+ * segment's open-addressing index and results are views into its pools.
+ * refresh() remaps when the control segment names a newer generation;
+ * views returned earlier stay valid until the next refresh().
+ *
+ * The publisher unlinks a generation as soon as it publishes the next one,
+ * so the segment named by the control segment can disappear between
+ * reading the generation and opening it. When shm_open fails with ENOENT,
+ * the constructor and refresh() reread the generation and try again, up
+ * to kOpenAttempts times; each failure means a newer generation was
+ * published in between.
+ */
+class SharedStateReader {
+public:
+    /**
+     * @brief Read-only view of a list of IDs in the segment.
+     */
+    struct IdView {
+        const std::int32_t *data = nullptr; ///< First ID, ascending order
+        std::size_t size = 0;               ///< Number of IDs
+    };
+
+    static constexpr int kOpenAttempts = 16; ///< shm_open attempts before giving up on a racing publisher
+
+    /**
+     * @brief Open the control segment and map the current generation.
+     *
+     * Retries with the newest generation if the one read was unlinked
+     * before it could be opened.
+     *
+     * @param prefix Segment name prefix used by the publisher.
+     * @throws std::runtime_error if nothing has been published, the layout version differs,
+     *         or every attempt found its generation already unlinked.
+     */
+    explicit SharedStateReader(const std::string &prefix) : prefix(prefix) {
+        std::string name = prefix + "-ctl";
+        int fd = ::shm_open(name.c_str(), O_RDONLY, 0);
+        if (fd < 0) {
+            throw std::runtime_error("Failed to open control segment " + name + ": " + std::strerror(errno));
+        }
+        struct stat info;
+        if (::fstat(fd, &info) != 0 || static_cast<std::size_t>(info.st_size) < sizeof(ShmControl)) {
+            ::close(fd);
+            throw std::runtime_error("Control segment " + name + " is truncated");
+        }
+        void *mapped = ::mmap(nullptr, sizeof(ShmControl), PROT_READ, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (mapped == MAP_FAILED) {
+            throw std::runtime_error("Failed to map control segment " + name);
+        }
+        control = static_cast<const ShmControl *>(mapped);
+        if (control->magic != kSharedStateMagic) {
+            ::munmap(mapped, sizeof(ShmControl));
+            throw std::runtime_error("Segment " + name + " is not a control segment");
+        }
+        try {
+            mapNewest();
+        } catch (...) {
+            ::munmap(mapped, sizeof(ShmControl));
+            throw;
+        }
+    }
+
+    /**
+     * @brief Unmap the segments.
+     */
+    ~SharedStateReader() {
+        ::munmap(const_cast<ShmHeader *>(header), mapped_size);
+        ::munmap(const_cast<ShmControl *>(control), sizeof(ShmControl));
+    }
+
+    SharedStateReader(const SharedStateReader &) = delete;
+    SharedStateReader &operator=(const SharedStateReader &) = delete;
+
+    /**
+     * @brief Map the newest generation if it changed.
+     *
+     * Retries with the newest generation if the one read was unlinked
+     * before it could be opened. On failure the current mapping is kept.
+     *
+     * @return true if a new generation was mapped.
+     * @throws std::runtime_error if the layout version differs or every attempt found its generation already unlinked.
+     */
+    bool refresh() {
+        if (control->generation.load(std::memory_order_acquire) == header->generation) {
+            return false;
+        }
+        return mapNewest() != 0;
+    }
+
+    /**
+     * @brief Generation currently mapped.
+     * @return The generation number.
+     */
+    std::uint64_t generation() const {
+        return header->generation;
+    }
+
+    /**
+     * @brief Get the courses a student is enrolled in.
+     * @param student_id The unique identifier for the student.
+     * @return A view of course IDs, empty if the student does not exist.
+     */
+    IdView getStudentCourses(int student_id) const {
+        const ShmStudent *student = findRecord<ShmStudent>(header->students, header->student_index, student_id);
+        return student == nullptr ? IdView() : ids(student->courses);
+    }
+
+    /**
+     * @brief Get the courses a faculty member is teaching.
+     * @param faculty_id The unique identifier for the faculty member.
+     * @return A view of course IDs, empty if the faculty member does not exist.
+     */
+    IdView getFacultyCourses(int faculty_id) const {
+        const ShmFaculty *member = findRecord<ShmFaculty>(header->faculty, header->faculty_index, faculty_id);
+        return member == nullptr ? IdView() : ids(member->courses);
+    }
+
+    /**
+     * @brief Get the students enrolled in a course.
+     * @param course_id The unique identifier for the course.
+     * @return A view of student IDs, empty if the course does not exist.
+     */
+    IdView getCourseStudents(int course_id) const {
+        const ShmCourse *course = findRecord<ShmCourse>(header->courses, header->course_index, course_id);
+        return course == nullptr ? IdView() : ids(course->students);
+    }
+
+    /**
+     * @brief Get the name of a student.
+     * @param student_id The unique identifier for the student.
+     * @return A view of the name, empty if the student does not exist.
+     */
+    std::string_view getStudentName(int student_id) const {
+        const ShmStudent *student = findRecord<ShmStudent>(header->students, header->student_index, student_id);
+        if (student == nullptr) {
+            return std::string_view();
+        }
+        return std::string_view(at<char>(student->name.offset), student->name.count);
+    }
+
+private:
+    /**
+     * @brief Open and map the newest generation, retrying while it is unlinked under us.
+     * @return The mapped generation; header and mapped_size describe it.
+     * @throws std::runtime_error if no attempt succeeded.
+     */
+    std::uint64_t mapNewest() {
+        for (int attempt = 0; attempt < kOpenAttempts; ++attempt) {
+            std::uint64_t newest = control->generation.load(std::memory_order_acquire);
+            if (newest == 0) {
+                throw std::runtime_error("Nothing has been published under " + prefix);
+            }
+            std::string name = SharedStatePublisher::segmentName(prefix, newest);
+            int fd = ::shm_open(name.c_str(), O_RDONLY, 0);
+            if (fd < 0) {
+                if (errno == ENOENT) {
+                    continue;
+                }
+                throw std::runtime_error("Failed to open segment " + name + ": " + std::strerror(errno));
+            }
+            struct stat info;
+            if (::fstat(fd, &info) != 0 || static_cast<std::size_t>(info.st_size) < sizeof(ShmHeader)) {
+                ::close(fd);
+                throw std::runtime_error("Segment " + name + " is truncated");
+            }
+            std::size_t size = static_cast<std::size_t>(info.st_size);
+            void *mapped = ::mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+            ::close(fd);
+            if (mapped == MAP_FAILED) {
+                throw std::runtime_error("Failed to map segment " + name);
+            }
+            const ShmHeader *mapped_header = static_cast<const ShmHeader *>(mapped);
+            if (mapped_header->magic != kSharedStateMagic || mapped_header->layout_version != kSharedStateLayoutVersion || mapped_header->total_size > size) {
+                ::munmap(mapped, size);
+                throw std::runtime_error("Segment " + name + " has an unsupported layout");
+            }
+            if (header != nullptr) {
+                ::munmap(const_cast<ShmHeader *>(header), mapped_size);
+            }
+            header = mapped_header;
+            mapped_size = size;
+            return newest;
+        }
+        throw std::runtime_error("Every generation under " + prefix + " was unlinked before it could be opened");
+    }
+
+    /**
+     * @brief Address of an offset in the mapped segment.
+     * @tparam T The element type stored there.
+     * @param offset Byte offset from the segment start.
+     * @return The address.
+     */
+    template <typename T>
+    const T *at(std::uint64_t offset) const {
+        return reinterpret_cast<const T *>(reinterpret_cast<const char *>(header) + offset);
+    }
+
+    /**
+     * @brief View of an ID list.
+     * @param span The list's span in the ID pool.
+     * @return The view.
+     */
+    IdView ids(const ShmSpan &span) const {
+        return IdView{at<std::int32_t>(span.offset), static_cast<std::size_t>(span.count)};
+    }
+
+    /**
+     * @brief Probe an index for a record.
+     * @tparam T The record type.
+     * @param records Span of the record array.
+     * @param index Span of the index over it.
+     * @param id The record ID.
+     * @return The record, or nullptr if absent.
+     */
+    template <typename T>
+    const T *findRecord(const ShmSpan &records, const ShmSpan &index, int id) const {
+        if (id == INT32_MIN) {
+            return nullptr;
+        }
+        const ShmIndexSlot *slots = at<ShmIndexSlot>(index.offset);
+        for (std::uint64_t slot = shmHomeSlot(id, index.count);; slot = (slot + 1) & (index.count - 1)) {
+            if (slots[slot].id == id) {
+                return at<T>(records.offset) + slots[slot].record;
+            }
+            if (slots[slot].id == INT32_MIN) {
+                return nullptr;
+            }
+        }
+    }
+
+    std::string prefix;                  ///< Segment name prefix
+    const ShmControl *control = nullptr; ///< Mapped control segment
+    const ShmHeader *header = nullptr;   ///< Mapped data segment of the current generation
+    std::size_t mapped_size = 0;         ///< Size of the mapped data segment
+};
+
+#endif // SHARED_STATE_H
@@ -0,0 +1,241 @@
+/**
+ * @file simulator.h
+ * @brief Header file for the registration demand simulator
+ *
+ * This file contains the data structures used to forecast section fill
+ * rates and waitlist lengths by running randomized registration rounds
+ * against the current university state.
+ *
+ * @version 1.0
+ * @date 2026-10-18
+ */
+
+#ifndef SIMULATOR_H
+#define SIMULATOR_H
+
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <cstdint>
+#include <cstddef>
+#include <random>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "university_management.h"
+
+/**
+ * @brief Structure to represent a student's registration preferences.
+ */
+struct StudentPreference {
+    int student_id;               ///< Unique identifier for the student
+    std::vector<int> ranked_courses; ///< Course IDs in order of preference, most wanted first
+    int max_courses;              ///< Number of courses the student tries to take
+    double priority_weight;       ///< Relative chance of registering early (e.g. seniority), must be positive
+};
+
+/**
+ * @brief Parameters of a simulation run.
+ */
+struct SimulationConfig {
+    std::size_t rounds = 10000;   ///< Number of randomized registration rounds
+    unsigned threads = 0;         ///< Worker threads, 0 for std::thread::hardware_concurrency()
+    std::uint64_t seed = 1;       ///< Base seed; thread t uses an RNG seeded from (seed, t)
+};
+
+/**
+ * @brief Structure to represent the forecast for one course.
+ */
+struct CourseDemandForecast {
+    int course_id;              ///< Unique identifier for the course
+    double fill_probability;    ///< Fraction of rounds in which the course filled
+    double mean_waitlist;       ///< Mean number of students turned away per round
+    int p95_waitlist;           ///< 95th percentile of students turned away per round
+};
+
+/**
+ * @brief Class to forecast registration demand by Monte Carlo simulation.
+ *
+ * The constructor takes one snapshot of course capacities and current
+ * enrollment counts into a flat, read-only base table shared by all
+ * workers. Each worker keeps one working copy of the seat counts and, at
+ * the end of a round, restores only the courses that round touched, so
+ * rounds are independent, need no locking and cost no full-table copy. Each worker thread owns a
+ * std::mt19937_64 and a partial tally, merged once at the end, so the
+ * result for a given seed and thread count is reproducible.
+ */
+class RegistrationSimulator {
+public:
+    /**
+     * @brief Snapshot the capacities and enrollment counts of a university.
+     * @param university The university to simulate against.
+     */
+    explicit RegistrationSimulator(const UniversityManager &university) {
+        university.forEachCourse([this](const Course &course) {
+            course_index.emplace(course.course_id, course_ids.size());
+            course_ids.push_back(course.course_id);
+            open_seats.push_back(openSeatsOf(course));
+        });
+    }
+
+    /**
+     * @brief Run randomized registration rounds.
+     *
+     * In each round students register in a random order weighted by
+     * priority_weight, taking their highest-ranked courses with open seats
+     * until they reach max_courses; each full course they ask for on the
+     * way counts one student turned away.
+     *
+     * @param preferences The preference model of every participating student.
+     * @param config Number of rounds, threads and the base seed.
+     * @return One forecast per course with finite capacity.
+     */
+    std::vector<CourseDemandForecast> run(const std::vector<StudentPreference> &preferences, const SimulationConfig &config) const {
+        unsigned threads = config.threads == 0 ? std::max(1u, std::thread::hardware_concurrency()) : config.threads;
+        std::vector<std::vector<std::size_t>> ranked(preferences.size());
+        for (std::size_t p = 0; p < preferences.size(); ++p) {
+            for (int course_id : preferences[p].ranked_courses) {
+                auto it = course_index.find(course_id);
+                if (it != course_index.end()) {
+                    ranked[p].push_back(it->second);
+                }
+            }
+        }
+
+        std::vector<Tally> tallies(threads, Tally(open_seats));
+        std::vector<std::thread> workers;
+        for (unsigned t = 0; t < threads; ++t) {
+            std::size_t first = config.rounds * t / threads;
+            std::size_t last = config.rounds * (t + 1) / threads;
+            workers.emplace_back([&, t, first, last] {
+                std::seed_seq seed{static_cast<std::uint32_t>(config.seed), static_cast<std::uint32_t>(config.seed >> 32), static_cast<std::uint32_t>(t)};
+                std::mt19937_64 rng(seed);
+                for (std::size_t round = first; round < last; ++round) {
+                    runRound(preferences, ranked, rng, tallies[t]);
+                }
+            });
+        }
+        for (std::thread &worker : workers) {
+            worker.join();
+        }
+
+        std::vector<CourseDemandForecast> forecasts;
+        double rounds = static_cast<double>(std::max<std::size_t>(config.rounds, 1));
+        for (std::size_t c = 0; c < course_ids.size(); ++c) {
+            if (open_seats[c] == INT_MAX) {
+                continue;
+            }
+            std::uint64_t fills = 0;
+            std::uint64_t turned_away = 0;
+            std::vector<std::uint64_t> histogram;
+            for (const Tally &tally : tallies) {
+                fills += tally.fills[c];
+                turned_away += tally.waitlist_sum[c];
+                const std::vector<std::uint32_t> &partial = tally.waitlist_histogram[c];
+                if (histogram.size() < partial.size()) {
+                    histogram.resize(partial.size(), 0);
+                }
+                for (std::size_t w = 0; w < partial.size(); ++w) {
+                    histogram[w] += partial[w];
+                }
+            }
+            if (open_seats[c] == 0) {
+                fills = config.rounds; // full before registration opens
+            }
+            // Rounds that turned nobody away are not recorded; they make up the rest.
+            std::uint64_t recorded = 0;
+            for (std::uint64_t count : histogram) {
+                recorded += count;
+            }
+            std::uint64_t needed = static_cast<std::uint64_t>(std::ceil(0.95 * static_cast<double>(config.rounds)));
+            std::uint64_t cumulative = config.rounds - recorded;
+            int p95 = 0;
+            for (std::size_t w = 1; w < histogram.size() && cumulative < needed; ++w) {
+                cumulative += histogram[w];
+                p95 = static_cast<int>(w);
+            }
+            forecasts.push_back(CourseDemandForecast{course_ids[c], static_cast<double>(fills) / rounds, static_cast<double>(turned_away) / rounds, p95});
+        }
+        return forecasts;
+    }
+
+private:
+    /**
+     * @brief Per-thread working state and partial results.
+     */
+    struct Tally {
+        explicit Tally(const std::vector<int> &open_seats)
+            : seats(open_seats), waitlist(open_seats.size(), 0), touched_mark(open_seats.size(), 0), fills(open_seats.size(), 0), waitlist_sum(open_seats.size(), 0), waitlist_histogram(open_seats.size()) {}
+
+        std::vector<int> seats;                  ///< Working seat counts; equal to open_seats between rounds
+        std::vector<std::uint32_t> waitlist;     ///< Students turned away in the current round
+        std::vector<char> touched_mark;          ///< Whether a course was touched in the current round
+        std::vector<std::size_t> touched;        ///< Courses touched in the current round
+        std::vector<std::pair<double, std::size_t>> order; ///< Registration order keys
+        std::vector<std::uint64_t> fills;        ///< Rounds in which each course filled
+        std::vector<std::uint64_t> waitlist_sum; ///< Students turned away over all rounds
+        std::vector<std::vector<std::uint32_t>> waitlist_histogram; ///< Per course: rounds by nonzero turned-away count
+    };
+
+    /**
+     * @brief Run one registration round into @p tally.
+     */
+    void runRound(const std::vector<StudentPreference> &preferences, const std::vector<std::vector<std::size_t>> &ranked, std::mt19937_64 &rng, Tally &tally) const {
+        // Weighted random order (Efraimidis-Spirakis): sort by Exp(1) / weight.
+        std::uniform_real_distribution<double> uniform(0.0, 1.0);
+        tally.order.clear();
+        for (std::size_t p = 0; p < preferences.size(); ++p) {
+            double u = 1.0 - uniform(rng);
+            tally.order.emplace_back(-std::log(u) / preferences[p].priority_weight, p);
+        }
+        std::sort(tally.order.begin(), tally.order.end());
+
+        for (const auto &entry : tally.order) {
+            int taken = 0;
+            for (std::size_t c : ranked[entry.second]) {
+                if (taken >= preferences[entry.second].max_courses) {
+                    break;
+                }
+                if (!tally.touched_mark[c]) {
+                    tally.touched_mark[c] = 1;
+                    tally.touched.push_back(c);
+                }
+                if (tally.seats[c] > 0) {
+                    --tally.seats[c];
+                    ++taken;
+                } else {
+                    ++tally.waitlist[c];
+                }
+            }
+        }
+
+        for (std::size_t c : tally.touched) {
+            if (open_seats[c] != INT_MAX) {
+                if (open_seats[c] > 0 && tally.seats[c] == 0) {
+                    ++tally.fills[c];
+                }
+                std::uint32_t turned_away = tally.waitlist[c];
+                if (turned_away != 0) {
+                    tally.waitlist_sum[c] += turned_away;
+                    std::vector<std::uint32_t> &histogram = tally.waitlist_histogram[c];
+                    if (histogram.size() <= turned_away) {
+                        histogram.resize(turned_away + 1, 0);
+                    }
+                    ++histogram[turned_away];
+                }
+            }
+            tally.seats[c] = open_seats[c];
+            tally.waitlist[c] = 0;
+            tally.touched_mark[c] = 0;
+        }
+        tally.touched.clear();
+    }
+
+    std::vector<int> course_ids;       ///< Course IDs, indexed densely
+    std::vector<int> open_seats;       ///< Open seats per dense course index at snapshot time
+    std::unordered_map<int, std::size_t> course_index; ///< Course ID to dense index
+};
+
+#endif // SIMULATOR_H
@@ -0,0 +1,116 @@
+/**
+ * @file epoch_bench.cpp
+ * @brief Read throughput of EpochDomain against std::atomic<std::shared_ptr>
+ *
+ * Readers repeatedly load a shared configuration object while one writer
+ * replaces it at a fixed rate. The epoch variant pins, loads a raw atomic
+ * pointer and retires replaced objects; the shared_ptr variant loads and
+ * stores a std::atomic<std::shared_ptr>, whose reference count every
+ * reader writes.
+ *
+ * Usage: epoch_bench [max_threads] [loads_per_thread] [writes_per_second]
+ *
+ * @version 1.0
+ * @date 2026-10-18
+ */
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "epoch.h"
+
+namespace {
+
+/**
+ * @brief The object readers load; a few cache lines, like a record table header.
+ */
+struct Payload {
+    long values[32]; ///< Filled with one value so readers can detect a torn object
+};
+
+Payload *makePayload(long value) {
+    Payload *payload = new Payload;
+    for (long &slot : payload->values) {
+        slot = value;
+    }
+    return payload;
+}
+
+/**
+ * @brief Run @p threads readers against a writer replacing the payload.
+ * @return Million loads per second across all readers.
+ */
+template <typename Load, typename Store>
+double run(unsigned threads, long loads, int writes_per_second, Load load, Store store) {
+    std::atomic<bool> done{false};
+    std::atomic<long> torn{0};
+    std::thread writer([&] {
+        auto period = std::chrono::microseconds(1000000 / (writes_per_second > 0 ? writes_per_second : 1));
+        for (long value = 1; !done.load(std::memory_order_acquire); ++value) {
+            store(value);
+            std::this_thread::sleep_for(period);
+        }
+    });
+    std::vector<std::thread> readers;
+    auto start = std::chrono::steady_clock::now();
+    for (unsigned t = 0; t < threads; ++t) {
+        readers.emplace_back([&] {
+            long bad = 0;
+            for (long i = 0; i < loads; ++i) {
+                bad += load() ? 0 : 1;
+            }
+            torn.fetch_add(bad);
+        });
+    }
+    for (std::thread &reader : readers) {
+        reader.join();
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    done.store(true, std::memory_order_release);
+    writer.join();
+    if (torn.load() != 0) {
+        std::fprintf(stderr, "torn reads: %ld\n", torn.load());
+    }
+    return static_cast<double>(threads) * loads / elapsed.count() / 1e6;
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+    unsigned max_threads = argc > 1 ? static_cast<unsigned>(std::atoi(argv[1])) : std::thread::hardware_concurrency();
+    long loads = argc > 2 ? std::atol(argv[2]) : 5000000;
+    int writes_per_second = argc > 3 ? std::atoi(argv[3]) : 1000;
+    if (max_threads == 0) {
+        max_threads = 1;
+    }
+
+    std::printf("threads  epoch_mops  atomic_shared_ptr_mops  (%d writes/s)\n", writes_per_second);
+    for (unsigned threads = 1; threads <= max_threads; threads *= 2) {
+        EpochDomain domain;
+        std::atomic<Payload *> current{makePayload(0)};
+        double epoch_mops = run(threads, loads, writes_per_second,
+            [&] {
+                EpochDomain::Guard guard = domain.pin();
+                const Payload *payload = current.load(std::memory_order_acquire);
+                return payload->values[0] == payload->values[31];
+            },
+            [&](long value) { domain.retire(current.exchange(makePayload(value), std::memory_order_acq_rel)); });
+        domain.retire(current.load(std::memory_order_relaxed));
+        domain.reclaim();
+
+        std::atomic<std::shared_ptr<const Payload>> shared{std::shared_ptr<const Payload>(makePayload(0))};
+        double shared_mops = run(threads, loads, writes_per_second,
+            [&] {
+                std::shared_ptr<const Payload> payload = shared.load(std::memory_order_acquire);
+                return payload->values[0] == payload->values[31];
+            },
+            [&](long value) { shared.store(std::shared_ptr<const Payload>(makePayload(value)), std::memory_order_release); });
+        std::printf("%7u  %10.2f  %22.2f\n", threads, epoch_mops, shared_mops);
+    }
+    return 0;
+}
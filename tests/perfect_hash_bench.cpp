@@ -0,0 +1,93 @@
+/**
+ * @file perfect_hash_bench.cpp
+ * @brief Lookup latency of MinimalPerfectHash against std::unordered_map
+ *
+ * Builds a MinimalPerfectHash over a set of IDs with a dense array of IDs
+ * at the returned indexes, the layout FrozenCourseCatalog uses, and times
+ * hit and miss lookups against a std::unordered_map holding the same IDs,
+ * at increasing set sizes.
+ *
+ * Usage: perfect_hash_bench [max_keys] [lookups]
+ *
+ * @version 1.0
+ * @date 2026-10-18
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+#include "perfect_hash.h"
+
+namespace {
+
+/**
+ * @brief Time @p lookup over @p probes.
+ * @return Nanoseconds per lookup; @p found receives the number of hits.
+ */
+template <typename Lookup>
+double run(const std::vector<int> &probes, long &found, Lookup lookup) {
+    found = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int id : probes) {
+        found += lookup(id) ? 1 : 0;
+    }
+    std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count() / static_cast<double>(probes.size());
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+    std::size_t max_keys = argc > 1 ? static_cast<std::size_t>(std::atol(argv[1])) : 1000000;
+    std::size_t lookups = argc > 2 ? static_cast<std::size_t>(std::atol(argv[2])) : 10000000;
+    if (lookups == 0) {
+        lookups = 1;
+    }
+
+    std::printf("keys      build_ms  bits_per_key  mph_hit_ns  map_hit_ns  mph_miss_ns  map_miss_ns\n");
+    for (std::size_t keys = 1000; keys <= max_keys; keys *= 10) {
+        // Sparse IDs, as course IDs are; odd IDs are members, even IDs miss.
+        std::vector<int> ids;
+        ids.reserve(keys);
+        for (std::size_t i = 0; i < keys; ++i) {
+            ids.push_back(static_cast<int>(i * 7 + 1) * 2 + 1);
+        }
+
+        auto build_start = std::chrono::steady_clock::now();
+        MinimalPerfectHash hash(ids);
+        std::vector<int> slots(ids.size());
+        for (int id : ids) {
+            slots[hash.lookup(id)] = id;
+        }
+        std::chrono::duration<double, std::milli> build = std::chrono::steady_clock::now() - build_start;
+
+        std::unordered_map<int, int> map;
+        map.reserve(ids.size());
+        for (int id : ids) {
+            map.emplace(id, id);
+        }
+
+        std::mt19937 rng(1);
+        std::vector<int> hits(lookups);
+        std::vector<int> misses(lookups);
+        for (std::size_t i = 0; i < lookups; ++i) {
+            hits[i] = ids[rng() % ids.size()];
+            misses[i] = hits[i] + 1;
+        }
+
+        auto mph = [&](int id) { return slots[hash.lookup(id)] == id; };
+        auto unordered = [&](int id) { return map.find(id) != map.end(); };
+        long found = 0;
+        double mph_hit = run(hits, found, mph);
+        double map_hit = run(hits, found, unordered);
+        double mph_miss = run(misses, found, mph);
+        double map_miss = run(misses, found, unordered);
+        std::printf("%-8zu  %8.2f  %12.2f  %10.2f  %10.2f  %11.2f  %11.2f\n",
+            keys, build.count(), hash.bitsPerKey(), mph_hit, map_hit, mph_miss, map_miss);
+    }
+    return 0;
+}
@@ -0,0 +1,112 @@
+/**
+ * @file record_map_bench.cpp
+ * @brief Throughput comparison of LockFreeIdMap against std::unordered_map
+ *
+ * Measures mixed lookup/insert throughput of LockFreeIdMap and of a
+ * std::unordered_map guarded by std::shared_mutex, the managers' default
+ * storage, at increasing thread counts.
+ *
+ * Usage: record_map_bench [max_threads] [operations_per_thread] [lookup_percent]
+ *
+ * @version 1.0
+ * @date 2026-10-18
+ */
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <shared_mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "lockfree_map.h"
+
+namespace {
+
+constexpr int kPreloaded = 100000; ///< IDs present before the timed run
+
+/**
+ * @brief std::unordered_map behind a shared_mutex, as in the default backend.
+ */
+class LockedMap {
+public:
+    bool insert(int id, std::shared_ptr<int> value) {
+        std::unique_lock<std::shared_mutex> lock(mtx);
+        return map.emplace(id, std::move(value)).second;
+    }
+
+    bool contains(int id) const {
+        std::shared_lock<std::shared_mutex> lock(mtx);
+        return map.find(id) != map.end();
+    }
+
+private:
+    std::unordered_map<int, std::shared_ptr<int>> map;
+    mutable std::shared_mutex mtx;
+};
+
+/**
+ * @brief Run the mixed workload on @p threads threads.
+ * @return Million operations per second.
+ */
+template <typename Insert, typename Lookup>
+double run(unsigned threads, int operations, int lookup_percent, Insert insert, Lookup lookup) {
+    std::atomic<int> next_id{kPreloaded};
+    std::atomic<long> hits{0};
+    std::vector<std::thread> workers;
+    auto start = std::chrono::steady_clock::now();
+    for (unsigned t = 0; t < threads; ++t) {
+        workers.emplace_back([&, t] {
+            std::mt19937 rng(t + 1);
+            long found = 0;
+            for (int i = 0; i < operations; ++i) {
+                if (static_cast<int>(rng() % 100) < lookup_percent) {
+                    found += lookup(static_cast<int>(rng() % kPreloaded)) ? 1 : 0;
+                } else {
+                    int id = next_id.fetch_add(1, std::memory_order_relaxed);
+                    insert(id, std::make_shared<int>(id));
+                }
+            }
+            hits.fetch_add(found);
+        });
+    }
+    for (std::thread &worker : workers) {
+        worker.join();
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    return static_cast<double>(threads) * operations / elapsed.count() / 1e6;
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+    unsigned max_threads = argc > 1 ? static_cast<unsigned>(std::atoi(argv[1])) : std::thread::hardware_concurrency();
+    int operations = argc > 2 ? std::atoi(argv[2]) : 1000000;
+    int lookup_percent = argc > 3 ? std::atoi(argv[3]) : 95;
+    if (max_threads == 0) {
+        max_threads = 1;
+    }
+
+    std::printf("threads  lockfree_mops  unordered_map_shared_mutex_mops  (%d%% lookups)\n", lookup_percent);
+    for (unsigned threads = 1; threads <= max_threads; threads *= 2) {
+        LockFreeIdMap<std::shared_ptr<int>> lockfree;
+        LockedMap locked;
+        for (int id = 0; id < kPreloaded; ++id) {
+            lockfree.emplace(id, std::make_shared<int>(id));
+            locked.insert(id, std::make_shared<int>(id));
+        }
+        double lockfree_mops = run(threads, operations, lookup_percent,
+            [&](int id, std::shared_ptr<int> value) { lockfree.emplace(id, std::move(value)); },
+            [&](int id) { return lockfree.find(id) != nullptr; });
+        double locked_mops = run(threads, operations, lookup_percent,
+            [&](int id, std::shared_ptr<int> value) { locked.insert(id, std::move(value)); },
+            [&](int id) { return locked.contains(id); });
+        std::printf("%7u  %13.2f  %31.2f\n", threads, lockfree_mops, locked_mops);
+    }
+    return 0;
+}
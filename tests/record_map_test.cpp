@@ -0,0 +1,193 @@
+/**
+ * @file record_map_test.cpp
+ * @brief Interface and concurrency test for the record map backends
+ *
+ * Runs the same checks against HashIdMap, IncrementalIdMap and
+ * LockFreeIdMap, so every RecordMap backend is held to one interface,
+ * stresses LockFreeIdMap with concurrent emplace, assign, erase and find,
+ * and checks that it frees every table and value it replaces.
+ *
+ * @version 1.0
+ * @date 2026-10-18
+ */
+
+#include <atomic>
+#include <cstddef>
+#include <cstdio>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "hash_id_map.h"
+#include "incremental_map.h"
+#include "lockfree_map.h"
+
+namespace {
+
+int failures = 0; ///< Number of failed checks
+
+void check(bool condition, const char *what) {
+    if (!condition) {
+        std::fprintf(stderr, "FAILED: %s\n", what);
+        ++failures;
+    }
+}
+
+/**
+ * @brief Exercise the shared RecordMap interface on one backend.
+ * @tparam Map The backend, instantiated with std::shared_ptr<int> values.
+ */
+template <typename Map>
+void checkInterface(Map &map) {
+    constexpr int kCount = 100000;
+    map.reserve(kCount);
+    for (int id = 0; id < kCount; ++id) {
+        auto result = map.emplace(id, std::make_shared<int>(id));
+        check(result.second && **result.first == id, "emplace inserts a new ID");
+    }
+    check(map.size() == kCount, "size counts inserted IDs");
+    auto duplicate = map.emplace(7, std::make_shared<int>(-1));
+    check(!duplicate.second && **duplicate.first == 7, "emplace keeps the existing value");
+
+    map.assign(7, std::make_shared<int>(70));
+    check(map.find(7) != nullptr && **map.find(7) == 70, "assign replaces an existing value");
+    map.assign(kCount, std::make_shared<int>(kCount));
+    check(map.size() == kCount + 1, "assign inserts a missing ID");
+
+    check(map.erase(7), "erase removes a present ID");
+    check(!map.erase(7), "erase reports an absent ID");
+    check(map.find(7) == nullptr, "find misses an erased ID");
+    check(map.emplace(7, std::make_shared<int>(7)).second, "emplace reuses an erased ID");
+
+    std::size_t visited = 0;
+    long long sum = 0;
+    map.forEach([&](int id, const std::shared_ptr<int> &value) {
+        ++visited;
+        sum += *value - id;
+    });
+    check(visited == map.size() && sum == 0, "forEach visits every entry once");
+    check(map.find(-5) == nullptr, "find misses an ID never inserted");
+}
+
+/**
+ * @brief Concurrent mutations and lookups against LockFreeIdMap.
+ */
+void checkLockFreeConcurrency() {
+    constexpr int kThreads = 8;
+    constexpr int kPerThread = 50000;
+    LockFreeIdMap<std::shared_ptr<int>> map(16);
+    std::atomic<bool> done{false};
+    std::atomic<int> torn{0};
+
+    std::thread reader([&] {
+        while (!done.load(std::memory_order_acquire)) {
+            for (int id = 0; id < kThreads * kPerThread; id += 101) {
+                EpochDomain::Guard guard = map.pin();
+                const std::shared_ptr<int> *value = map.find(id);
+                if (value != nullptr && **value != id && **value != -id) {
+                    torn.fetch_add(1);
+                }
+            }
+        }
+    });
+    std::vector<std::thread> writers;
+    for (int t = 0; t < kThreads; ++t) {
+        writers.emplace_back([&map, t] {
+            for (int i = 0; i < kPerThread; ++i) {
+                int id = t * kPerThread + i;
+                map.emplace(id, std::make_shared<int>(id));
+                if (i % 3 == 0) {
+                    map.assign(id, std::make_shared<int>(-id));
+                }
+                if (i % 5 == 0) {
+                    map.erase(id);
+                }
+            }
+        });
+    }
+    for (std::thread &writer : writers) {
+        writer.join();
+    }
+    done.store(true, std::memory_order_release);
+    reader.join();
+
+    std::size_t expected = 0;
+    bool values_ok = true;
+    for (int id = 0; id < kThreads * kPerThread; ++id) {
+        const std::shared_ptr<int> *value = map.find(id);
+        bool present = (id % kPerThread) % 5 != 0;
+        expected += present ? 1 : 0;
+        if (present != (value != nullptr)) {
+            values_ok = false;
+        } else if (value != nullptr && **value != ((id % kPerThread) % 3 == 0 ? -id : id)) {
+            values_ok = false;
+        }
+    }
+    check(torn.load() == 0, "concurrent lookups never see another ID's value");
+    check(values_ok, "every concurrent mutation is reflected once all writers finish");
+    check(map.size() == expected, "size matches the live entries after concurrent mutations");
+}
+
+/**
+ * @brief Replaced tables and values are freed, not just retired.
+ */
+void checkLockFreeReclamation() {
+    constexpr int kThreads = 4;
+    constexpr int kPerThread = 20000;
+    LockFreeIdMap<std::shared_ptr<int>> map(16);
+
+    for (int id = 0; id < kPerThread; ++id) {
+        map.emplace(id, std::make_shared<int>(id));
+    }
+    EpochStats grown = map.getReclamationStats();
+    check(grown.retired > 0, "growth retires the replaced tables");
+    check(grown.freed == grown.retired, "growth frees each replaced table once no lookup is pinned");
+
+    std::atomic<bool> done{false};
+    std::thread reader([&] {
+        while (!done.load(std::memory_order_acquire)) {
+            EpochDomain::Guard guard = map.pin();
+            map.find(kPerThread / 2);
+        }
+    });
+    std::vector<std::thread> writers;
+    for (int t = 0; t < kThreads; ++t) {
+        writers.emplace_back([&map, t] {
+            for (int i = 0; i < kPerThread; ++i) {
+                int id = (t + 1) * kPerThread + i;
+                map.emplace(id, std::make_shared<int>(id));
+                map.assign(i, std::make_shared<int>(i));
+            }
+        });
+    }
+    for (std::thread &writer : writers) {
+        writer.join();
+    }
+    done.store(true, std::memory_order_release);
+    reader.join();
+
+    map.reclaim();
+    EpochStats settled = map.getReclamationStats();
+    check(settled.retired > grown.retired, "concurrent growth and assign retire tables and values");
+    check(settled.freed == settled.retired, "reclaim frees everything left behind by exited threads");
+}
+
+} // namespace
+
+int main() {
+    {
+        HashIdMap<std::shared_ptr<int>> map;
+        checkInterface(map);
+    }
+    {
+        IncrementalIdMap<std::shared_ptr<int>> map;
+        checkInterface(map);
+    }
+    {
+        LockFreeIdMap<std::shared_ptr<int>> map;
+        checkInterface(map);
+    }
+    checkLockFreeConcurrency();
+    checkLockFreeReclamation();
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,166 @@
+/**
+ * @file reserve_allocation_test.cpp
+ * @brief Allocation-budget test for UniversityManager::reserve()
+ *
+ * Replaces the global allocator with one that counts allocations made by
+ * the calling thread, then checks that after reserve() no add rehashes a
+ * record table, that enrolling and dropping allocate nothing once add/drop
+ * churn has warmed the spare node pools, and that the buffer-based getters
+ * never allocate.
+ *
+ * @version 1.0
+ * @date 2026-10-18
+ */
+
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <string>
+
+#include "university_management.h"
+
+namespace {
+
+thread_local bool counting = false;        ///< Whether this thread's allocations are counted
+thread_local std::size_t allocations = 0;  ///< Allocations counted on this thread
+thread_local std::size_t largest = 0;      ///< Largest single allocation counted on this thread
+
+/**
+ * @brief Count the allocations made on this thread while in scope.
+ */
+class AllocationCounter {
+public:
+    AllocationCounter() {
+        allocations = 0;
+        largest = 0;
+        counting = true;
+    }
+
+    ~AllocationCounter() {
+        counting = false;
+    }
+
+    std::size_t count() const {
+        return allocations;
+    }
+
+    std::size_t largestBytes() const {
+        return largest;
+    }
+};
+
+int failures = 0; ///< Number of failed checks
+
+void check(bool condition, const char *what) {
+    if (!condition) {
+        std::fprintf(stderr, "FAILED: %s\n", what);
+        ++failures;
+    }
+}
+
+} // namespace
+
+void *operator new(std::size_t size) {
+    if (counting) {
+        ++allocations;
+        if (size > largest) {
+            largest = size;
+        }
+    }
+    if (void *p = std::malloc(size == 0 ? 1 : size)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void *p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void *p, std::size_t) noexcept {
+    std::free(p);
+}
+
+int main() {
+    constexpr int kStudents = 200000;
+    constexpr int kFaculty = 2000;
+    constexpr int kCourses = 20000;
+    // Any rehash of a table sized for these counts allocates far more than this.
+    constexpr std::size_t kMaxBytesPerAdd = 1024;
+
+    UniversityManager university;
+    university.reserve(kStudents, kFaculty, kCourses);
+
+    std::size_t worst = 0;
+    for (int id = 0; id < kFaculty; ++id) {
+        AllocationCounter counter;
+        university.addFaculty(id, "F");
+        worst = counter.largestBytes() > worst ? counter.largestBytes() : worst;
+    }
+    for (int id = 0; id < kCourses; ++id) {
+        AllocationCounter counter;
+        university.addCourse(id, "C", id % kFaculty);
+        worst = counter.largestBytes() > worst ? counter.largestBytes() : worst;
+    }
+    for (int id = 0; id < kStudents; ++id) {
+        AllocationCounter counter;
+        university.addStudent(id, "S");
+        worst = counter.largestBytes() > worst ? counter.largestBytes() : worst;
+    }
+    check(worst <= kMaxBytesPerAdd, "no add after reserve() rehashes a record table");
+
+    for (int id = 0; id < kStudents; ++id) {
+        university.enrollInCourse(id, id % kCourses);
+    }
+
+    // Add/drop churn: a batch of students swaps between two courses. The
+    // first round fills the spare node pools; later rounds must reuse them.
+    // Long names do not fit the small-string buffer, so a copied name would allocate.
+    constexpr int kChurnStudents = 1000;
+    constexpr int kChurnFirstId = kStudents;
+    constexpr int kChurnCourses[2] = {kCourses - 2, kCourses - 1};
+    for (int id = kChurnFirstId; id < kChurnFirstId + kChurnStudents; ++id) {
+        university.addStudent(id, "A student name longer than the small-string buffer " + std::to_string(id));
+        university.enrollInCourse(id, kChurnCourses[0]);
+    }
+    std::size_t churn_allocations = 0;
+    for (int round = 0; round < 4; ++round) {
+        int from = kChurnCourses[round % 2];
+        int to = kChurnCourses[(round + 1) % 2];
+        AllocationCounter counter;
+        for (int id = kChurnFirstId; id < kChurnFirstId + kChurnStudents; ++id) {
+            university.dropCourse(id, from);
+            university.enrollInCourse(id, to);
+        }
+        if (round > 0) {
+            churn_allocations += counter.count();
+        }
+    }
+    check(churn_allocations == 0, "steady-state dropCourse and enrollInCourse do not allocate");
+
+    int buffer[64];
+    {
+        AllocationCounter counter;
+        for (int id = 0; id < kStudents; id += 97) {
+            university.getStudentCourses(id, buffer, 64);
+        }
+        check(counter.count() == 0, "getStudentCourses(int, int *, std::size_t) does not allocate");
+    }
+    {
+        AllocationCounter counter;
+        for (int id = 0; id < kCourses; id += 7) {
+            university.getCourseStudents(id, buffer, 64);
+        }
+        check(counter.count() == 0, "getCourseStudents(int, int *, std::size_t) does not allocate");
+    }
+    {
+        AllocationCounter counter;
+        for (int id = 0; id < kFaculty; ++id) {
+            university.getFacultyCourses(id, buffer, 64);
+        }
+        check(counter.count() == 0, "getFacultyCourses(int, int *, std::size_t) does not allocate");
+    }
+
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,127 @@
+/**
+ * @file swap_section_test.cpp
+ * @brief Seat-conservation stress test for UniversityManager::swapSection()
+ *
+ * Students enrolled across a few small sections swap between them from
+ * many threads while other threads enroll in and drop a spare section.
+ * Afterwards every student must hold exactly one section seat, no section
+ * may exceed its capacity, the student and course sides must agree, and
+ * each course's ordered rosters must list exactly its enrolled students.
+ *
+ * @version 1.0
+ * @date 2026-10-18
+ */
+
+#include <cstddef>
+#include <cstdio>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "university_management.h"
+
+namespace {
+
+int failures = 0; ///< Number of failed checks
+
+void check(bool condition, const char *what) {
+    if (!condition) {
+        std::fprintf(stderr, "FAILED: %s\n", what);
+        ++failures;
+    }
+}
+
+} // namespace
+
+int main() {
+    constexpr int kSections = 4;
+    constexpr int kCapacity = 60;
+    constexpr int kStudents = 200;  // fewer than kSections * kCapacity, so swaps can both succeed and fail
+    constexpr int kSpareCourse = kSections;
+    constexpr int kSwappers = 8;
+    constexpr int kChurners = 2;
+    constexpr int kSwapsPerThread = 20000;
+
+    UniversityManager university;
+    university.addFaculty(1, "F");
+    for (int course = 0; course <= kSpareCourse; ++course) {
+        university.addCourse(course, "Section " + std::to_string(course), 1);
+        university.setCourseCapacity(course, kCapacity);
+    }
+    for (int student = 0; student < kStudents; ++student) {
+        university.addStudent(student, "S" + std::to_string(student));
+        university.enrollInCourse(student, student % kSections);
+    }
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < kSwappers; ++t) {
+        threads.emplace_back([&university, t] {
+            std::mt19937 rng(t + 1);
+            for (int i = 0; i < kSwapsPerThread; ++i) {
+                int student = static_cast<int>(rng() % kStudents);
+                int from = static_cast<int>(rng() % kSections);
+                int to = static_cast<int>(rng() % kSections);
+                try {
+                    university.swapSection(student, from, to);
+                } catch (const std::runtime_error &) {
+                    // Not enrolled in from, already in to, or to is full: nothing changed.
+                }
+            }
+        });
+    }
+    for (int t = 0; t < kChurners; ++t) {
+        threads.emplace_back([&university, t] {
+            std::mt19937 rng(100 + t);
+            for (int i = 0; i < kSwapsPerThread; ++i) {
+                int student = static_cast<int>(rng() % kStudents);
+                try {
+                    university.enrollInCourse(student, kSpareCourse);
+                    university.dropCourse(student, kSpareCourse);
+                } catch (const std::runtime_error &) {
+                    // Spare section full or enrolled by the other churner.
+                }
+            }
+        });
+    }
+    for (std::thread &thread : threads) {
+        thread.join();
+    }
+
+    std::size_t seats = 0;
+    bool within_capacity = true;
+    bool sides_agree = true;
+    bool rosters_agree = true;
+    for (int course = 0; course <= kSpareCourse; ++course) {
+        std::unordered_set<int> roster = university.getCourseStudents(course);
+        for (RosterOrder order : {RosterOrder::ById, RosterOrder::ByName}) {
+            RosterPage page = university.getCourseRoster(course, order, RosterCursor(), kStudents);
+            std::unordered_set<int> listed(page.student_ids.begin(), page.student_ids.end());
+            rosters_agree = rosters_agree && !page.has_more && listed.size() == page.student_ids.size() && listed == roster;
+        }
+        if (course == kSpareCourse) {
+            continue;
+        }
+        seats += roster.size();
+        within_capacity = within_capacity && roster.size() <= static_cast<std::size_t>(kCapacity);
+        for (int student : roster) {
+            sides_agree = sides_agree && university.getStudentCourses(student).count(course) == 1;
+        }
+    }
+    bool one_each = true;
+    for (int student = 0; student < kStudents; ++student) {
+        std::unordered_set<int> courses = university.getStudentCourses(student);
+        courses.erase(kSpareCourse);
+        one_each = one_each && courses.size() == 1;
+        for (int course : courses) {
+            sides_agree = sides_agree && university.getCourseStudents(course).count(student) == 1;
+        }
+    }
+    check(seats == static_cast<std::size_t>(kStudents), "swaps neither lose nor duplicate section seats");
+    check(one_each, "every student holds exactly one section");
+    check(within_capacity, "no section exceeds its capacity");
+    check(sides_agree, "student and course records agree after concurrent swaps");
+    check(rosters_agree, "ById and ByName rosters list exactly the enrolled students");
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,258 @@
+/**
+ * @file timing_wheel.h
+ * @brief Header file for the hierarchical timing wheel
+ *
+ * This file contains a hashed hierarchical timing wheel used to expire
+ * large numbers of short-lived timers, such as seat holds, in O(1) per
+ * insert, cancel and expiry.
+ *
+ * @version 1.0
+ * @date 2026-10-18
+ */
+
+#ifndef TIMING_WHEEL_H
+#define TIMING_WHEEL_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Hashed hierarchical timing wheel over integer ticks.
+ *
+ * Four levels of 64 slots cover 2^24 ticks ahead; timers further out wait
+ * in an overflow list that is re-sorted each time the top level wraps.
+ * A timer goes into the lowest level whose span still contains its expiry
+ * and is moved down a level each time the level below wraps, so each timer
+ * is touched at most once per level. Timers live in a pooled array linked
+ * into their slot by index, so schedule() and cancel() are O(1) and do not
+ * allocate once the pool has grown.
+ *
+ * Not thread-safe; the owner serializes access.
+ *
+ * @tparam T The payload delivered on expiry.
+ */
+template <typename T>
+class TimingWheel {
+public:
+    using TimerId = std::uint64_t; ///< Handle of a scheduled timer; (generation << 32) | pool index
+
+    /**
+     * @brief Construct an empty wheel.
+     * @param start_tick The current tick.
+     */
+    explicit TimingWheel(std::uint64_t start_tick = 0) : now(start_tick) {
+        for (auto &level : slots) {
+            level.fill(kNone);
+        }
+    }
+
+    TimingWheel(const TimingWheel &) = delete;
+    TimingWheel &operator=(const TimingWheel &) = delete;
+
+    /**
+     * @brief Schedule a timer.
+     * @param expiry_tick Tick at which the timer fires; past ticks fire on the next advance().
+     * @param payload Value passed to the expiry callback.
+     * @return Handle for cancel().
+     */
+    TimerId schedule(std::uint64_t expiry_tick, T payload) {
+        std::uint32_t index;
+        if (free_head != kNone) {
+            index = free_head;
+            free_head = pool[index].next;
+        } else {
+            index = static_cast<std::uint32_t>(pool.size());
+            pool.emplace_back();
+        }
+        Timer &timer = pool[index];
+        timer.expiry = expiry_tick < now + 1 ? now + 1 : expiry_tick;
+        timer.payload = std::move(payload);
+        timer.active = true;
+        place(index);
+        ++active_count;
+        return (static_cast<TimerId>(timer.generation) << 32) | index;
+    }
+
+    /**
+     * @brief Cancel a pending timer.
+     * @param id Handle returned by schedule().
+     * @return true if the timer was pending and is now cancelled.
+     */
+    bool cancel(TimerId id) {
+        std::uint32_t index = static_cast<std::uint32_t>(id & 0xFFFFFFFFu);
+        if (index >= pool.size() || pool[index].generation != static_cast<std::uint32_t>(id >> 32) || !pool[index].active) {
+            return false;
+        }
+        unlink(index);
+        release(index);
+        --active_count;
+        return true;
+    }
+
+    /**
+     * @brief Look up the payload of a pending timer.
+     * @param id Handle returned by schedule().
+     * @return The payload, or nullptr if the timer has fired or was cancelled.
+     */
+    const T *find(TimerId id) const {
+        std::uint32_t index = static_cast<std::uint32_t>(id & 0xFFFFFFFFu);
+        if (index >= pool.size() || pool[index].generation != static_cast<std::uint32_t>(id >> 32) || !pool[index].active) {
+            return nullptr;
+        }
+        return &pool[index].payload;
+    }
+
+    /**
+     * @brief Advance to @p tick, firing every timer that expires on the way.
+     * @param tick The new current tick; earlier ticks are ignored.
+     * @param on_expire Called as on_expire(T &&payload) for each expired timer.
+     * @return Number of timers fired.
+     */
+    template <typename Callback>
+    std::size_t advance(std::uint64_t tick, Callback &&on_expire) {
+        std::size_t fired = 0;
+        while (now < tick) {
+            ++now;
+            cascade();
+            std::uint32_t &head = slots[0][now & kSlotMask];
+            while (head != kNone) {
+                std::uint32_t index = head;
+                unlink(index);
+                --active_count;
+                T payload = std::move(pool[index].payload);
+                release(index);
+                on_expire(std::move(payload));
+                ++fired;
+            }
+        }
+        return fired;
+    }
+
+    /**
+     * @brief Current tick.
+     * @return The tick of the last advance().
+     */
+    std::uint64_t currentTick() const {
+        return now;
+    }
+
+    /**
+     * @brief Number of pending timers.
+     * @return The pending timer count.
+     */
+    std::size_t size() const {
+        return active_count;
+    }
+
+private:
+    static constexpr unsigned kLevels = 4;                 ///< Number of wheel levels
+    static constexpr unsigned kSlotBits = 6;               ///< log2 of slots per level
+    static constexpr std::uint64_t kSlotMask = (1u << kSlotBits) - 1; ///< Slot index mask
+    static constexpr std::uint32_t kNone = 0xFFFFFFFFu;    ///< Null pool index
+
+    /**
+     * @brief One pooled timer.
+     */
+    struct Timer {
+        std::uint64_t expiry = 0;     ///< Tick at which the timer fires
+        T payload{};                  ///< Delivered on expiry
+        std::uint32_t prev = kNone;   ///< Previous timer in the slot list
+        std::uint32_t next = kNone;   ///< Next timer in the slot list, or next free entry
+        std::uint32_t generation = 0; ///< Bumped on release so stale handles are rejected
+        std::uint32_t *owner = nullptr; ///< Head of the list holding the timer
+        bool active = false;          ///< True while scheduled
+    };
+
+    /**
+     * @brief Link a timer into the slot matching its expiry.
+     * @param index Pool index of the timer.
+     */
+    void place(std::uint32_t index) {
+        std::uint64_t expiry = pool[index].expiry;
+        std::uint32_t *head = &overflow_head;
+        for (unsigned level = 0; level < kLevels; ++level) {
+            unsigned shift = kSlotBits * (level + 1);
+            if ((expiry >> shift) == (now >> shift)) {
+                head = &slots[level][(expiry >> (kSlotBits * level)) & kSlotMask];
+                break;
+            }
+        }
+        Timer &timer = pool[index];
+        timer.owner = head;
+        timer.prev = kNone;
+        timer.next = *head;
+        if (*head != kNone) {
+            pool[*head].prev = index;
+        }
+        *head = index;
+    }
+
+    /**
+     * @brief Remove a timer from its slot list.
+     * @param index Pool index of the timer.
+     */
+    void unlink(std::uint32_t index) {
+        Timer &timer = pool[index];
+        if (timer.prev != kNone) {
+            pool[timer.prev].next = timer.next;
+        } else {
+            *timer.owner = timer.next;
+        }
+        if (timer.next != kNone) {
+            pool[timer.next].prev = timer.prev;
+        }
+    }
+
+    /**
+     * @brief Return a timer to the free list.
+     * @param index Pool index of the timer.
+     */
+    void release(std::uint32_t index) {
+        Timer &timer = pool[index];
+        timer.active = false;
+        timer.payload = T{};
+        ++timer.generation;
+        timer.next = free_head;
+        free_head = index;
+    }
+
+    /**
+     * @brief Re-place every timer in a list after the tick crossed its span.
+     * @param head Head of the list.
+     */
+    void redistribute(std::uint32_t &head) {
+        std::uint32_t index = head;
+        head = kNone;
+        while (index != kNone) {
+            std::uint32_t next = pool[index].next;
+            place(index);
+            index = next;
+        }
+    }
+
+    /**
+     * @brief Move timers down from every level whose lower neighbour just wrapped.
+     */
+    void cascade() {
+        if ((now & ((std::uint64_t(1) << (kSlotBits * kLevels)) - 1)) == 0) {
+            redistribute(overflow_head);
+        }
+        for (unsigned level = kLevels - 1; level > 0; --level) {
+            if ((now & ((std::uint64_t(1) << (kSlotBits * level)) - 1)) == 0) {
+                redistribute(slots[level][(now >> (kSlotBits * level)) & kSlotMask]);
+            }
+        }
+    }
+
+    std::uint64_t now;                                       ///< Current tick
+    std::array<std::array<std::uint32_t, 1u << kSlotBits>, kLevels> slots; ///< Slot list heads per level
+    std::uint32_t overflow_head = kNone;                     ///< Timers beyond the top level's span
+    std::vector<Timer> pool;                                 ///< Timer storage
+    std::uint32_t free_head = kNone;                         ///< Free list through Timer::next
+    std::size_t active_count = 0;                            ///< Pending timers
+};
+
+#endif // TIMING_WHEEL_H
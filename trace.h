@@ -0,0 +1,618 @@
+/**
+ * @file trace.h
+ * @brief Header file for operation trace recording and replay
+ *
+ * This file contains the data structures used to record every public
+ * UniversityManager call into a compact binary trace and to replay a trace
+ * against any build, comparing per-operation latencies between builds.
+ *
+ * @version 1.0
+ * @date 2026-10-18
+ */
+
+// Included first so that university_management.h, which includes this
+// header after its own classes, is complete before the guard is set.
+#include "university_management.h"
+
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <istream>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @brief Public UniversityManager calls that can appear in a trace.
+ */
+using TraceOp = OperationKind;
+
+constexpr std::uint32_t kTraceMagic = 0x52544D55; ///< "UMTR": first four bytes of a trace file
+constexpr std::size_t kTraceRecordBytes = 29;     ///< Packed size of a record's fixed fields
+
+/**
+ * @brief Stable name of an operation, used in replay reports.
+ * @param op The operation.
+ * @return The name, e.g. "EnrollInCourse".
+ */
+inline const char *traceOpName(TraceOp op) {
+    static const char *const kNames[] = {
+        "AddStudent", "EnrollInCourse", "DropCourse", "GetStudentCourses", "AddFaculty",
+        "AssignCourse", "GetFacultyCourses", "AddCourse", "GetCourseStudents", "GetCourseRoster",
+        "SetCourseCapacity", "SetCourseName", "SetCourseFaculty", "SetFacultyName", "HoldSeat",
+        "ReleaseHold", "ConfirmHold", "ExpireHolds", "SwapSection", "SetCourseSchedule",
+        "GetStudentIds", "ForEachStudent", "VisitStudent", "ForEachFaculty", "VisitFaculty",
+        "ForEachCourse", "VisitCourse", "IsEnrolled", "GetCourseFaculty", "GetCourseMetadata",
+        "GetFacultyMetadata", "GetCourseCapacity", "GetOpenSeats", "GetFamilySections", "FindOpenSections",
+        "GetCourseIds", "GetCachedResult", "IsAuthorized", "GetCourseStudentsAs", "GetFacultyCoursesAs"};
+    static_assert(sizeof(kNames) / sizeof(kNames[0]) == static_cast<std::size_t>(TraceOp::Count), "traceOpName() must name every TraceOp");
+    std::size_t index = static_cast<std::size_t>(op);
+    return index < static_cast<std::size_t>(TraceOp::Count) ? kNames[index] : "Unknown";
+}
+
+/**
+ * @brief Structure to represent one recorded call.
+ *
+ * On disk the file starts with kTraceMagic, and each record is the
+ * kTraceRecordBytes of packed fixed-size fields in host byte order
+ * followed by name_length bytes of name for add* and rename calls.
+ * SetCourseSchedule carries its MeetingMask there instead, encoded as in
+ * the write-ahead log, and GetCourseRoster the cursor's name, with the
+ * order in bit 0 of arg1, the page size above it and the cursor's ID in
+ * arg2.
+ */
+struct TraceRecord {
+    std::uint64_t timestamp_ns; ///< Nanoseconds since the start of the recording
+    std::uint32_t thread_id;    ///< Dense ID of the calling thread
+    TraceOp op;                 ///< The call
+    std::int32_t arg0;          ///< First integer argument (student, faculty or course ID)
+    std::int32_t arg1;          ///< Second integer argument, 0 if unused
+    std::int32_t arg2;          ///< Third integer argument, 0 if unused
+    std::uint32_t name_length;  ///< Length of the name that follows, 0 if none
+    std::string name;           ///< Name argument of add* calls, or the encoded mask of SetCourseSchedule
+};
+
+/**
+ * @brief Class to record calls into a binary trace file.
+ *
+ * Each thread appends to its own buffer with no shared writes on the hot
+ * path; full buffers are handed to a writer under a mutex and written in
+ * one block. Thread IDs are assigned densely in order of first call.
+ *
+ * A thread finds its buffer through a one-entry thread_local cache keyed
+ * by a process-unique recorder ID, so a thread alternating between
+ * recorders takes the mutex on each switch, but no entry ever refers to a
+ * destroyed recorder. Blocks of one thread can reach the file out of order
+ * when flush() races with a full buffer; the reader orders each thread's
+ * records by timestamp.
+ */
+class TraceRecorder {
+public:
+    /**
+     * @brief Open a trace file for writing.
+     * @param path Destination file path.
+     * @param buffer_records Records buffered per thread before a write.
+     * @throws std::runtime_error if the file cannot be opened.
+     */
+    explicit TraceRecorder(const std::string &path, std::size_t buffer_records = 4096)
+        : out(new std::ofstream(path, std::ios::binary | std::ios::trunc)),
+          buffer_records(buffer_records == 0 ? 1 : buffer_records),
+          recorder_id(nextRecorderId()),
+          start(std::chrono::steady_clock::now()) {
+        if (!*out) {
+            throw std::runtime_error("Cannot open trace file " + path);
+        }
+        out->write(reinterpret_cast<const char *>(&kTraceMagic), sizeof(kTraceMagic));
+    }
+
+    /**
+     * @brief Flush every thread's buffer and close the file.
+     */
+    ~TraceRecorder() {
+        flush();
+    }
+
+    TraceRecorder(const TraceRecorder &) = delete;
+    TraceRecorder &operator=(const TraceRecorder &) = delete;
+
+    /**
+     * @brief Record a call made by the current thread.
+     * @param op The call.
+     * @param arg0 First integer argument.
+     * @param arg1 Second integer argument.
+     * @param arg2 Third integer argument.
+     * @param name Name argument of add* calls, empty otherwise.
+     */
+    void record(TraceOp op, std::int32_t arg0, std::int32_t arg1 = 0, std::int32_t arg2 = 0, const std::string &name = std::string()) {
+        std::uint64_t timestamp = static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count());
+        ThreadBuffer &buffer = localBuffer();
+        std::vector<char> full;
+        {
+            std::lock_guard<std::mutex> lock(buffer.mtx);
+            std::uint32_t name_length = static_cast<std::uint32_t>(name.size());
+            std::uint8_t op_byte = static_cast<std::uint8_t>(op);
+            char fixed[kTraceRecordBytes];
+            char *p = fixed;
+            std::memcpy(p, &timestamp, 8);
+            std::memcpy(p + 8, &buffer.thread_id, 4);
+            std::memcpy(p + 12, &op_byte, 1);
+            std::memcpy(p + 13, &arg0, 4);
+            std::memcpy(p + 17, &arg1, 4);
+            std::memcpy(p + 21, &arg2, 4);
+            std::memcpy(p + 25, &name_length, 4);
+            buffer.bytes.insert(buffer.bytes.end(), fixed, fixed + kTraceRecordBytes);
+            buffer.bytes.insert(buffer.bytes.end(), name.begin(), name.end());
+            if (++buffer.count >= buffer_records) {
+                full.swap(buffer.bytes);
+                buffer.count = 0;
+            }
+        }
+        records.fetch_add(1, std::memory_order_relaxed);
+        if (!full.empty()) {
+            std::lock_guard<std::mutex> lock(mtx);
+            out->write(full.data(), static_cast<std::streamsize>(full.size()));
+        }
+    }
+
+    /**
+     * @brief Write out every thread's buffered records.
+     */
+    void flush() {
+        std::lock_guard<std::mutex> lock(mtx);
+        for (const auto &entry : buffers) {
+            std::vector<char> block;
+            {
+                std::lock_guard<std::mutex> buffer_lock(entry.second->mtx);
+                block.swap(entry.second->bytes);
+                entry.second->count = 0;
+            }
+            out->write(block.data(), static_cast<std::streamsize>(block.size()));
+        }
+        out->flush();
+    }
+
+    /**
+     * @brief Number of records captured so far.
+     * @return Total records across threads.
+     */
+    std::uint64_t recordCount() const {
+        return records.load(std::memory_order_relaxed);
+    }
+
+private:
+    /**
+     * @brief Per-thread record buffer, registered on first use.
+     *
+     * The mutex is only contended when flush() drains the buffer.
+     */
+    struct ThreadBuffer {
+        std::uint32_t thread_id = 0; ///< Dense ID of the owning thread
+        std::vector<char> bytes;     ///< Encoded records not yet written
+        std::size_t count = 0;       ///< Records in bytes
+        std::mutex mtx;              ///< Guards bytes and count against flush()
+    };
+
+    static std::uint64_t nextRecorderId() {
+        static std::atomic<std::uint64_t> next{1};
+        return next.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    ThreadBuffer &localBuffer() {
+        struct Cache {
+            std::uint64_t recorder_id = 0;
+            ThreadBuffer *buffer = nullptr;
+        };
+        static thread_local Cache cache;
+        if (cache.recorder_id == recorder_id) {
+            return *cache.buffer;
+        }
+        std::lock_guard<std::mutex> lock(mtx);
+        std::unique_ptr<ThreadBuffer> &buffer = buffers[std::this_thread::get_id()];
+        if (!buffer) {
+            buffer.reset(new ThreadBuffer());
+            buffer->thread_id = next_thread_id++;
+        }
+        cache.recorder_id = recorder_id;
+        cache.buffer = buffer.get();
+        return *buffer;
+    }
+
+    std::unique_ptr<std::ostream> out;  ///< Trace file stream
+    std::size_t buffer_records;         ///< Records buffered per thread before a write
+    std::uint64_t recorder_id;          ///< Process-unique ID, never reused, keying the thread_local cache
+    std::unordered_map<std::thread::id, std::unique_ptr<ThreadBuffer>> buffers; ///< Buffers of every recording thread
+    std::uint32_t next_thread_id = 0;   ///< Next dense thread ID, under mtx
+    std::atomic<std::uint64_t> records{0};        ///< Total records captured
+    std::chrono::steady_clock::time_point start;  ///< Recording start time
+    std::mutex mtx;                     ///< Mutex guarding out and buffers
+};
+
+/**
+ * @brief Latency summary of one operation kind during a replay.
+ */
+struct OpLatency {
+    std::uint64_t calls = 0;     ///< Number of calls replayed
+    std::uint64_t failures = 0;  ///< Calls that threw
+    double p50_us = 0;           ///< Median latency in microseconds
+    double p99_us = 0;           ///< 99th percentile latency in microseconds
+    double max_us = 0;           ///< Maximum latency in microseconds
+};
+
+/**
+ * @brief Result of a replay, one entry per TraceOp.
+ */
+struct ReplayReport {
+    std::array<OpLatency, static_cast<std::size_t>(TraceOp::Count)> ops; ///< Latency per operation
+    std::chrono::microseconds elapsed{0}; ///< Wall-clock duration of the replay
+
+    /**
+     * @brief Write the report in a stable text format for comparison across builds.
+     * @param out Destination stream.
+     */
+    void write(std::ostream &out) const {
+        out << "elapsed_us " << elapsed.count() << '\n';
+        out << std::setprecision(17);
+        for (std::size_t i = 0; i < ops.size(); ++i) {
+            const OpLatency &op = ops[i];
+            out << traceOpName(static_cast<TraceOp>(i)) << ' ' << op.calls << ' ' << op.failures << ' '
+                << op.p50_us << ' ' << op.p99_us << ' ' << op.max_us << '\n';
+        }
+    }
+
+    /**
+     * @brief Read a report written by write().
+     * @param in Source stream.
+     * @return The report.
+     * @throws std::runtime_error if the stream is malformed.
+     */
+    static ReplayReport read(std::istream &in) {
+        ReplayReport report;
+        std::string field;
+        long long elapsed_us = 0;
+        if (!(in >> field >> elapsed_us) || field != "elapsed_us") {
+            throw std::runtime_error("Malformed replay report");
+        }
+        report.elapsed = std::chrono::microseconds(elapsed_us);
+        std::string name;
+        OpLatency op;
+        while (in >> name >> op.calls >> op.failures >> op.p50_us >> op.p99_us >> op.max_us) {
+            // Unknown names come from a build with more operations; skip them.
+            for (std::size_t i = 0; i < report.ops.size(); ++i) {
+                if (name == traceOpName(static_cast<TraceOp>(i))) {
+                    report.ops[i] = op;
+                }
+            }
+        }
+        if (!in.eof()) {
+            throw std::runtime_error("Malformed replay report");
+        }
+        return report;
+    }
+};
+
+/**
+ * @brief Class to replay a recorded trace against a UniversityManager.
+ *
+ * Each recorded thread is replayed on its own worker thread, preserving the
+ * per-thread call order. Calls are issued at their recorded offsets divided
+ * by the speed-up factor, or back to back when the factor is 0, in which
+ * case calls of different threads are no longer ordered by time.
+ *
+ * Hold handles are not stable across runs, so HoldSeat, ReleaseHold and
+ * ConfirmHold are recorded with the student in arg0 and the course in
+ * arg1, plus the TTL in milliseconds in arg2 for HoldSeat. The replay
+ * maps each (student, course) pair to the handle returned by the replayed
+ * holdSeat(), in one map shared by all workers, since a hold placed on
+ * one thread can be confirmed or released on another.
+ */
+class TraceReplayer {
+public:
+    /**
+     * @brief Load a trace file.
+     * @param path Trace file path.
+     * @throws std::runtime_error if the file cannot be read or is malformed.
+     */
+    explicit TraceReplayer(const std::string &path) {
+        std::ifstream in(path, std::ios::binary);
+        if (!in) {
+            throw std::runtime_error("Cannot open trace file " + path);
+        }
+        std::uint32_t magic = 0;
+        if (!in.read(reinterpret_cast<char *>(&magic), sizeof(magic)) || magic != kTraceMagic) {
+            throw std::runtime_error("Not a trace file: " + path);
+        }
+        char fixed[kTraceRecordBytes];
+        while (in.read(fixed, kTraceRecordBytes)) {
+            TraceRecord record;
+            std::uint8_t op_byte;
+            std::memcpy(&record.timestamp_ns, fixed, 8);
+            std::memcpy(&record.thread_id, fixed + 8, 4);
+            std::memcpy(&op_byte, fixed + 12, 1);
+            std::memcpy(&record.arg0, fixed + 13, 4);
+            std::memcpy(&record.arg1, fixed + 17, 4);
+            std::memcpy(&record.arg2, fixed + 21, 4);
+            std::memcpy(&record.name_length, fixed + 25, 4);
+            if (op_byte >= static_cast<std::uint8_t>(TraceOp::Count)) {
+                throw std::runtime_error("Malformed trace file: unknown operation");
+            }
+            record.op = static_cast<TraceOp>(op_byte);
+            record.name.resize(record.name_length);
+            if (record.name_length != 0 && !in.read(&record.name[0], record.name_length)) {
+                throw std::runtime_error("Malformed trace file: truncated record");
+            }
+            if (record.thread_id >= threads.size()) {
+                threads.resize(record.thread_id + 1);
+            }
+            threads[record.thread_id].push_back(std::move(record));
+        }
+        if (in.gcount() != 0) {
+            throw std::runtime_error("Malformed trace file: truncated record");
+        }
+        for (std::vector<TraceRecord> &thread : threads) {
+            std::stable_sort(thread.begin(), thread.end(), [](const TraceRecord &a, const TraceRecord &b) { return a.timestamp_ns < b.timestamp_ns; });
+        }
+    }
+
+    /**
+     * @brief Replay the trace.
+     * @param university The target university, normally empty.
+     * @param speedup Time compression factor: 1 for original speed, 0 for as fast as possible.
+     * @return Per-operation latencies.
+     */
+    ReplayReport replay(UniversityManager &university, double speedup = 1.0) const {
+        HoldMap holds;
+        std::vector<std::array<std::vector<double>, static_cast<std::size_t>(TraceOp::Count)>> latencies(threads.size());
+        std::vector<std::array<std::uint64_t, static_cast<std::size_t>(TraceOp::Count)>> failures(threads.size());
+        std::vector<std::thread> workers;
+        auto start = std::chrono::steady_clock::now();
+        for (std::size_t t = 0; t < threads.size(); ++t) {
+            failures[t].fill(0);
+            workers.emplace_back([&, t] {
+                for (const TraceRecord &record : threads[t]) {
+                    if (speedup > 0) {
+                        std::this_thread::sleep_until(start + std::chrono::nanoseconds(static_cast<std::int64_t>(static_cast<double>(record.timestamp_ns) / speedup)));
+                    }
+                    std::size_t op = static_cast<std::size_t>(record.op);
+                    auto call_start = std::chrono::steady_clock::now();
+                    try {
+                        apply(university, record, holds);
+                    } catch (const std::exception &) {
+                        ++failures[t][op];
+                    }
+                    std::chrono::duration<double, std::micro> latency = std::chrono::steady_clock::now() - call_start;
+                    latencies[t][op].push_back(latency.count());
+                }
+            });
+        }
+        for (std::thread &worker : workers) {
+            worker.join();
+        }
+
+        ReplayReport report;
+        report.elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+        for (std::size_t op = 0; op < report.ops.size(); ++op) {
+            std::vector<double> samples;
+            for (std::size_t t = 0; t < threads.size(); ++t) {
+                samples.insert(samples.end(), latencies[t][op].begin(), latencies[t][op].end());
+                report.ops[op].failures += failures[t][op];
+            }
+            if (samples.empty()) {
+                continue;
+            }
+            std::sort(samples.begin(), samples.end());
+            report.ops[op].calls = samples.size();
+            report.ops[op].p50_us = samples[(samples.size() - 1) / 2];
+            report.ops[op].p99_us = samples[(samples.size() - 1) * 99 / 100];
+            report.ops[op].max_us = samples.back();
+        }
+        return report;
+    }
+
+    /**
+     * @brief Compare two replays, e.g. from a baseline and a candidate build.
+     * @param baseline Report from the baseline build.
+     * @param candidate Report from the candidate build.
+     * @param out Destination for a per-operation table of p50/p99 ratios.
+     */
+    static void compare(const ReplayReport &baseline, const ReplayReport &candidate, std::ostream &out) {
+        out << std::left << std::setw(22) << "operation" << std::right << std::setw(10) << "calls"
+            << std::setw(12) << "p50_ratio" << std::setw(12) << "p99_ratio" << '\n';
+        out << std::fixed << std::setprecision(3);
+        for (std::size_t i = 0; i < baseline.ops.size(); ++i) {
+            const OpLatency &base = baseline.ops[i];
+            const OpLatency &cand = candidate.ops[i];
+            if (base.calls == 0 && cand.calls == 0) {
+                continue;
+            }
+            auto ratio = [](double candidate_us, double baseline_us) { return baseline_us > 0 ? candidate_us / baseline_us : 0.0; };
+            out << std::left << std::setw(22) << traceOpName(static_cast<TraceOp>(i)) << std::right << std::setw(10) << cand.calls
+                << std::setw(12) << ratio(cand.p50_us, base.p50_us) << std::setw(12) << ratio(cand.p99_us, base.p99_us) << '\n';
+        }
+    }
+
+private:
+    /**
+     * @brief Replayed hold handles by (student, course), shared by all workers.
+     */
+    struct HoldMap {
+        std::unordered_map<std::uint64_t, SeatHoldId> handles; ///< Handle of each replayed hold
+        std::mutex mtx;                                       ///< Guards handles
+    };
+
+    static std::uint64_t holdKey(std::int32_t student_id, std::int32_t course_id) {
+        return (static_cast<std::uint64_t>(static_cast<std::uint32_t>(student_id)) << 32) | static_cast<std::uint32_t>(course_id);
+    }
+
+    /**
+     * @brief Take the handle recorded for a pair, 0 if none.
+     */
+    static SeatHoldId takeHold(HoldMap &holds, const TraceRecord &record) {
+        std::lock_guard<std::mutex> lock(holds.mtx);
+        auto it = holds.handles.find(holdKey(record.arg0, record.arg1));
+        if (it == holds.handles.end()) {
+            return 0;
+        }
+        SeatHoldId hold = it->second;
+        holds.handles.erase(it);
+        return hold;
+    }
+
+    /**
+     * @brief Issue one recorded call.
+     */
+    static void apply(UniversityManager &university, const TraceRecord &record, HoldMap &holds) {
+        auto ignoreStudent = [](const Student &) {};
+        auto ignoreFaculty = [](const Faculty &) {};
+        auto ignoreCourse = [](const Course &) {};
+        switch (record.op) {
+        case TraceOp::AddStudent:
+            university.addStudent(record.arg0, record.name);
+            break;
+        case TraceOp::EnrollInCourse:
+            university.enrollInCourse(record.arg0, record.arg1);
+            break;
+        case TraceOp::DropCourse:
+            university.dropCourse(record.arg0, record.arg1);
+            break;
+        case TraceOp::GetStudentCourses:
+            university.getStudentCourses(record.arg0);
+            break;
+        case TraceOp::AddFaculty:
+            university.addFaculty(record.arg0, record.name);
+            break;
+        case TraceOp::AssignCourse:
+            university.assignCourse(record.arg0, record.arg1);
+            break;
+        case TraceOp::GetFacultyCourses:
+            university.getFacultyCourses(record.arg0);
+            break;
+        case TraceOp::AddCourse:
+            university.addCourse(record.arg0, record.name, record.arg1);
+            break;
+        case TraceOp::GetCourseStudents:
+            university.getCourseStudents(record.arg0);
+            break;
+        case TraceOp::GetCourseRoster: {
+            RosterCursor after;
+            after.name = record.name;
+            after.student_id = record.arg2;
+            university.getCourseRoster(record.arg0, static_cast<RosterOrder>(record.arg1 & 1), after, static_cast<std::size_t>(record.arg1 >> 1));
+            break;
+        }
+        case TraceOp::SetCourseCapacity:
+            university.setCourseCapacity(record.arg0, record.arg1);
+            break;
+        case TraceOp::SetCourseName:
+            university.setCourseName(record.arg0, record.name);
+            break;
+        case TraceOp::SetCourseFaculty:
+            university.setCourseFaculty(record.arg0, record.arg1);
+            break;
+        case TraceOp::SetFacultyName:
+            university.setFacultyName(record.arg0, record.name);
+            break;
+        case TraceOp::HoldSeat: {
+            SeatHoldId hold = university.holdSeat(record.arg0, record.arg1, std::chrono::milliseconds(record.arg2));
+            std::lock_guard<std::mutex> lock(holds.mtx);
+            holds.handles[holdKey(record.arg0, record.arg1)] = hold;
+            break;
+        }
+        case TraceOp::ReleaseHold:
+            university.releaseHold(takeHold(holds, record));
+            break;
+        case TraceOp::ConfirmHold:
+            university.confirmHold(takeHold(holds, record));
+            break;
+        case TraceOp::ExpireHolds:
+            university.expireHolds();
+            break;
+        case TraceOp::SwapSection:
+            university.swapSection(record.arg0, record.arg1, record.arg2);
+            break;
+        case TraceOp::SetCourseSchedule:
+            university.setCourseSchedule(record.arg0, record.arg1, decodeMeetingMask(record.name));
+            break;
+        case TraceOp::GetStudentIds:
+            university.getStudentIds();
+            break;
+        case TraceOp::ForEachStudent:
+            university.forEachStudent(ignoreStudent);
+            break;
+        case TraceOp::VisitStudent:
+            university.visitStudent(record.arg0, ignoreStudent);
+            break;
+        case TraceOp::ForEachFaculty:
+            university.forEachFaculty(ignoreFaculty);
+            break;
+        case TraceOp::VisitFaculty:
+            university.visitFaculty(record.arg0, ignoreFaculty);
+            break;
+        case TraceOp::ForEachCourse:
+            university.forEachCourse(ignoreCourse);
+            break;
+        case TraceOp::VisitCourse:
+            university.visitCourse(record.arg0, ignoreCourse);
+            break;
+        case TraceOp::IsEnrolled:
+            university.isEnrolled(record.arg0, record.arg1);
+            break;
+        case TraceOp::GetCourseFaculty:
+            university.getCourseFaculty(record.arg0);
+            break;
+        case TraceOp::GetCourseMetadata:
+            university.getCourseMetadata(record.arg0);
+            break;
+        case TraceOp::GetFacultyMetadata:
+            university.getFacultyMetadata(record.arg0);
+            break;
+        case TraceOp::GetCourseCapacity:
+            university.getCourseCapacity(record.arg0);
+            break;
+        case TraceOp::GetOpenSeats:
+            university.getOpenSeats(record.arg0);
+            break;
+        case TraceOp::GetFamilySections:
+            university.getFamilySections(record.arg0);
+            break;
+        case TraceOp::FindOpenSections:
+            university.findOpenSections(record.arg0, record.arg1);
+            break;
+        case TraceOp::GetCourseIds:
+            university.getCourseIds();
+            break;
+        case TraceOp::GetCachedResult:
+            university.getCachedResult(static_cast<CachedQuery>(record.arg0), record.arg1);
+            break;
+        case TraceOp::IsAuthorized:
+            university.isAuthorized(record.arg0, static_cast<AccessAction>(record.arg1), record.arg2);
+            break;
+        case TraceOp::GetCourseStudentsAs:
+            university.getCourseStudentsAs(record.arg0, record.arg1);
+            break;
+        case TraceOp::GetFacultyCoursesAs:
+            university.getFacultyCoursesAs(record.arg0, record.arg1);
+            break;
+        case TraceOp::Count:
+            break;
+        }
+    }
+
+    std::vector<std::vector<TraceRecord>> threads; ///< Records grouped by recorded thread, in order
+};
+
+#endif // TRACE_H
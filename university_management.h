@@ -13,12 +13,80 @@
 #define UNIVERSITY_MANAGEMENT_H
 
 #include <string>
+#include <algorithm>
+#include <array>
+#include <bitset>
+#include <set>
+#include <vector>
+#include <utility>
+#include <climits>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <atomic>
+#include <chrono>
+#include <exception>
+#include <fstream>
+#include <functional>
+#include <future>
+#include <istream>
+#include <ostream>
 #include <unordered_map>
 #include <unordered_set>
 #include <memory>
 #include <mutex>
 #include <shared_mutex>
 #include <stdexcept>
+#include <thread>
+
+#include <fcntl.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "seqlock.h"
+#include "perfect_hash.h"
+#include "wal.h"
+#include "timing_wheel.h"
+
+#if defined(UNIVERSITY_LOCKFREE_RECORDS)
+#include "lockfree_map.h"
+#elif defined(UNIVERSITY_INCREMENTAL_REHASH_RECORDS)
+#include "incremental_map.h"
+#else
+#include "hash_id_map.h"
+#endif
+
+constexpr std::size_t kMetadataNameLength = 63; ///< Longest name held in seqlock-protected metadata
+
+/**
+ * @brief Course fields readable without locking.
+ */
+struct CourseMetadata {
+    int faculty_id;       ///< Faculty member ID who teaches the course
+    int capacity;         ///< Maximum number of enrolled students, 0 for unlimited
+    bool name_truncated;  ///< True if name holds only a prefix of Course::name
+    char name[kMetadataNameLength + 1]; ///< NUL-terminated name, truncated to kMetadataNameLength bytes
+};
+
+/**
+ * @brief Faculty fields readable without locking.
+ */
+struct FacultyMetadata {
+    bool name_truncated;  ///< True if name holds only a prefix of Faculty::name
+    char name[kMetadataNameLength + 1]; ///< NUL-terminated name, truncated to kMetadataNameLength bytes
+};
+
+constexpr std::size_t kWeekSlots = 7 * 48; ///< Half-hour meeting slots per week, Monday 00:00 first
+
+/**
+ * @brief Weekly meeting times of a section as one bit per half-hour slot.
+ *
+ * Two sections conflict exactly when their masks intersect.
+ */
+using MeetingMask = std::bitset<kWeekSlots>;
 
 /**
  * @brief Structure to represent a student.
@@ -27,6 +95,7 @@ struct Student {
     int student_id;        ///< Unique identifier for the student
     std::string name;      ///< Name of the student
     std::unordered_set<int> courses; ///< Set of course IDs the student is enrolled in
+    std::uint64_t version = 0; ///< Incremented on every mutation of the record
 };
 
 /**
@@ -36,6 +105,8 @@ struct Faculty {
     int faculty_id;        ///< Unique identifier for the faculty member
     std::string name;      ///< Name of the faculty member
     std::unordered_set<int> courses; ///< Set of course IDs the faculty member is teaching
+    std::uint64_t version = 0; ///< Incremented on every mutation of the record
+    SeqLocked<FacultyMetadata> metadata; ///< Copy of name for optimistic reads, written under the manager's lock
 };
 
 /**
@@ -45,121 +116,292 @@ struct Course {
     int course_id;         ///< Unique identifier for the course
     std::string name;      ///< Name of the course
     int faculty_id;        ///< Faculty member ID who teaches the course
+    int capacity = 0;      ///< Maximum number of enrolled students, 0 for unlimited
+    int held_seats = 0;    ///< Seats reserved by unexpired holds; a hold is only granted while enrolled + held < capacity, but lowering capacity later can leave enrolled + held above it
+    int family_id = -1;    ///< ID shared by all sections of the same catalog course, -1 if unassigned
+    MeetingMask meetings;  ///< Weekly meeting times of the section
     std::unordered_set<int> students; ///< Set of student IDs enrolled in the course
+    std::set<std::pair<std::string, int>> roster_by_name; ///< Enrolled students ordered by (name, ID) for paginated rosters
+    std::set<int> roster_by_id; ///< Enrolled student IDs in ascending order for paginated rosters
+    std::uint64_t version = 0; ///< Incremented on every mutation of the record
+    SeqLocked<CourseMetadata> metadata; ///< Copy of name, faculty_id and capacity for optimistic reads, written under the manager's lock
 };
 
 /**
- * @brief Class to manage student records.
+ * @brief Sort order for paginated course rosters.
+ */
+enum class RosterOrder {
+    ByName, ///< Order by student name, ties broken by student ID
+    ById    ///< Order by student ID
+};
+
+/**
+ * @brief Position in a paginated roster.
  *
- * Uses std::unordered_map for efficient concurrent storage and retrieval of student records.
- * std::unordered_map provides average O(1) complexity for insertions, deletions, and look-ups.
+ * A cursor names the last row of the previous page, so it stays valid when
+ * students are enrolled or dropped between page loads. A default-constructed
+ * cursor starts at the first row.
  */
-class StudentManager {
-public:
-    /**
-     * @brief Add a new student to the system.
-     * @param student_id The unique identifier for the student.
-     * @param name The name of the student.
-     */
-    void addStudent(int student_id, const std::string &name);
+struct RosterCursor {
+    std::string name;      ///< Name of the last student returned (ByName order only)
+    int student_id = -1;   ///< ID of the last student returned, -1 for the first page
+};
 
-    /**
-     * @brief Enroll a student in a course.
-     * @param student_id The unique identifier for the student.
-     * @param course_id The unique identifier for the course.
-     * @throws std::runtime_error if the course does not exist.
-     */
-    void enrollInCourse(int student_id, int course_id);
+/**
+ * @brief One page of a course roster.
+ */
+struct RosterPage {
+    std::vector<int> student_ids; ///< Student IDs on this page, in the requested order
+    RosterCursor next;            ///< Cursor to pass in for the following page
+    bool has_more = false;        ///< True if further rows follow this page
+};
+
+/**
+ * @brief Storage backend for the managers' record tables.
+ *
+ * Defaults to HashIdMap, a std::unordered_map guarded by the manager's
+ * shared_mutex. Building with UNIVERSITY_LOCKFREE_RECORDS selects
+ * LockFreeIdMap, whose lookups and mutations take no lock; the manager's
+ * mutex then only guards changes to a record's contents, such as its
+ * course or student sets, and lock-free lookups hold a pin() guard while
+ * they use the record. Building with UNIVERSITY_INCREMENTAL_REHASH_RECORDS
+ * selects IncrementalIdMap, which grows a few buckets per insert so that
+ * no single insert stalls readers behind a whole-table rehash.
+ *
+ * All three backends share one interface, so the managers compile against
+ * any of them: find(id) returning V* (nullptr if absent), emplace(id, v)
+ * returning std::pair<V *, bool>, assign(id, v) to insert or replace,
+ * erase(id), reserve(count), size() and forEach(visitor).
+ *
+ * @tparam T The record type.
+ */
+#if defined(UNIVERSITY_LOCKFREE_RECORDS)
+template <typename T>
+using RecordMap = LockFreeIdMap<std::shared_ptr<T>>;
+#elif defined(UNIVERSITY_INCREMENTAL_REHASH_RECORDS)
+template <typename T>
+using RecordMap = IncrementalIdMap<std::shared_ptr<T>>;
+#else
+template <typename T>
+using RecordMap = HashIdMap<std::shared_ptr<T>>;
+#endif
+
+/**
+ * @brief Lookup statistics for a manager's negative-lookup filter.
+ */
+struct LookupFilterStats {
+    std::uint64_t lookups = 0;          ///< Lookups that consulted the filter
+    std::uint64_t filtered = 0;         ///< Lookups rejected by the filter without taking the lock
+    std::uint64_t false_positives = 0;  ///< Lookups that passed the filter but found no record
 
     /**
-     * @brief Get the list of courses a student is enrolled in.
-     * @param student_id The unique identifier for the student.
-     * @return A set of course IDs.
+     * @brief Observed false-positive rate among IDs that were not present.
+     * @return false_positives / (filtered + false_positives), or 0 if there were none.
      */
-    std::unordered_set<int> getStudentCourses(int student_id) const;
-
-private:
-    std::unordered_map<int, std::shared_ptr<Student>> student_records; ///< Hash table for student records
-    mutable std::shared_mutex mtx; ///< Shared mutex for thread safety
+    double falsePositiveRate() const {
+        std::uint64_t misses = filtered + false_positives;
+        return misses == 0 ? 0.0 : static_cast<double>(false_positives) / static_cast<double>(misses);
+    }
 };
 
 /**
- * @brief Class to manage faculty records.
+ * @brief Concurrent Bloom filter over record IDs.
  *
- * Uses std::unordered_map for efficient concurrent storage and retrieval of faculty records.
- * std::unordered_map provides average O(1) complexity for insertions, deletions, and look-ups.
+ * Bits are stored in an array of std::atomic<std::uint64_t> words, so insert()
+ * (fetch_or) and mayContain() (relaxed loads) never take a lock. IDs are only
+ * ever added, matching the managers, which never delete records. A negative
+ * answer is exact; a positive answer must be confirmed against the hash table.
+ *
+ * The bit array has a fixed size. Once more than capacity() IDs are
+ * inserted the false-positive rate climbs towards 1, so the managers replace
+ * a full filter with one of twice the capacity (see
+ * StudentManager::getLookupFilterStats()) or with the count passed to reserve().
  */
-class FacultyManager {
+class IdBloomFilter {
 public:
     /**
-     * @brief Add a new faculty member to the system.
-     * @param faculty_id The unique identifier for the faculty member.
-     * @param name The name of the faculty member.
+     * @brief Construct a filter sized for the expected number of IDs.
+     * @param expected_ids Expected number of distinct IDs.
+     * @param bits_per_id Bits allocated per expected ID (10 gives roughly a 1% false-positive rate).
      */
-    void addFaculty(int faculty_id, const std::string &name);
+    explicit IdBloomFilter(std::size_t expected_ids = 1 << 16, std::size_t bits_per_id = 10);
 
     /**
-     * @brief Assign a faculty member to teach a course.
-     * @param faculty_id The unique identifier for the faculty member.
-     * @param course_id The unique identifier for the course.
-     * @throws std::runtime_error if the course does not exist.
+     * @brief Record an ID as present.
+     * @param id The record ID.
      */
-    void assignCourse(int faculty_id, int course_id);
+    void insert(int id);
 
     /**
-     * @brief Get the list of courses a faculty member is teaching.
-     * @param faculty_id The unique identifier for the faculty member.
-     * @return A set of course IDs.
+     * @brief Check whether an ID may be present.
+     * @param id The record ID.
+     * @return false if the ID was definitely never inserted.
      */
-    std::unordered_set<int> getFacultyCourses(int faculty_id) const;
+    bool mayContain(int id) const;
+
+    /**
+     * @brief Number of IDs the filter was sized for.
+     * @return The expected_ids the filter was constructed with.
+     */
+    std::size_t capacity() const;
 
 private:
-    std::unordered_map<int, std::shared_ptr<Faculty>> faculty_records; ///< Hash table for faculty records
-    mutable std::shared_mutex mtx; ///< Shared mutex for thread safety
+    std::unique_ptr<std::atomic<std::uint64_t>[]> words; ///< Bit array
+    std::size_t expected;    ///< Number of IDs the bit array was sized for
+    std::size_t word_count;  ///< Number of 64-bit words in the bit array
+    unsigned hash_count;     ///< Number of probe positions per ID
 };
 
 /**
- * @brief Class to manage course records.
+ * @brief Public UniversityManager operations, for per-operation metrics and traces.
  *
- * Uses std::unordered_map for efficient concurrent storage and retrieval of course records.
- * std::unordered_map provides average O(1) complexity for insertions, deletions, and look-ups.
+ * Values are part of the trace file format; append new operations at the end.
  */
-class CourseManager {
+enum class OperationKind : std::uint8_t {
+    AddStudent = 0,
+    EnrollInCourse = 1,
+    DropCourse = 2,
+    GetStudentCourses = 3,
+    AddFaculty = 4,
+    AssignCourse = 5,
+    GetFacultyCourses = 6,
+    AddCourse = 7,
+    GetCourseStudents = 8,
+    GetCourseRoster = 9,
+    SetCourseCapacity = 10,
+    SetCourseName = 11,
+    SetCourseFaculty = 12,
+    SetFacultyName = 13,
+    HoldSeat = 14,
+    ReleaseHold = 15,
+    ConfirmHold = 16,
+    ExpireHolds = 17,
+    SwapSection = 18,
+    SetCourseSchedule = 19,
+    GetStudentIds = 20,
+    ForEachStudent = 21,
+    VisitStudent = 22,
+    ForEachFaculty = 23,
+    VisitFaculty = 24,
+    ForEachCourse = 25,
+    VisitCourse = 26,
+    IsEnrolled = 27,
+    GetCourseFaculty = 28,
+    GetCourseMetadata = 29,
+    GetFacultyMetadata = 30,
+    GetCourseCapacity = 31,
+    GetOpenSeats = 32,
+    GetFamilySections = 33,
+    FindOpenSections = 34,
+    GetCourseIds = 35,
+    GetCachedResult = 36,
+    IsAuthorized = 37,
+    GetCourseStudentsAs = 38,
+    GetFacultyCoursesAs = 39,
+    Count ///< Number of operations
+};
+
+/**
+ * @brief Exception thrown when a call cannot complete before its deadline.
+ */
+class DeadlineExceeded : public std::runtime_error {
+public:
+    using std::runtime_error::runtime_error;
+};
+
+/**
+ * @brief RAII scope that gives every UniversityManager call on this thread a deadline.
+ *
+ * While a scope is active, lock acquisitions in the managers use
+ * try_lock_until / try_lock_shared_until with the deadline, and multi-step
+ * operations check it between steps. A call that would pass the deadline
+ * throws DeadlineExceeded before mutating anything. Scopes nest; the
+ * earliest deadline wins. Without a scope, calls wait as before.
+ */
+class DeadlineScope {
 public:
+    using Clock = std::chrono::steady_clock; ///< Clock deadlines are measured on
+
     /**
-     * @brief Add a new course to the system.
-     * @param course_id The unique identifier for the course.
-     * @param name The name of the course.
-     * @param faculty_id The unique identifier for the faculty member teaching the course.
+     * @brief Set a deadline for calls made on this thread.
+     * @param deadline The point in time by which calls must complete.
      */
-    void addCourse(int course_id, const std::string &name, int faculty_id);
+    explicit DeadlineScope(Clock::time_point deadline);
 
     /**
-     * @brief Enroll a student in a course.
-     * @param course_id The unique identifier for the course.
-     * @param student_id The unique identifier for the student.
-     * @throws std::runtime_error if the student does not exist.
+     * @brief Set a deadline a fixed budget from now.
+     * @param budget Time allowed from now, e.g. the gateway's remaining budget.
      */
-    void enrollStudent(int course_id, int student_id);
+    explicit DeadlineScope(Clock::duration budget);
 
     /**
-     * @brief Get the list of students enrolled in a course.
-     * @param course_id The unique identifier for the course.
-     * @return A set of student IDs.
+     * @brief Restore the enclosing scope's deadline.
      */
-    std::unordered_set<int> getCourseStudents(int course_id) const;
+    ~DeadlineScope();
+
+    DeadlineScope(const DeadlineScope &) = delete;
+    DeadlineScope &operator=(const DeadlineScope &) = delete;
+
+    /**
+     * @brief Deadline in effect on this thread.
+     * @return The active deadline, or Clock::time_point::max() if none.
+     */
+    static Clock::time_point current();
 
 private:
-    std::unordered_map<int, std::shared_ptr<Course>> course_records; ///< Hash table for course records
-    mutable std::shared_mutex mtx; ///< Shared mutex for thread safety
+    /**
+     * @brief The calling thread's deadline slot.
+     * @return Reference to a thread_local holding the active deadline.
+     */
+    static Clock::time_point &slot();
+
+    Clock::time_point previous; ///< Deadline of the enclosing scope
 };
 
 /**
- * @brief Class to manage the entire university system.
+ * @brief Operation counters for throughput metrics.
+ */
+struct OperationCounters {
+    std::uint64_t reads = 0;          ///< Completed query calls
+    std::uint64_t writes = 0;         ///< Completed mutation calls
+    std::uint64_t quota_rejections = 0; ///< Mutations rejected by the memory quota
+};
+
+/**
+ * @brief Kind of snapshot to write.
+ */
+enum class SnapshotMode {
+    Full,       ///< Every record; becomes a new base image
+    Incremental ///< Only records dirtied since the last checkpoint
+};
+
+/**
+ * @brief Write volume and timing for a snapshot save or restore.
+ */
+struct SnapshotStats {
+    std::size_t records = 0;               ///< Records written or applied
+    std::size_t bytes = 0;                 ///< Bytes written or read
+    std::chrono::microseconds elapsed{0};  ///< Wall-clock time of the operation
+};
+
+/**
+ * @brief Cost and outcome of a fork()-based background snapshot.
+ */
+struct ForkSnapshotReport {
+    int exit_status = -1;                      ///< Child's exit status, non-zero if the job failed
+    std::chrono::microseconds fork_pause{0};   ///< Time writers were blocked: lock acquisition plus fork()
+    std::chrono::microseconds child_elapsed{0}; ///< Time from fork to child exit
+    long parent_minor_faults = 0;              ///< Minor page faults in the parent while the child ran, mostly copy-on-write copies
+    std::size_t parent_extra_bytes = 0;        ///< Estimated parent memory duplicated by copy-on-write (faults x page size)
+};
+
+/**
+ * @brief Class to manage student records.
  *
- * Provides an interface to manage students, faculty, and courses.
+ * Uses std::unordered_map for efficient concurrent storage and retrieval of student records.
+ * std::unordered_map provides average O(1) complexity for insertions, deletions, and look-ups.
  */
-class UniversityManager {
+class StudentManager {
 public:
     /**
      * @brief Add a new student to the system.
@@ -168,13 +410,38 @@ public:
      */
     void addStudent(int student_id, const std::string &name);
 
+    /**
+     * @brief Add a new student to the system, taking ownership of the name.
+     * @param student_id The unique identifier for the student.
+     * @param name The name of the student; moved into the record without copying.
+     */
+    void addStudent(int student_id, std::string &&name);
+
     /**
      * @brief Enroll a student in a course.
      * @param student_id The unique identifier for the student.
      * @param course_id The unique identifier for the course.
+     * @throws std::runtime_error if the course does not exist.
      */
     void enrollInCourse(int student_id, int course_id);
 
+    /**
+     * @brief Drop a student from a course.
+     * @param student_id The unique identifier for the student.
+     * @param course_id The unique identifier for the course.
+     * @throws std::runtime_error if the student does not exist.
+     */
+    void dropCourse(int student_id, int course_id);
+
+    /**
+     * @brief Replace one course in a student's enrollment set with another.
+     * @param student_id The unique identifier for the student.
+     * @param from_course_id The course being dropped.
+     * @param to_course_id The course being added.
+     * @throws std::runtime_error if the student does not exist or is not enrolled in @p from_course_id.
+     */
+    void replaceCourse(int student_id, int from_course_id, int to_course_id);
+
     /**
      * @brief Get the list of courses a student is enrolled in.
      * @param student_id The unique identifier for the student.
@@ -182,6 +449,264 @@ public:
      */
     std::unordered_set<int> getStudentCourses(int student_id) const;
 
+    /**
+     * @brief Get the IDs of all students.
+     * @return A vector of student IDs in unspecified order.
+     */
+    std::vector<int> getStudentIds() const;
+
+    /**
+     * @brief Visit every student record in place under the shared lock.
+     *
+     * The visitor must not call back into this manager.
+     *
+     * @param visitor Called once per record, in unspecified order.
+     */
+    void forEachStudent(const std::function<void(const Student &)> &visitor) const;
+
+    /**
+     * @brief Visit one student record in place under the shared lock.
+     * @param id The unique identifier for the record.
+     * @param visitor Called with the record if it exists.
+     * @return true if the record exists and was visited.
+     */
+    bool visitStudent(int id, const std::function<void(const Student &)> &visitor) const;
+
+    /**
+     * @brief Copy the course IDs a student is enrolled in into a caller-provided buffer.
+     *
+     * Does not allocate; intended for hot paths that reuse one buffer per thread.
+     *
+     * @param student_id The unique identifier for the student.
+     * @param out Buffer receiving up to @p capacity IDs.
+     * @param capacity Number of elements available in @p out.
+     * @return The total number of IDs, which may exceed @p capacity if the buffer was too small.
+     */
+    std::size_t getStudentCourses(int student_id, int *out, std::size_t capacity) const;
+
+    /**
+     * @brief Pre-size storage for an expected number of student records.
+     *
+     * Reserves record table and dirty-mark set buckets up front so that
+     * adding up to @p count records does not rehash, and rebuilds the negative-lookup filter for
+     * @p count IDs if it was sized for fewer.
+     *
+     * @param count Expected total number of records.
+     */
+    void reserve(std::size_t count);
+
+    /**
+     * @brief Get the name of a student.
+     * @param student_id The unique identifier for the student.
+     * @return The student's name.
+     * @throws std::runtime_error if the student does not exist.
+     */
+    std::string getStudentName(int student_id) const;
+
+    /**
+     * @brief Serialize student records to a snapshot stream.
+     *
+     * In Incremental mode only records marked dirty since the last committed
+     * checkpoint are written. Dirty marks are left in place: the caller
+     * passes @p checkpoint to commitSnapshot() once the snapshot is durable,
+     * so a snapshot that fails later loses no marks.
+     *
+     * @param out Stream receiving the serialized records.
+     * @param mode Whether to write every record or only dirty ones.
+     * @param checkpoint Receives the mutation sequence number the snapshot covers.
+     * @return The number of records and bytes written.
+     */
+    SnapshotStats writeSnapshot(std::ostream &out, SnapshotMode mode, std::uint64_t &checkpoint);
+
+    /**
+     * @brief Clear the dirty marks covered by a durable snapshot.
+     *
+     * Marks of records mutated again after the snapshot was written carry a
+     * later sequence number and are kept for the next incremental snapshot.
+     *
+     * @param checkpoint Sequence number returned by writeSnapshot().
+     */
+    void commitSnapshot(std::uint64_t checkpoint);
+
+    /**
+     * @brief Apply serialized student records from a snapshot stream.
+     *
+     * Records in the stream replace existing records with the same ID, so a
+     * base image followed by its incremental snapshots restores the latest state.
+     *
+     * @param in Stream holding records written by writeSnapshot().
+     * @return The number of records and bytes read.
+     * @throws std::runtime_error if the stream is malformed.
+     */
+    SnapshotStats loadSnapshot(std::istream &in);
+
+    /**
+     * @brief Get the current version of a student record.
+     * @param id The unique identifier for the record.
+     * @return The record's version counter, or 0 if the record does not exist.
+     */
+    std::uint64_t getRecordVersion(int id) const;
+
+    /**
+     * @brief Get statistics for the negative-lookup filter.
+     *
+     * Lookups for student IDs that were never added are rejected by the filter
+     * before the shared lock is taken. When an add takes the record count
+     * past the filter's capacity, the filter is rebuilt for twice as many
+     * IDs under the exclusive lock, so the false-positive rate stays near
+     * its design point as the table grows.
+     *
+     * @return A snapshot of the filter counters.
+     */
+    LookupFilterStats getLookupFilterStats() const;
+
+private:
+    friend class UniversityManager;    // locks mtx directly to quiesce writers before fork()
+    friend class ForkedUniversityView; // reads a forked child's image through the *Unlocked methods
+
+    /**
+     * @brief Visit every student record without locking.
+     *
+     * Only for a fork()ed child, where no other thread can hold or wait for mtx.
+     *
+     * @param visitor Called once per record, in unspecified order.
+     */
+    void forEachStudentUnlocked(const std::function<void(const Student &)> &visitor) const;
+
+    /**
+     * @brief Visit one student record without locking; as forEachStudentUnlocked().
+     * @param id The unique identifier for the record.
+     * @param visitor Called with the record if it exists.
+     * @return true if the record exists and was visited.
+     */
+    bool visitStudentUnlocked(int id, const std::function<void(const Student &)> &visitor) const;
+
+    /**
+     * @brief Serialize every student record without locking or touching dirty marks.
+     *
+     * Only for a fork()ed child, as forEachStudentUnlocked(). The output is a
+     * Full-mode snapshot that loadSnapshot() accepts.
+     *
+     * @param out Stream receiving the serialized records.
+     * @return The number of records and bytes written.
+     */
+    SnapshotStats writeFullSnapshotUnlocked(std::ostream &out) const;
+
+    /**
+     * @brief Check that replaceCourseLocked() will succeed.
+     * @param held Exclusive lock on mtx held by the caller.
+     * @param student_id The unique identifier for the student.
+     * @param from_course_id The course being dropped.
+     * @return The student's name, for the course roster's ByName order.
+     * @throws std::runtime_error if the student does not exist or is not enrolled in @p from_course_id.
+     */
+    const std::string &checkReplaceLocked(const std::unique_lock<std::shared_timed_mutex> &held, int student_id, int from_course_id) const;
+
+    /**
+     * @brief Replace one course in a student's enrollment set after checkReplaceLocked() passed.
+     *
+     * Runs under the same lock as the check, so it performs no validation
+     * and cannot fail on one.
+     *
+     * @param held Exclusive lock on mtx held by the caller.
+     * @param student_id The unique identifier for the student.
+     * @param from_course_id The course being dropped.
+     * @param to_course_id The course being added.
+     */
+    void replaceCourseLocked(const std::unique_lock<std::shared_timed_mutex> &held, int student_id, int from_course_id, int to_course_id);
+
+    /**
+     * @brief Check that enrollInCourseLocked() will succeed.
+     * @param held Exclusive lock on mtx held by the caller.
+     * @param student_id The unique identifier for the student.
+     * @param course_id The course being added.
+     * @return The student's name, for the course roster's ByName order.
+     * @throws std::runtime_error if the student does not exist or is already enrolled in @p course_id.
+     */
+    const std::string &checkEnrollLocked(const std::unique_lock<std::shared_timed_mutex> &held, int student_id, int course_id) const;
+
+    /**
+     * @brief Add a course to a student's enrollment set after checkEnrollLocked() passed.
+     *
+     * Also used by write-ahead log replay, which applies logged enrollments
+     * without re-validating them.
+     *
+     * @param held Exclusive lock on mtx held by the caller.
+     * @param student_id The unique identifier for the student.
+     * @param course_id The course being added.
+     */
+    void enrollInCourseLocked(const std::unique_lock<std::shared_timed_mutex> &held, int student_id, int course_id);
+
+    /**
+     * @brief Remove a course from a student's enrollment set.
+     * @param held Exclusive lock on mtx held by the caller.
+     * @param student_id The unique identifier for the student.
+     * @param course_id The course being dropped.
+     * @return true if the student was enrolled in the course.
+     * @throws std::runtime_error if the student does not exist; nothing is changed.
+     */
+    bool dropCourseLocked(const std::unique_lock<std::shared_timed_mutex> &held, int student_id, int course_id);
+
+    /**
+     * @brief Look up a record; caller holds mtx.
+     * @param id The unique identifier for the record.
+     * @return The record, or nullptr if it does not exist.
+     */
+    Student *findRecord(int id) const;
+
+    /**
+     * @brief Look up a record that passed the negative-lookup filter; caller holds mtx.
+     * @param id The unique identifier for the record.
+     * @return The record.
+     * @throws std::runtime_error if the record does not exist, counted as a filter false positive.
+     */
+    Student &requireRecord(int id) const;
+
+    /**
+     * @brief Check the negative-lookup filter; called before taking mtx.
+     * @param id The unique identifier for the record.
+     * @return true if the record definitely does not exist.
+     */
+    bool filterRejects(int id) const;
+
+    /**
+     * @brief Add an ID to the negative-lookup filter, rebuilding it first if it is full; caller holds mtx exclusively.
+     * @param id The unique identifier for the record.
+     */
+    void filterInsert(int id);
+
+    /**
+     * @brief Replace the negative-lookup filter with one sized for @p expected_ids holding every current ID; caller holds mtx exclusively.
+     * @param expected_ids Number of IDs the new filter is sized for.
+     */
+    void rebuildFilter(std::size_t expected_ids);
+
+    /**
+     * @brief Mark a record dirty with the next mutation sequence number; caller holds mtx exclusively.
+     * @param id The unique identifier for the record.
+     */
+    void markDirty(int id);
+
+    RecordMap<Student> student_records; ///< Hash table for student records
+    std::vector<std::unordered_set<int>::node_type> spare_course_nodes; ///< Nodes of dropped enrollments, reused by later ones; at most kSpareNodeLimit
+    std::unordered_map<int, std::uint64_t> dirty_ids; ///< IDs of records mutated since the last committed checkpoint, with the sequence number of their latest mutation
+    std::uint64_t mutation_sequence = 0; ///< Sequence number of the latest mutation
+    std::atomic<const IdBloomFilter *> id_filter{nullptr}; ///< Current filter of existing IDs, checked before taking mtx; replaced under mtx when full
+    std::vector<std::unique_ptr<IdBloomFilter>> id_filters; ///< Every filter built, current last; replaced ones, together smaller than the current one, stay alive for lookups still reading them
+    mutable std::atomic<std::uint64_t> filter_lookups{0};         ///< Lookups that consulted id_filter
+    mutable std::atomic<std::uint64_t> filter_rejections{0};      ///< Lookups rejected by id_filter
+    mutable std::atomic<std::uint64_t> filter_false_positives{0}; ///< Lookups passed by id_filter but not found
+    mutable std::shared_timed_mutex mtx; ///< Shared mutex for thread safety; timed so calls can honour deadlines
+};
+
+/**
+ * @brief Class to manage faculty records.
+ *
+ * Uses std::unordered_map for efficient concurrent storage and retrieval of faculty records.
+ * std::unordered_map provides average O(1) complexity for insertions, deletions, and look-ups.
+ */
+class FacultyManager {
+public:
     /**
      * @brief Add a new faculty member to the system.
      * @param faculty_id The unique identifier for the faculty member.
@@ -189,10 +714,18 @@ public:
      */
     void addFaculty(int faculty_id, const std::string &name);
 
+    /**
+     * @brief Add a new faculty member to the system, taking ownership of the name.
+     * @param faculty_id The unique identifier for the faculty member.
+     * @param name The name of the faculty member; moved into the record without copying.
+     */
+    void addFaculty(int faculty_id, std::string &&name);
+
     /**
      * @brief Assign a faculty member to teach a course.
      * @param faculty_id The unique identifier for the faculty member.
      * @param course_id The unique identifier for the course.
+     * @throws std::runtime_error if the course does not exist.
      */
     void assignCourse(int faculty_id, int course_id);
 
@@ -204,13 +737,405 @@ public:
     std::unordered_set<int> getFacultyCourses(int faculty_id) const;
 
     /**
-     * @brief Add a new course to the system.
-     * @param course_id The unique identifier for the course.
-     * @param name The name of the course.
+     * @brief Visit every faculty record in place under the shared lock.
+     *
+     * The visitor must not call back into this manager.
+     *
+     * @param visitor Called once per record, in unspecified order.
+     */
+    void forEachFaculty(const std::function<void(const Faculty &)> &visitor) const;
+
+    /**
+     * @brief Visit one faculty record in place under the shared lock.
+     * @param id The unique identifier for the record.
+     * @param visitor Called with the record if it exists.
+     * @return true if the record exists and was visited.
+     */
+    bool visitFaculty(int id, const std::function<void(const Faculty &)> &visitor) const;
+
+    /**
+     * @brief Copy the course IDs a faculty member is teaching into a caller-provided buffer.
+     *
+     * Does not allocate; intended for hot paths that reuse one buffer per thread.
+     *
+     * @param faculty_id The unique identifier for the faculty member.
+     * @param out Buffer receiving up to @p capacity IDs.
+     * @param capacity Number of elements available in @p out.
+     * @return The total number of IDs, which may exceed @p capacity if the buffer was too small.
+     */
+    std::size_t getFacultyCourses(int faculty_id, int *out, std::size_t capacity) const;
+
+    /**
+     * @brief Read a faculty member's metadata without locking.
+     *
+     * Read through the record's sequence lock. If name_truncated is set, the
+     * full name must be read under the lock via visitFaculty().
+     *
+     * @param faculty_id The unique identifier for the faculty member.
+     * @return A consistent copy of the faculty member's metadata.
+     * @throws std::runtime_error if the faculty member does not exist.
+     */
+    FacultyMetadata getFacultyMetadata(int faculty_id) const;
+
+    /**
+     * @brief Rename a faculty member.
+     * @param faculty_id The unique identifier for the faculty member.
+     * @param name The new name of the faculty member.
+     * @throws std::runtime_error if the faculty member does not exist.
+     */
+    void setFacultyName(int faculty_id, const std::string &name);
+
+    /**
+     * @brief Pre-size storage for an expected number of faculty records.
+     *
+     * Reserves record table and dirty-mark set buckets up front so that
+     * adding up to @p count records does not rehash, and rebuilds the negative-lookup filter for
+     * @p count IDs if it was sized for fewer.
+     *
+     * @param count Expected total number of records.
+     */
+    void reserve(std::size_t count);
+
+    /**
+     * @brief Serialize faculty records to a snapshot stream.
+     *
+     * In Incremental mode only records marked dirty since the last committed
+     * checkpoint are written. Dirty marks are left in place: the caller
+     * passes @p checkpoint to commitSnapshot() once the snapshot is durable,
+     * so a snapshot that fails later loses no marks.
+     *
+     * @param out Stream receiving the serialized records.
+     * @param mode Whether to write every record or only dirty ones.
+     * @param checkpoint Receives the mutation sequence number the snapshot covers.
+     * @return The number of records and bytes written.
+     */
+    SnapshotStats writeSnapshot(std::ostream &out, SnapshotMode mode, std::uint64_t &checkpoint);
+
+    /**
+     * @brief Clear the dirty marks covered by a durable snapshot.
+     *
+     * Marks of records mutated again after the snapshot was written carry a
+     * later sequence number and are kept for the next incremental snapshot.
+     *
+     * @param checkpoint Sequence number returned by writeSnapshot().
+     */
+    void commitSnapshot(std::uint64_t checkpoint);
+
+    /**
+     * @brief Apply serialized faculty records from a snapshot stream.
+     *
+     * Records in the stream replace existing records with the same ID, so a
+     * base image followed by its incremental snapshots restores the latest state.
+     *
+     * @param in Stream holding records written by writeSnapshot().
+     * @return The number of records and bytes read.
+     * @throws std::runtime_error if the stream is malformed.
+     */
+    SnapshotStats loadSnapshot(std::istream &in);
+
+    /**
+     * @brief Get the current version of a faculty record.
+     * @param id The unique identifier for the record.
+     * @return The record's version counter, or 0 if the record does not exist.
+     */
+    std::uint64_t getRecordVersion(int id) const;
+
+    /**
+     * @brief Get statistics for the negative-lookup filter.
+     *
+     * Lookups for faculty IDs that were never added are rejected by the filter
+     * before the shared lock is taken. When an add takes the record count
+     * past the filter's capacity, the filter is rebuilt for twice as many
+     * IDs under the exclusive lock, so the false-positive rate stays near
+     * its design point as the table grows.
+     *
+     * @return A snapshot of the filter counters.
+     */
+    LookupFilterStats getLookupFilterStats() const;
+
+private:
+    friend class UniversityManager;    // locks mtx directly to quiesce writers before fork()
+    friend class ForkedUniversityView; // reads a forked child's image through the *Unlocked methods
+
+    /**
+     * @brief Visit every faculty record without locking.
+     *
+     * Only for a fork()ed child, where no other thread can hold or wait for mtx.
+     *
+     * @param visitor Called once per record, in unspecified order.
+     */
+    void forEachFacultyUnlocked(const std::function<void(const Faculty &)> &visitor) const;
+
+    /**
+     * @brief Visit one faculty record without locking; as forEachFacultyUnlocked().
+     * @param id The unique identifier for the record.
+     * @param visitor Called with the record if it exists.
+     * @return true if the record exists and was visited.
+     */
+    bool visitFacultyUnlocked(int id, const std::function<void(const Faculty &)> &visitor) const;
+
+    /**
+     * @brief Serialize every faculty record without locking or touching dirty marks.
+     *
+     * Only for a fork()ed child, as forEachFacultyUnlocked(). The output is a
+     * Full-mode snapshot that loadSnapshot() accepts.
+     *
+     * @param out Stream receiving the serialized records.
+     * @return The number of records and bytes written.
+     */
+    SnapshotStats writeFullSnapshotUnlocked(std::ostream &out) const;
+
+    /**
+     * @brief Add a course to a faculty member's course set.
+     * @param held Exclusive lock on mtx held by the caller.
+     * @param faculty_id The unique identifier for the faculty member.
+     * @param course_id The course being assigned.
+     * @throws std::runtime_error if the faculty member does not exist; nothing is changed.
+     */
+    void assignCourseLocked(const std::unique_lock<std::shared_timed_mutex> &held, int faculty_id, int course_id);
+
+    /**
+     * @brief Remove a course from a faculty member's course set, if both exist.
+     * @param held Exclusive lock on mtx held by the caller.
+     * @param faculty_id The unique identifier for the faculty member.
+     * @param course_id The course being unassigned.
+     */
+    void unassignCourseLocked(const std::unique_lock<std::shared_timed_mutex> &held, int faculty_id, int course_id);
+
+    /**
+     * @brief Rename a faculty member and republish their metadata.
+     * @param held Exclusive lock on mtx held by the caller.
+     * @param faculty_id The unique identifier for the faculty member.
+     * @param name The new name of the faculty member.
+     * @throws std::runtime_error if the faculty member does not exist; nothing is changed.
+     */
+    void setFacultyNameLocked(const std::unique_lock<std::shared_timed_mutex> &held, int faculty_id, const std::string &name);
+
+    /**
+     * @brief Look up a record; caller holds mtx.
+     * @param id The unique identifier for the record.
+     * @return The record, or nullptr if it does not exist.
+     */
+    Faculty *findRecord(int id) const;
+
+    /**
+     * @brief Look up a record that passed the negative-lookup filter; caller holds mtx.
+     * @param id The unique identifier for the record.
+     * @return The record.
+     * @throws std::runtime_error if the record does not exist, counted as a filter false positive.
+     */
+    Faculty &requireRecord(int id) const;
+
+    /**
+     * @brief Check the negative-lookup filter; called before taking mtx.
+     * @param id The unique identifier for the record.
+     * @return true if the record definitely does not exist.
+     */
+    bool filterRejects(int id) const;
+
+    /**
+     * @brief Add an ID to the negative-lookup filter, rebuilding it first if it is full; caller holds mtx exclusively.
+     * @param id The unique identifier for the record.
+     */
+    void filterInsert(int id);
+
+    /**
+     * @brief Replace the negative-lookup filter with one sized for @p expected_ids holding every current ID; caller holds mtx exclusively.
+     * @param expected_ids Number of IDs the new filter is sized for.
+     */
+    void rebuildFilter(std::size_t expected_ids);
+
+    /**
+     * @brief Mark a record dirty with the next mutation sequence number; caller holds mtx exclusively.
+     * @param id The unique identifier for the record.
+     */
+    void markDirty(int id);
+
+    RecordMap<Faculty> faculty_records; ///< Hash table for faculty records
+    std::unordered_map<int, std::uint64_t> dirty_ids; ///< IDs of records mutated since the last committed checkpoint, with the sequence number of their latest mutation
+    std::uint64_t mutation_sequence = 0; ///< Sequence number of the latest mutation
+    std::atomic<const IdBloomFilter *> id_filter{nullptr}; ///< Current filter of existing IDs, checked before taking mtx; replaced under mtx when full
+    std::vector<std::unique_ptr<IdBloomFilter>> id_filters; ///< Every filter built, current last; replaced ones, together smaller than the current one, stay alive for lookups still reading them
+    mutable std::atomic<std::uint64_t> filter_lookups{0};         ///< Lookups that consulted id_filter
+    mutable std::atomic<std::uint64_t> filter_rejections{0};      ///< Lookups rejected by id_filter
+    mutable std::atomic<std::uint64_t> filter_false_positives{0}; ///< Lookups passed by id_filter but not found
+    mutable std::shared_timed_mutex mtx; ///< Shared mutex for thread safety; timed so calls can honour deadlines
+};
+
+/**
+ * @brief Handle of a temporary seat reservation.
+ */
+using SeatHoldId = std::uint64_t;
+
+/**
+ * @brief Structure to represent a temporary seat reservation.
+ */
+struct SeatHold {
+    int student_id; ///< Student the seat is held for
+    int course_id;  ///< Course the seat is held in
+};
+
+/**
+ * @brief Build statistics of a frozen course catalog.
+ */
+struct CatalogFreezeStats {
+    std::size_t courses = 0;              ///< Courses in the catalog
+    double bits_per_key = 0;              ///< Size of the perfect hash function per course
+    std::chrono::microseconds build_time{0}; ///< Time to build the perfect hash and dense array
+};
+
+/**
+ * @brief Immutable index of a term's course records.
+ *
+ * Holds the courses in a dense array indexed by a MinimalPerfectHash of
+ * their IDs, so a lookup is one hash evaluation, one array probe and one ID
+ * comparison, with no collision chains. The record pointers are shared
+ * with the CourseManager, so rosters and seqlock-protected metadata stay
+ * live; only the set of courses is fixed.
+ */
+class FrozenCourseCatalog {
+public:
+    /**
+     * @brief Build the catalog over a term's courses.
+     * @param courses The course records; IDs must be distinct.
+     */
+    explicit FrozenCourseCatalog(std::vector<std::shared_ptr<Course>> courses)
+        : FrozenCourseCatalog(std::move(courses), std::chrono::steady_clock::now()) {}
+
+    /**
+     * @brief Look up a course.
+     * @param course_id The unique identifier for the course.
+     * @return The course record, or nullptr if the course is not in the catalog.
+     */
+    const std::shared_ptr<Course> *find(int course_id) const {
+        // lookup() maps every ID to some index, including index 0 of an
+        // empty set, so guard the probe before confirming the ID.
+        if (slots.empty()) {
+            return nullptr;
+        }
+        const std::shared_ptr<Course> &slot = slots[hash.lookup(course_id)];
+        return slot->course_id == course_id ? &slot : nullptr;
+    }
+
+    /**
+     * @brief Number of courses in the catalog.
+     * @return The course count.
+     */
+    std::size_t size() const {
+        return slots.size();
+    }
+
+    /**
+     * @brief Get the build statistics of the catalog.
+     * @return Course count, hash size and build time.
+     */
+    CatalogFreezeStats getStats() const {
+        return stats;
+    }
+
+private:
+    FrozenCourseCatalog(std::vector<std::shared_ptr<Course>> courses, std::chrono::steady_clock::time_point start)
+        : hash(courseIds(courses)), slots(courses.size()) {
+        for (std::shared_ptr<Course> &course : courses) {
+            std::size_t index = hash.lookup(course->course_id);
+            slots[index] = std::move(course);
+        }
+        stats.courses = slots.size();
+        stats.bits_per_key = hash.bitsPerKey();
+        stats.build_time = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+    }
+
+    static std::vector<int> courseIds(const std::vector<std::shared_ptr<Course>> &courses) {
+        std::vector<int> ids;
+        ids.reserve(courses.size());
+        for (const std::shared_ptr<Course> &course : courses) {
+            ids.push_back(course->course_id);
+        }
+        return ids;
+    }
+
+    MinimalPerfectHash hash;                     ///< Course ID to dense index
+    std::vector<std::shared_ptr<Course>> slots;  ///< Course records by dense index
+    CatalogFreezeStats stats;                    ///< Build statistics
+};
+
+/**
+ * @brief Class to manage course records.
+ *
+ * Uses std::unordered_map for efficient concurrent storage and retrieval of course records.
+ * std::unordered_map provides average O(1) complexity for insertions, deletions, and look-ups.
+ */
+class CourseManager {
+public:
+    static constexpr std::chrono::milliseconds kHoldTick{100}; ///< Resolution of seat hold expiry
+
+    /**
+     * @brief Add a new course to the system.
+     * @param course_id The unique identifier for the course.
+     * @param name The name of the course.
      * @param faculty_id The unique identifier for the faculty member teaching the course.
+     * @throws std::runtime_error if the catalog is frozen.
      */
     void addCourse(int course_id, const std::string &name, int faculty_id);
 
+    /**
+     * @brief Add a new course to the system, taking ownership of the name.
+     * @param course_id The unique identifier for the course.
+     * @param name The name of the course; moved into the record without copying.
+     * @param faculty_id The unique identifier for the faculty member teaching the course.
+     * @throws std::runtime_error if the catalog is frozen.
+     */
+    void addCourse(int course_id, std::string &&name, int faculty_id);
+
+    /**
+     * @brief Enroll a student in a course without a name for the ByName roster.
+     *
+     * CourseManager has no access to student records, so it cannot find
+     * the name. The student is indexed in roster_by_name under an empty
+     * name, which sorts before every named student. Use the overload that
+     * takes the name; UniversityManager always does.
+     *
+     * @param course_id The unique identifier for the course.
+     * @param student_id The unique identifier for the student.
+     * @throws std::runtime_error if the course does not exist or is full.
+     * @deprecated Pass the student's name so ByName rosters stay ordered.
+     */
+    [[deprecated("pass the student's name so ByName rosters stay ordered")]]
+    void enrollStudent(int course_id, int student_id);
+
+    /**
+     * @brief Enroll a student in a course and index them in the ordered rosters.
+     * @param course_id The unique identifier for the course.
+     * @param student_id The unique identifier for the student.
+     * @param student_name The name of the student, used as the ByName sort key.
+     * @throws std::runtime_error if the course does not exist or is full.
+     */
+    void enrollStudent(int course_id, int student_id, const std::string &student_name);
+
+    /**
+     * @brief Remove a student from a course and its ordered rosters.
+     * @param course_id The unique identifier for the course.
+     * @param student_id The unique identifier for the student.
+     * @throws std::runtime_error if the course does not exist.
+     */
+    void dropStudent(int course_id, int student_id);
+
+    /**
+     * @brief Move a student from one course's roster to another's in one step.
+     *
+     * Both rosters change under a single exclusive lock, after checking that
+     * the target has an open seat, so the student never holds zero or two
+     * seats and a failed swap changes nothing. Equivalent to
+     * checkSwapLocked() followed by swapStudentLocked() under mtx.
+     *
+     * @param student_id The unique identifier for the student.
+     * @param from_course_id The course being dropped.
+     * @param to_course_id The course being added.
+     * @param student_name The name of the student, used as the ByName sort key.
+     * @throws std::runtime_error if either course does not exist, the student is not in @p from_course_id, or @p to_course_id is full.
+     */
+    void swapStudent(int student_id, int from_course_id, int to_course_id, const std::string &student_name);
+
     /**
      * @brief Get the list of students enrolled in a course.
      * @param course_id The unique identifier for the course.
@@ -218,10 +1143,4778 @@ public:
      */
     std::unordered_set<int> getCourseStudents(int course_id) const;
 
-private:
-    StudentManager student_manager; ///< Manager for student records
-    FacultyManager faculty_manager; ///< Manager for faculty records
-    CourseManager course_manager;   ///< Manager for course records
-};
+    /**
+     * @brief Check whether a student is enrolled in a course.
+     * @param course_id The unique identifier for the course.
+     * @param student_id The unique identifier for the student.
+     * @return true if the course exists and the student is enrolled in it.
+     */
+    bool isEnrolled(int course_id, int student_id) const;
+
+    /**
+     * @brief Get the faculty member teaching a course.
+     * @param course_id The unique identifier for the course.
+     * @return The faculty member's ID.
+     * @throws std::runtime_error if the course does not exist.
+     */
+    int getCourseFaculty(int course_id) const;
+
+    /**
+     * @brief Read a course's metadata without contending with roster changes.
+     *
+     * The fields are copied through the course's sequence lock, so the copy
+     * itself never waits for a writer. Finding the record does take the
+     * shared lock briefly with the default and incremental backends, so the
+     * call can wait behind a writer's critical section for that lookup. With
+     * UNIVERSITY_LOCKFREE_RECORDS the lookup takes no lock either. If
+     * name_truncated is set, the full name is available from getCourseName().
+     *
+     * @param course_id The unique identifier for the course.
+     * @return A consistent copy of the course's metadata.
+     * @throws std::runtime_error if the course does not exist.
+     */
+    CourseMetadata getCourseMetadata(int course_id) const;
+
+    /**
+     * @brief Get the full name of a course.
+     * @param course_id The unique identifier for the course.
+     * @return The course's name.
+     * @throws std::runtime_error if the course does not exist.
+     */
+    std::string getCourseName(int course_id) const;
+
+    /**
+     * @brief Rename a course.
+     * @param course_id The unique identifier for the course.
+     * @param name The new name of the course.
+     * @throws std::runtime_error if the course does not exist.
+     */
+    void setCourseName(int course_id, const std::string &name);
+
+    /**
+     * @brief Change the faculty member teaching a course.
+     * @param course_id The unique identifier for the course.
+     * @param faculty_id The unique identifier for the faculty member.
+     * @throws std::runtime_error if the course does not exist.
+     */
+    void setCourseFaculty(int course_id, int faculty_id);
+
+    /**
+     * @brief Set the seat capacity of a course.
+     *
+     * Enrollments and holds beyond the capacity are rejected. Existing
+     * enrollments and holds are kept even if they now exceed it; the course
+     * then reports 0 open seats until enough of them are dropped, released
+     * or expired.
+     *
+     * @param course_id The unique identifier for the course.
+     * @param capacity Maximum number of enrolled students, 0 for unlimited.
+     * @throws std::runtime_error if the course does not exist.
+     */
+    void setCourseCapacity(int course_id, int capacity);
+
+    /**
+     * @brief Get the seat capacity of a course.
+     * @param course_id The unique identifier for the course.
+     * @return Maximum number of enrolled students, 0 for unlimited.
+     * @throws std::runtime_error if the course does not exist.
+     */
+    int getCourseCapacity(int course_id) const;
+
+    /**
+     * @brief Get the number of seats still available in a course.
+     *
+     * Holds past their time-to-live are expired first (see holdSeat()), so
+     * they are never counted.
+     *
+     * @param course_id The unique identifier for the course.
+     * @return capacity - enrolled - held, clamped at 0, or INT_MAX if the course has unlimited capacity.
+     * @throws std::runtime_error if the course does not exist.
+     */
+    int getOpenSeats(int course_id) const;
+
+    /**
+     * @brief Set the section family and weekly meeting times of a course.
+     * @param course_id The unique identifier for the course.
+     * @param family_id ID shared by all sections of the same catalog course.
+     * @param meetings Weekly meeting times of the section.
+     * @throws std::runtime_error if the course does not exist.
+     */
+    void setCourseSchedule(int course_id, int family_id, const MeetingMask &meetings);
+
+    /**
+     * @brief Get the weekly meeting times of a course.
+     * @param course_id The unique identifier for the course.
+     * @return The meeting mask, empty if none was set.
+     * @throws std::runtime_error if the course does not exist.
+     */
+    MeetingMask getCourseMeetings(int course_id) const;
+
+    /**
+     * @brief Get the sections of a catalog course.
+     * @param family_id ID shared by the sections.
+     * @return Course IDs of the sections, empty if the family is unknown.
+     */
+    std::vector<int> getFamilySections(int family_id) const;
+
+    /**
+     * @brief Find sibling sections of a course that have open seats and fit a schedule.
+     *
+     * Served from the per-family index of sections with open seats, which is
+     * updated whenever enrollments, holds or capacity change, so the query
+     * touches only the course's open siblings rather than the catalog.
+     * Holds past their time-to-live are expired first, so a section kept
+     * full only by stale holds is listed as open.
+     *
+     * @param course_id The unique identifier for the (typically full) course.
+     * @param busy Meeting times already taken by the student's other courses.
+     * @return Course IDs of open, non-conflicting sibling sections, fewest meeting slots first.
+     * @throws std::runtime_error if the course does not exist.
+     */
+    std::vector<int> findOpenSiblings(int course_id, const MeetingMask &busy) const;
+
+    /**
+     * @brief Reserve a seat in a course for a limited time.
+     *
+     * The seat counts against capacity until the hold is confirmed,
+     * released, or expires. Expiry is scheduled on a hierarchical timing
+     * wheel with kHoldTick resolution, so creating, cancelling and expiring
+     * a hold are all O(1).
+     *
+     * Expiry does not depend on expireHolds() being called. holdSeat(),
+     * releaseHold() and confirmHold() advance the wheel to the current tick
+     * under the exclusive lock before acting, so an expired hold's seat is
+     * returned before a new hold is checked against capacity, and an expired
+     * hold can be neither released nor confirmed. Queries that count seats
+     * find the wheel behind the clock under the shared lock, switch to the
+     * exclusive lock to advance it, and then answer.
+     *
+     * @param course_id The unique identifier for the course.
+     * @param student_id The unique identifier for the student.
+     * @param ttl How long the seat is held.
+     * @return Handle of the hold.
+     * @throws std::runtime_error if the course does not exist or has no open seat.
+     */
+    SeatHoldId holdSeat(int course_id, int student_id, std::chrono::milliseconds ttl);
+
+    /**
+     * @brief Release a hold early, returning its seat.
+     * @param hold Handle returned by holdSeat().
+     * @return true if the hold was still active.
+     */
+    bool releaseHold(SeatHoldId hold);
+
+    /**
+     * @brief Convert a hold into an enrollment using the held seat.
+     *
+     * The held seat is moved to the roster under one exclusive lock, so the
+     * seat cannot be taken by another student in between.
+     *
+     * @param hold Handle returned by holdSeat().
+     * @param student_name The name of the student, used as the ByName sort key.
+     * @return The hold that was confirmed.
+     * @throws std::runtime_error if the hold has expired or was released.
+     */
+    SeatHold confirmHold(SeatHoldId hold, const std::string &student_name);
+
+    /**
+     * @brief Expire every hold whose time-to-live has passed, returning the seats.
+     * @return Number of holds expired.
+     */
+    std::size_t expireHolds();
+
+    /**
+     * @brief Get the IDs of all courses.
+     * @return A vector of course IDs in unspecified order.
+     */
+    std::vector<int> getCourseIds() const;
+
+    /**
+     * @brief Visit every course record in place under the shared lock.
+     *
+     * The visitor must not call back into this manager.
+     *
+     * @param visitor Called once per record, in unspecified order.
+     */
+    void forEachCourse(const std::function<void(const Course &)> &visitor) const;
+
+    /**
+     * @brief Visit one course record in place under the shared lock.
+     * @param id The unique identifier for the record.
+     * @param visitor Called with the record if it exists.
+     * @return true if the record exists and was visited.
+     */
+    bool visitCourse(int id, const std::function<void(const Course &)> &visitor) const;
+
+    /**
+     * @brief Copy the student IDs enrolled in a course into a caller-provided buffer.
+     *
+     * Does not allocate; intended for hot paths that reuse one buffer per thread.
+     *
+     * @param course_id The unique identifier for the course.
+     * @param out Buffer receiving up to @p capacity IDs.
+     * @param capacity Number of elements available in @p out.
+     * @return The total number of IDs, which may exceed @p capacity if the buffer was too small.
+     */
+    std::size_t getCourseStudents(int course_id, int *out, std::size_t capacity) const;
+
+    /**
+     * @brief Pre-size storage for an expected number of course records.
+     *
+     * Reserves record table and dirty-mark set buckets up front so that
+     * adding up to @p count records does not rehash, and rebuilds the negative-lookup filter for
+     * @p count IDs if it was sized for fewer.
+     *
+     * @param count Expected total number of records.
+     */
+    void reserve(std::size_t count);
+
+    /**
+     * @brief Get one page of a course roster in a stable order.
+     *
+     * Served from the course's ordered roster index: the page starts with a
+     * lower_bound on the cursor, so a page costs O(log n + page_size) instead
+     * of copying and sorting the whole roster.
+     *
+     * @param course_id The unique identifier for the course.
+     * @param order The sort order of the roster.
+     * @param after Cursor returned with the previous page, or a default cursor for the first page.
+     * @param page_size Maximum number of students to return.
+     * @return The requested page and the cursor for the next one.
+     * @throws std::runtime_error if the course does not exist.
+     */
+    RosterPage getCourseRoster(int course_id, RosterOrder order, const RosterCursor &after, std::size_t page_size) const;
+
+    /**
+     * @brief Serialize course records to a snapshot stream.
+     *
+     * Each record carries its family_id and meetings along with the roster,
+     * capacity and metadata; setCourseSchedule() marks the course dirty like
+     * any other mutation. Holds are not written.
+     *
+     * In Incremental mode only records marked dirty since the last committed
+     * checkpoint are written. Dirty marks are left in place: the caller
+     * passes @p checkpoint to commitSnapshot() once the snapshot is durable,
+     * so a snapshot that fails later loses no marks.
+     *
+     * @param out Stream receiving the serialized records.
+     * @param mode Whether to write every record or only dirty ones.
+     * @param checkpoint Receives the mutation sequence number the snapshot covers.
+     * @return The number of records and bytes written.
+     */
+    SnapshotStats writeSnapshot(std::ostream &out, SnapshotMode mode, std::uint64_t &checkpoint);
+
+    /**
+     * @brief Clear the dirty marks covered by a durable snapshot.
+     *
+     * Marks of records mutated again after the snapshot was written carry a
+     * later sequence number and are kept for the next incremental snapshot.
+     *
+     * @param checkpoint Sequence number returned by writeSnapshot().
+     */
+    void commitSnapshot(std::uint64_t checkpoint);
+
+    /**
+     * @brief Apply serialized course records from a snapshot stream.
+     *
+     * Records in the stream replace existing records with the same ID, so a
+     * base image followed by its incremental snapshots restores the latest state.
+     * family_sections and family_open_sections are updated for every record
+     * applied, including one that moves a section to another family, so
+     * findOpenSiblings() works after a restore. Restored courses hold no
+     * seats for holds.
+     *
+     * @param in Stream holding records written by writeSnapshot().
+     * @return The number of records and bytes read.
+     * @throws std::runtime_error if the stream is malformed.
+     */
+    SnapshotStats loadSnapshot(std::istream &in);
+
+    /**
+     * @brief Get the current version of a course record.
+     * @param id The unique identifier for the record.
+     * @return The record's version counter, or 0 if the record does not exist.
+     */
+    std::uint64_t getRecordVersion(int id) const;
+
+    /**
+     * @brief Get statistics for the negative-lookup filter.
+     *
+     * Lookups for course IDs that were never added are rejected by the filter
+     * before the shared lock is taken. When an add takes the record count
+     * past the filter's capacity, the filter is rebuilt for twice as many
+     * IDs under the exclusive lock, so the false-positive rate stays near
+     * its design point as the table grows.
+     *
+     * @return A snapshot of the filter counters.
+     */
+    LookupFilterStats getLookupFilterStats() const;
+
+    /**
+     * @brief Freeze the set of courses for the term.
+     *
+     * Builds a FrozenCourseCatalog over the current courses; while frozen,
+     * course lookups go through the catalog and addCourse() is rejected.
+     *
+     * @return Build statistics of the catalog.
+     */
+    CatalogFreezeStats freezeCatalog();
+
+    /**
+     * @brief Drop the frozen catalog so courses can be added again.
+     */
+    void thawCatalog();
+
+private:
+    friend class UniversityManager;    // locks mtx directly to quiesce writers before fork()
+    friend class ForkedUniversityView; // reads a forked child's image through the *Unlocked methods
+
+    /**
+     * @brief Visit every course record without locking.
+     *
+     * Only for a fork()ed child, where no other thread can hold or wait for mtx.
+     *
+     * @param visitor Called once per record, in unspecified order.
+     */
+    void forEachCourseUnlocked(const std::function<void(const Course &)> &visitor) const;
+
+    /**
+     * @brief Visit one course record without locking; as forEachCourseUnlocked().
+     * @param id The unique identifier for the record.
+     * @param visitor Called with the record if it exists.
+     * @return true if the record exists and was visited.
+     */
+    bool visitCourseUnlocked(int id, const std::function<void(const Course &)> &visitor) const;
+
+    /**
+     * @brief Serialize every course record without locking or touching dirty marks.
+     *
+     * Only for a fork()ed child, as forEachCourseUnlocked(). The output is a
+     * Full-mode snapshot that loadSnapshot() accepts.
+     *
+     * @param out Stream receiving the serialized records.
+     * @return The number of records and bytes written.
+     */
+    SnapshotStats writeFullSnapshotUnlocked(std::ostream &out) const;
+
+    /**
+     * @brief Check that swapStudentLocked() will succeed.
+     *
+     * Advances the hold wheel first, so holds past their time-to-live do
+     * not count against the target's capacity.
+     *
+     * @param held Exclusive lock on mtx held by the caller.
+     * @param student_id The unique identifier for the student.
+     * @param from_course_id The course being dropped.
+     * @param to_course_id The course being added.
+     * @throws std::runtime_error if either course does not exist, the student is not in @p from_course_id, or @p to_course_id is full.
+     */
+    void checkSwapLocked(const std::unique_lock<std::shared_timed_mutex> &held, int student_id, int from_course_id, int to_course_id) const;
+
+    /**
+     * @brief Move a student between rosters after checkSwapLocked() passed.
+     *
+     * Runs under the same lock as the check, so it performs no validation
+     * and cannot fail on one. Updates both rosters, the version counters,
+     * the dirty marks and family_open_sections.
+     *
+     * @param held Exclusive lock on mtx held by the caller.
+     * @param student_id The unique identifier for the student.
+     * @param from_course_id The course being dropped.
+     * @param to_course_id The course being added.
+     * @param student_name The name of the student, used as the ByName sort key.
+     */
+    void swapStudentLocked(const std::unique_lock<std::shared_timed_mutex> &held, int student_id, int from_course_id, int to_course_id, const std::string &student_name);
+
+    /**
+     * @brief Current hold tick by the clock.
+     * @return Whole kHoldTick periods since hold_epoch.
+     */
+    std::uint64_t currentHoldTick() const;
+
+    /**
+     * @brief Expire holds up to the current tick; caller holds mtx exclusively.
+     *
+     * Returns each expired hold's seat and puts its course back in
+     * family_open_sections.
+     *
+     * @param on_expire Called with each expired hold, e.g. to log it; may be empty.
+     * @return Number of holds expired.
+     */
+    std::size_t advanceHolds(const std::function<void(const SeatHold &)> &on_expire = nullptr) const;
+
+    /**
+     * @brief Whether holds may have expired since the wheel was last advanced; caller holds mtx.
+     * @return true if the wheel has pending holds and is behind the clock.
+     */
+    bool holdsBehind() const;
+
+    /**
+     * @brief Check that enrollStudentLocked() will succeed.
+     *
+     * Advances the hold wheel first, so holds past their time-to-live do
+     * not count against the course's capacity.
+     *
+     * @param held Exclusive lock on mtx held by the caller.
+     * @param course_id The unique identifier for the course.
+     * @param student_id The unique identifier for the student.
+     * @throws std::runtime_error if the course does not exist, the student is already enrolled, or the course is full.
+     */
+    void checkEnrollLocked(const std::unique_lock<std::shared_timed_mutex> &held, int course_id, int student_id) const;
+
+    /**
+     * @brief Add a student to a course and its ordered rosters after checkEnrollLocked() passed.
+     *
+     * Also used by write-ahead log replay, which applies logged enrollments
+     * without re-validating them.
+     *
+     * @param held Exclusive lock on mtx held by the caller.
+     * @param course_id The unique identifier for the course.
+     * @param student_id The unique identifier for the student.
+     * @param student_name The name of the student, used as the ByName sort key.
+     */
+    void enrollStudentLocked(const std::unique_lock<std::shared_timed_mutex> &held, int course_id, int student_id, const std::string &student_name);
+
+    /**
+     * @brief Remove a student from a course and its ordered rosters.
+     * @param held Exclusive lock on mtx held by the caller.
+     * @param course_id The unique identifier for the course.
+     * @param student_id The unique identifier for the student.
+     * @param student_name The name the student was enrolled under; if no ByName entry matches, the entry is found by ID with a roster scan.
+     * @return true if the student was enrolled in the course.
+     * @throws std::runtime_error if the course does not exist; nothing is changed.
+     */
+    bool dropStudentLocked(const std::unique_lock<std::shared_timed_mutex> &held, int course_id, int student_id, const std::string &student_name);
+
+    /**
+     * @brief Rename a course and republish its metadata.
+     * @param held Exclusive lock on mtx held by the caller.
+     * @param course_id The unique identifier for the course.
+     * @param name The new name of the course.
+     * @throws std::runtime_error if the course does not exist; nothing is changed.
+     */
+    void setCourseNameLocked(const std::unique_lock<std::shared_timed_mutex> &held, int course_id, const std::string &name);
+
+    /**
+     * @brief Change a course's faculty member and republish its metadata.
+     * @param held Exclusive lock on mtx held by the caller.
+     * @param course_id The unique identifier for the course.
+     * @param faculty_id The unique identifier for the faculty member.
+     * @return The previous faculty member's ID.
+     * @throws std::runtime_error if the course does not exist; nothing is changed.
+     */
+    int setCourseFacultyLocked(const std::unique_lock<std::shared_timed_mutex> &held, int course_id, int faculty_id);
+
+    /**
+     * @brief Change a course's capacity and republish its metadata.
+     * @param held Exclusive lock on mtx held by the caller.
+     * @param course_id The unique identifier for the course.
+     * @param capacity Maximum number of enrolled students, 0 for unlimited.
+     * @throws std::runtime_error if the course does not exist or @p capacity is negative; nothing is changed.
+     */
+    void setCourseCapacityLocked(const std::unique_lock<std::shared_timed_mutex> &held, int course_id, int capacity);
+
+    /**
+     * @brief Move a course to a section family and set its meeting times.
+     * @param held Exclusive lock on mtx held by the caller.
+     * @param course_id The unique identifier for the course.
+     * @param family_id ID shared by all sections of the same catalog course, -1 for none.
+     * @param meetings Weekly meeting times of the section.
+     * @throws std::runtime_error if the course does not exist; nothing is changed.
+     */
+    void setCourseScheduleLocked(const std::unique_lock<std::shared_timed_mutex> &held, int course_id, int family_id, const MeetingMask &meetings);
+
+    /**
+     * @brief Reserve a seat after advancing the wheel, so expired holds do not count against capacity.
+     * @param held Exclusive lock on mtx held by the caller.
+     * @param course_id The unique identifier for the course.
+     * @param student_id The unique identifier for the student.
+     * @param ttl How long the seat is held.
+     * @return Handle of the hold.
+     * @throws std::runtime_error if the course does not exist or has no open seat; nothing is changed.
+     */
+    SeatHoldId holdSeatLocked(const std::unique_lock<std::shared_timed_mutex> &held, int course_id, int student_id, std::chrono::milliseconds ttl);
+
+    /**
+     * @brief Find an active hold after advancing the wheel, so an expired hold is never found.
+     * @param held Exclusive lock on mtx held by the caller.
+     * @param hold Handle returned by holdSeat().
+     * @return The hold, or nullptr if it has expired or was released; valid until the wheel next changes.
+     */
+    const SeatHold *findHoldLocked(const std::unique_lock<std::shared_timed_mutex> &held, SeatHoldId hold) const;
+
+    /**
+     * @brief Move a hold's seat to the roster after findHoldLocked() found it.
+     * @param held Exclusive lock on mtx held by the caller.
+     * @param hold Handle returned by holdSeat().
+     * @param student_name The name of the student, used as the ByName sort key.
+     * @return The hold that was confirmed.
+     */
+    SeatHold confirmHoldLocked(const std::unique_lock<std::shared_timed_mutex> &held, SeatHoldId hold, const std::string &student_name);
+
+    /**
+     * @brief Release a hold, returning its seat.
+     * @param held Exclusive lock on mtx held by the caller.
+     * @param hold Handle returned by holdSeat().
+     * @param released Receives the hold if it was still active.
+     * @return true if the hold was still active.
+     */
+    bool releaseHoldLocked(const std::unique_lock<std::shared_timed_mutex> &held, SeatHoldId hold, SeatHold &released);
+
+    /**
+     * @brief Add or remove a course in family_open_sections to match its open seats; caller holds mtx exclusively.
+     * @param course The course record.
+     */
+    void refreshOpenSection(const Course &course) const;
+
+    /**
+     * @brief Move a course between the family_sections and family_open_sections indexes; caller holds mtx exclusively.
+     *
+     * Leaves the course out of the new family's open set; call
+     * refreshOpenSection() afterwards.
+     *
+     * @param course The course record; its family_id is updated.
+     * @param family_id ID of the new family, -1 for none.
+     */
+    void moveToFamily(Course &course, int family_id);
+
+    /**
+     * @brief Extract a student's entry from a course's ByName roster; caller holds mtx exclusively.
+     * @param course The course record.
+     * @param student_id The unique identifier for the student.
+     * @param student_name The name the student was enrolled under; if no entry matches, the roster is scanned for the ID.
+     * @return The entry's node, empty if the student is not on the roster.
+     */
+    std::set<std::pair<std::string, int>>::node_type extractRosterName(Course &course, int student_id, const std::string &student_name);
+
+    /**
+     * @brief Look up a record, through the frozen catalog while there is one; caller holds mtx.
+     * @param id The unique identifier for the record.
+     * @return The record, or nullptr if it does not exist.
+     */
+    Course *findRecord(int id) const;
+
+    /**
+     * @brief Look up a record that passed the negative-lookup filter; caller holds mtx.
+     * @param id The unique identifier for the record.
+     * @return The record.
+     * @throws std::runtime_error if the record does not exist, counted as a filter false positive.
+     */
+    Course &requireRecord(int id) const;
+
+    /**
+     * @brief Check the negative-lookup filter; called before taking mtx.
+     * @param id The unique identifier for the record.
+     * @return true if the record definitely does not exist.
+     */
+    bool filterRejects(int id) const;
+
+    /**
+     * @brief Add an ID to the negative-lookup filter, rebuilding it first if it is full; caller holds mtx exclusively.
+     * @param id The unique identifier for the record.
+     */
+    void filterInsert(int id);
+
+    /**
+     * @brief Replace the negative-lookup filter with one sized for @p expected_ids holding every current ID; caller holds mtx exclusively.
+     * @param expected_ids Number of IDs the new filter is sized for.
+     */
+    void rebuildFilter(std::size_t expected_ids);
+
+    /**
+     * @brief Mark a record dirty with the next mutation sequence number; caller holds mtx exclusively.
+     * @param id The unique identifier for the record.
+     */
+    void markDirty(int id);
+
+    RecordMap<Course> course_records; ///< Hash table for course records
+    mutable std::vector<std::unordered_set<int>::node_type> spare_id_nodes; ///< Nodes of dropped roster and open-section entries, reused by later inserts; at most kSpareNodeLimit
+    std::vector<std::set<int>::node_type> spare_roster_id_nodes; ///< Nodes of dropped ById roster entries; at most kSpareNodeLimit
+    std::vector<std::set<std::pair<std::string, int>>::node_type> spare_roster_name_nodes; ///< Nodes of dropped ByName roster entries, names keeping their capacity; at most kSpareNodeLimit
+    std::pair<std::string, int> roster_key; ///< Reused ByName lookup key, so a drop does not copy the name
+    std::unordered_map<int, std::uint64_t> dirty_ids; ///< IDs of records mutated since the last committed checkpoint, with the sequence number of their latest mutation
+    std::uint64_t mutation_sequence = 0; ///< Sequence number of the latest mutation
+    std::atomic<const IdBloomFilter *> id_filter{nullptr}; ///< Current filter of existing IDs, checked before taking mtx; replaced under mtx when full
+    std::vector<std::unique_ptr<IdBloomFilter>> id_filters; ///< Every filter built, current last; replaced ones, together smaller than the current one, stay alive for lookups still reading them
+    mutable std::atomic<std::uint64_t> filter_lookups{0};         ///< Lookups that consulted id_filter
+    mutable std::atomic<std::uint64_t> filter_rejections{0};      ///< Lookups rejected by id_filter
+    mutable std::atomic<std::uint64_t> filter_false_positives{0}; ///< Lookups passed by id_filter but not found
+    std::shared_ptr<const FrozenCourseCatalog> frozen_catalog; ///< Term catalog while frozen, null otherwise
+    std::unordered_map<int, std::vector<int>> family_sections; ///< Section course IDs by family ID
+    mutable std::unordered_map<int, std::unordered_set<int>> family_open_sections; ///< Sections with at least one open seat, by family ID; mutable because advanceHolds() reopens sections
+    mutable TimingWheel<SeatHold> hold_wheel; ///< Expiry schedule of active holds, in kHoldTick ticks since hold_epoch; advanced lazily by advanceHolds()
+    std::chrono::steady_clock::time_point hold_epoch = std::chrono::steady_clock::now(); ///< Time of tick 0
+    mutable std::shared_timed_mutex mtx; ///< Shared mutex for thread safety; timed so calls can honour deadlines
+};
+
+class BillingEngine;
+class TraceRecorder;
+
+/**
+ * @brief Read operations subject to authorization.
+ */
+enum class AccessAction {
+    ReadRoster,         ///< getCourseStudents / getCourseRoster on a course
+    ReadFacultySchedule ///< getFacultyCourses on a faculty member
+};
+
+/**
+ * @brief Hit statistics for the authorization decision table.
+ */
+struct AccessStats {
+    std::uint64_t checks = 0;       ///< Authorization checks performed
+    std::uint64_t cached = 0;       ///< Checks answered from the decision table
+    std::uint64_t denied = 0;       ///< Checks that were denied
+    std::uint64_t invalidations = 0; ///< Decision-table entries dropped by invalidate(), grantAdmin() or revokeAdmin()
+    std::uint64_t evictions = 0;    ///< Decision-table entries evicted by the CLOCK policy
+};
+
+/**
+ * @brief Class to evaluate relationship-based read permissions.
+ *
+ * A requester may read a course roster if they are an administrator or the
+ * faculty member assigned to the course (Course::faculty_id or a course in
+ * Faculty::courses), and a faculty schedule if they are an administrator or
+ * that faculty member. Decisions are memoized per (requester, action,
+ * target); assignCourse(), setCourseFaculty(), grantAdmin() and
+ * revokeAdmin() drop only the entries for the affected users, so the table
+ * never serves a stale grant or denial. A decision computed before such an
+ * invalidation is not stored (see generation()).
+ *
+ * The table holds at most max_decisions entries on a CLOCK (second-chance)
+ * ring allocated once at construction, so a client probing many targets
+ * evicts cold decisions instead of growing memory. An evicted decision is
+ * recomputed on its next check.
+ * The mutex is timed, so calls made inside a DeadlineScope throw
+ * DeadlineExceeded instead of waiting past the deadline.
+ */
+class AccessControl {
+public:
+    /**
+     * @brief Construct an empty registry.
+     * @param max_decisions Most memoized decisions held at once.
+     */
+    explicit AccessControl(std::size_t max_decisions = 1 << 16);
+
+    /**
+     * @brief Grant administrator rights to a user and drop their cached decisions.
+     * @param user_id The unique identifier for the user.
+     */
+    void grantAdmin(int user_id);
+
+    /**
+     * @brief Revoke administrator rights from a user and drop their cached decisions.
+     * @param user_id The unique identifier for the user.
+     */
+    void revokeAdmin(int user_id);
+
+    /**
+     * @brief Check whether a user is an administrator.
+     * @param user_id The unique identifier for the user.
+     * @return true if the user has administrator rights.
+     */
+    bool isAdmin(int user_id) const;
+
+    /**
+     * @brief Look up a memoized decision.
+     * @param requester_id The unique identifier for the requesting user.
+     * @param action The requested action.
+     * @param target_id The course or faculty ID the action applies to.
+     * @param allowed Receives the decision if one is cached.
+     * @return true if a decision was cached.
+     */
+    bool findDecision(int requester_id, AccessAction action, int target_id, bool &allowed) const;
+
+    /**
+     * @brief Current invalidation generation.
+     *
+     * Read before computing a decision and pass to storeDecision(), which
+     * drops the decision if an invalidation happened in between.
+     * @return A counter bumped by every invalidation.
+     */
+    std::uint64_t generation() const;
+
+    /**
+     * @brief Memoize a decision.
+     * @param requester_id The unique identifier for the requesting user.
+     * @param action The requested action.
+     * @param target_id The course or faculty ID the action applies to.
+     * @param allowed The decision.
+     * @param computed_at generation() read before the decision was computed.
+     */
+    void storeDecision(int requester_id, AccessAction action, int target_id, bool allowed, std::uint64_t computed_at);
+
+    /**
+     * @brief Drop every cached decision for a requester.
+     * @param requester_id The unique identifier for the requesting user.
+     */
+    void invalidate(int requester_id);
+
+    /**
+     * @brief Get authorization statistics.
+     * @return A snapshot of the counters.
+     */
+    AccessStats getStats() const;
+
+private:
+    /**
+     * @brief One memoized decision on the CLOCK ring.
+     *
+     * Not movable because of the atomic, so the ring is a fixed array
+     * rather than a std::vector.
+     */
+    struct Decision {
+        int requester_id = 0;    ///< Requesting user
+        std::uint64_t key = 0;   ///< (action, target) key
+        bool allowed = false;    ///< The decision
+        bool live = false;       ///< Whether the slot holds a decision indexed in decisions
+        mutable std::atomic<bool> referenced{false}; ///< Second-chance bit, set by lookups under the shared lock
+    };
+
+    /**
+     * @brief Drop every cached decision for a requester; caller holds mtx exclusively.
+     */
+    void invalidateLocked(int requester_id);
+
+    std::unordered_set<int> admins; ///< IDs of users with administrator rights
+    std::size_t max_decisions;      ///< Bound on ring size
+    std::unique_ptr<Decision[]> ring; ///< CLOCK ring of memoized decisions, max_decisions slots
+    std::size_t ring_used = 0;      ///< Slots filled at least once; the hand only runs once the ring is full
+    std::unordered_map<int, std::unordered_map<std::uint64_t, std::size_t>> decisions; ///< Per requester: (action, target) key to ring position
+    std::size_t hand = 0;           ///< Current CLOCK hand position
+    std::atomic<std::uint64_t> invalidation_generation{0}; ///< Bumped by every invalidation, under mtx
+    mutable std::atomic<std::uint64_t> check_count{0};        ///< Authorization checks performed
+    mutable std::atomic<std::uint64_t> cached_count{0};       ///< Checks answered from the ring
+    mutable std::atomic<std::uint64_t> denied_count{0};       ///< Checks that were denied
+    std::atomic<std::uint64_t> invalidation_count{0};         ///< Entries dropped by invalidate()
+    std::atomic<std::uint64_t> eviction_count{0};             ///< Entries evicted by the CLOCK hand
+    mutable std::shared_timed_mutex mtx; ///< Shared mutex for thread safety; timed so calls can honour deadlines
+};
+
+/**
+ * @brief Queries whose results can be held in the result cache.
+ */
+enum class CachedQuery {
+    StudentCourses, ///< getStudentCourses, keyed by student ID
+    FacultyCourses, ///< getFacultyCourses, keyed by faculty ID
+    CourseStudents  ///< getCourseStudents, keyed by course ID
+};
+
+/**
+ * @brief Hit and memory statistics for the query-result cache.
+ */
+struct ResultCacheStats {
+    std::uint64_t hits = 0;         ///< Lookups answered from the cache
+    std::uint64_t misses = 0;       ///< Lookups that had no entry
+    std::uint64_t invalidations = 0; ///< Entries found stale because the record version changed
+    std::uint64_t evictions = 0;    ///< Entries evicted by the CLOCK policy
+    std::size_t entries = 0;        ///< Entries currently held
+    std::size_t bytes = 0;          ///< Approximate memory held by cached results
+    std::size_t max_bytes = 0;      ///< Configured memory bound
+};
+
+/**
+ * @brief Bounded cache of immutable query results.
+ *
+ * Each entry stores the result together with the version of the record it
+ * was computed from. A lookup that finds an entry with an older version
+ * treats it as a miss, so a mutation only invalidates results for the record
+ * it touched. Memory is bounded by a CLOCK (second-chance) eviction policy.
+ */
+class QueryResultCache {
+public:
+    using Result = std::shared_ptr<const std::vector<int>>; ///< Immutable cached result
+
+    /**
+     * @brief Construct a cache bounded to approximately @p max_bytes of results.
+     * @param max_bytes Memory bound for cached results.
+     */
+    explicit QueryResultCache(std::size_t max_bytes);
+
+    /**
+     * @brief Look up a cached result.
+     * @param query The query kind.
+     * @param id The record ID the query is keyed by.
+     * @param version The current version of that record.
+     * @return The cached result, or nullptr if absent or stale.
+     */
+    Result find(CachedQuery query, int id, std::uint64_t version);
+
+    /**
+     * @brief Store a result, evicting older entries if over the memory bound.
+     * @param query The query kind.
+     * @param id The record ID the query is keyed by.
+     * @param version The version of the record the result was computed from.
+     * @param result The result to cache.
+     */
+    void insert(CachedQuery query, int id, std::uint64_t version, Result result);
+
+    /**
+     * @brief Get cache statistics.
+     * @return A snapshot of the cache counters.
+     */
+    ResultCacheStats getStats() const;
+
+private:
+    /**
+     * @brief One cache slot on the CLOCK ring.
+     */
+    struct Slot {
+        CachedQuery query;      ///< Query kind
+        int id;                 ///< Record ID
+        std::uint64_t version;  ///< Record version the result was computed from
+        Result result;          ///< Cached result
+        bool referenced;        ///< Second-chance bit for the CLOCK hand
+    };
+
+    std::vector<Slot> slots;                          ///< CLOCK ring of cache slots
+    std::unordered_map<std::uint64_t, std::size_t> index; ///< (query, id) key to slot position
+    std::vector<std::size_t> free_slots;              ///< Positions of evicted slots, reused before the ring grows
+    std::size_t hand = 0;                             ///< Current CLOCK hand position
+    ResultCacheStats stats;                           ///< Cache counters
+    mutable std::mutex mtx;                           ///< Mutex for thread safety
+};
+
+/**
+ * @brief Read-only, lock-free view of a university inside a fork()ed child.
+ *
+ * Passed to UniversityManager::forkAnalyze() jobs. The child is a
+ * single-threaded copy-on-write image taken while every manager lock was
+ * held, so the view reads the managers without locking and without
+ * touching the locks the child inherited in the held state.
+ */
+class ForkedUniversityView {
+public:
+    /**
+     * @brief Visit every student record.
+     * @param visitor Called once per record, in unspecified order.
+     */
+    void forEachStudent(const std::function<void(const Student &)> &visitor) const;
+
+    /**
+     * @brief Visit one student record.
+     * @param id The unique identifier for the record.
+     * @param visitor Called with the record if it exists.
+     * @return true if the record exists and was visited.
+     */
+    bool visitStudent(int id, const std::function<void(const Student &)> &visitor) const;
+
+    /**
+     * @brief Visit every faculty record.
+     * @param visitor Called once per record, in unspecified order.
+     */
+    void forEachFaculty(const std::function<void(const Faculty &)> &visitor) const;
+
+    /**
+     * @brief Visit one faculty record.
+     * @param id The unique identifier for the record.
+     * @param visitor Called with the record if it exists.
+     * @return true if the record exists and was visited.
+     */
+    bool visitFaculty(int id, const std::function<void(const Faculty &)> &visitor) const;
+
+    /**
+     * @brief Visit every course record.
+     * @param visitor Called once per record, in unspecified order.
+     */
+    void forEachCourse(const std::function<void(const Course &)> &visitor) const;
+
+    /**
+     * @brief Visit one course record.
+     * @param id The unique identifier for the record.
+     * @param visitor Called with the record if it exists.
+     * @return true if the record exists and was visited.
+     */
+    bool visitCourse(int id, const std::function<void(const Course &)> &visitor) const;
+
+    /**
+     * @brief Write a full snapshot of the image, as UniversityManager::saveSnapshot() in Full mode.
+     * @param out Stream receiving the student, faculty and course sections in that order.
+     * @return Totals over the three managers.
+     */
+    SnapshotStats writeSnapshot(std::ostream &out) const;
+
+private:
+    friend class UniversityManager;
+
+    /**
+     * @brief Construct a view of a forked child's managers; only forkAnalyze() does this.
+     */
+    ForkedUniversityView(const StudentManager &students, const FacultyManager &faculty, const CourseManager &courses);
+
+    const StudentManager &student_manager; ///< Student records of the image
+    const FacultyManager &faculty_manager; ///< Faculty records of the image
+    const CourseManager &course_manager;   ///< Course records of the image
+};
+
+/**
+ * @brief Class to manage the entire university system.
+ *
+ * Provides an interface to manage students, faculty, and courses.
+ * Any call made inside a DeadlineScope throws DeadlineExceeded instead of
+ * waiting on a manager's lock past the scope's deadline. Operations that
+ * need several managers' locks at once acquire them in the fixed order
+ * student, faculty, course, which keeps them deadlock-free.
+ */
+class UniversityManager {
+public:
+    /**
+     * @brief Add a new student to the system.
+     * @param student_id The unique identifier for the student.
+     * @param name The name of the student.
+     */
+    void addStudent(int student_id, const std::string &name);
+
+    /**
+     * @brief Add a new student to the system, taking ownership of the name.
+     * @param student_id The unique identifier for the student.
+     * @param name The name of the student; moved into the record without copying.
+     */
+    void addStudent(int student_id, std::string &&name);
+
+    /**
+     * @brief Enroll a student in a course.
+     * @param student_id The unique identifier for the student.
+     * @param course_id The unique identifier for the course.
+     * @throws std::runtime_error if a billing engine is attached and the course has no billing metadata; nothing is changed.
+     */
+    void enrollInCourse(int student_id, int course_id);
+
+    /**
+     * @brief Drop a student from a course.
+     * @param student_id The unique identifier for the student.
+     * @param course_id The unique identifier for the course.
+     */
+    void dropCourse(int student_id, int course_id);
+
+    /**
+     * @brief Atomically drop one course and enroll in another.
+     *
+     * Takes the student manager's exclusive mtx and then the course
+     * manager's, in the usual student-before-course order, and holds both
+     * for the whole swap. The managers' public methods each lock
+     * internally, so the swap uses their private lock-taking primitives
+     * instead (UniversityManager is a friend of both). With both locks
+     * held it first runs StudentManager::checkReplaceLocked() and
+     * CourseManager::checkSwapLocked(), which includes the seat check.
+     * Only if both pass does it call replaceCourseLocked() and
+     * swapStudentLocked(). No other call can take the target seat between
+     * the drop and the enroll, and if the target is full the student keeps
+     * the original seat and neither manager changes. Logged to the
+     * write-ahead log as one WalOp::SwapSection record once it succeeds.
+     *
+     * @param student_id The unique identifier for the student.
+     * @param from_course_id The course being dropped.
+     * @param to_course_id The course being added.
+     * @throws std::runtime_error if the swap cannot be made; no change is applied.
+     */
+    void swapSection(int student_id, int from_course_id, int to_course_id);
+
+    /**
+     * @brief Get the IDs of all students.
+     * @return A vector of student IDs in unspecified order.
+     */
+    std::vector<int> getStudentIds() const;
+
+    /**
+     * @brief Visit every student record in place under the shared lock.
+     *
+     * The visitor must not call back into this university.
+     *
+     * @param visitor Called once per record, in unspecified order.
+     */
+    void forEachStudent(const std::function<void(const Student &)> &visitor) const;
+
+    /**
+     * @brief Visit one student record in place under the shared lock.
+     * @param id The unique identifier for the record.
+     * @param visitor Called with the record if it exists.
+     * @return true if the record exists and was visited.
+     */
+    bool visitStudent(int id, const std::function<void(const Student &)> &visitor) const;
+
+    /**
+     * @brief Get the list of courses a student is enrolled in.
+     * @param student_id The unique identifier for the student.
+     * @return A set of course IDs.
+     */
+    std::unordered_set<int> getStudentCourses(int student_id) const;
+
+    /**
+     * @brief Copy the course IDs a student is enrolled in into a caller-provided buffer without allocating.
+     * @param student_id The unique identifier for the student.
+     * @param out Buffer receiving up to @p capacity IDs.
+     * @param capacity Number of elements available in @p out.
+     * @return The total number of IDs, which may exceed @p capacity if the buffer was too small.
+     */
+    std::size_t getStudentCourses(int student_id, int *out, std::size_t capacity) const;
+
+    /**
+     * @brief Add a new faculty member to the system.
+     * @param faculty_id The unique identifier for the faculty member.
+     * @param name The name of the faculty member.
+     */
+    void addFaculty(int faculty_id, const std::string &name);
+
+    /**
+     * @brief Add a new faculty member to the system, taking ownership of the name.
+     * @param faculty_id The unique identifier for the faculty member.
+     * @param name The name of the faculty member; moved into the record without copying.
+     */
+    void addFaculty(int faculty_id, std::string &&name);
+
+    /**
+     * @brief Assign a faculty member to teach a course.
+     * @param faculty_id The unique identifier for the faculty member.
+     * @param course_id The unique identifier for the course.
+     */
+    void assignCourse(int faculty_id, int course_id);
+
+    /**
+     * @brief Get the list of courses a faculty member is teaching.
+     * @param faculty_id The unique identifier for the faculty member.
+     * @return A set of course IDs.
+     */
+    std::unordered_set<int> getFacultyCourses(int faculty_id) const;
+
+    /**
+     * @brief Visit every faculty record in place under the shared lock.
+     *
+     * The visitor must not call back into this university.
+     *
+     * @param visitor Called once per record, in unspecified order.
+     */
+    void forEachFaculty(const std::function<void(const Faculty &)> &visitor) const;
+
+    /**
+     * @brief Visit one faculty record in place under the shared lock.
+     * @param id The unique identifier for the record.
+     * @param visitor Called with the record if it exists.
+     * @return true if the record exists and was visited.
+     */
+    bool visitFaculty(int id, const std::function<void(const Faculty &)> &visitor) const;
+
+    /**
+     * @brief Copy the course IDs a faculty member is teaching into a caller-provided buffer without allocating.
+     * @param faculty_id The unique identifier for the faculty member.
+     * @param out Buffer receiving up to @p capacity IDs.
+     * @param capacity Number of elements available in @p out.
+     * @return The total number of IDs, which may exceed @p capacity if the buffer was too small.
+     */
+    std::size_t getFacultyCourses(int faculty_id, int *out, std::size_t capacity) const;
+
+    /**
+     * @brief Add a new course to the system.
+     * @param course_id The unique identifier for the course.
+     * @param name The name of the course.
+     * @param faculty_id The unique identifier for the faculty member teaching the course.
+     */
+    void addCourse(int course_id, const std::string &name, int faculty_id);
+
+    /**
+     * @brief Add a new course to the system, taking ownership of the name.
+     * @param course_id The unique identifier for the course.
+     * @param name The name of the course; moved into the record without copying.
+     * @param faculty_id The unique identifier for the faculty member teaching the course.
+     */
+    void addCourse(int course_id, std::string &&name, int faculty_id);
+
+    /**
+     * @brief Get the list of students enrolled in a course.
+     * @param course_id The unique identifier for the course.
+     * @return A set of student IDs.
+     */
+    std::unordered_set<int> getCourseStudents(int course_id) const;
+
+    /**
+     * @brief Check whether a student is enrolled in a course.
+     * @param student_id The unique identifier for the student.
+     * @param course_id The unique identifier for the course.
+     * @return true if the course exists and the student is enrolled in it.
+     */
+    bool isEnrolled(int student_id, int course_id) const;
+
+    /**
+     * @brief Get the faculty member teaching a course.
+     * @param course_id The unique identifier for the course.
+     * @return The faculty member's ID.
+     */
+    int getCourseFaculty(int course_id) const;
+
+    /**
+     * @brief Read a course's metadata without contending with roster changes.
+     * @param course_id The unique identifier for the course.
+     * @return A consistent copy of the course's metadata.
+     */
+    CourseMetadata getCourseMetadata(int course_id) const;
+
+    /**
+     * @brief Read a faculty member's metadata without contending with course assignments.
+     * @param faculty_id The unique identifier for the faculty member.
+     * @return A consistent copy of the faculty member's metadata.
+     */
+    FacultyMetadata getFacultyMetadata(int faculty_id) const;
+
+    /**
+     * @brief Rename a course.
+     * @param course_id The unique identifier for the course.
+     * @param name The new name of the course.
+     */
+    void setCourseName(int course_id, const std::string &name);
+
+    /**
+     * @brief Change the faculty member teaching a course.
+     *
+     * Moves the course from the previous faculty member's course set to the
+     * new one's, taking the faculty then course locks in the fixed order,
+     * and drops the cached authorization decisions of both faculty members
+     * so neither keeps a stale grant or denial for the roster.
+     *
+     * @param course_id The unique identifier for the course.
+     * @param faculty_id The unique identifier for the new faculty member.
+     */
+    void setCourseFaculty(int course_id, int faculty_id);
+
+    /**
+     * @brief Rename a faculty member.
+     * @param faculty_id The unique identifier for the faculty member.
+     * @param name The new name of the faculty member.
+     */
+    void setFacultyName(int faculty_id, const std::string &name);
+
+    /**
+     * @brief Set the seat capacity of a course.
+     * @param course_id The unique identifier for the course.
+     * @param capacity Maximum number of enrolled students, 0 for unlimited.
+     */
+    void setCourseCapacity(int course_id, int capacity);
+
+    /**
+     * @brief Get the seat capacity of a course.
+     * @param course_id The unique identifier for the course.
+     * @return Maximum number of enrolled students, 0 for unlimited.
+     */
+    int getCourseCapacity(int course_id) const;
+
+    /**
+     * @brief Get the number of seats still available in a course.
+     * @param course_id The unique identifier for the course.
+     * @return capacity - enrolled - held, or INT_MAX if the course has unlimited capacity.
+     */
+    int getOpenSeats(int course_id) const;
+
+    /**
+     * @brief Set the section family and weekly meeting times of a course.
+     *
+     * Logged as WalOp::SetCourseSchedule once it succeeds, with the family
+     * in arg1 and the mask in the record's payload.
+     *
+     * @param course_id The unique identifier for the course.
+     * @param family_id ID shared by all sections of the same catalog course.
+     * @param meetings Weekly meeting times of the section.
+     */
+    void setCourseSchedule(int course_id, int family_id, const MeetingMask &meetings);
+
+    /**
+     * @brief Get the sections of a catalog course.
+     * @param family_id ID shared by the sections.
+     * @return Course IDs of the sections, empty if the family is unknown.
+     */
+    std::vector<int> getFamilySections(int family_id) const;
+
+    /**
+     * @brief Find open sibling sections of a course that fit a student's schedule.
+     *
+     * Intended for when enrollInCourse() fails because the course is full.
+     * The student's busy times are the union of the meeting times of the
+     * courses they are enrolled in.
+     *
+     * The result is not a consistent snapshot. The busy mask is built from
+     * the student's courses under the student manager's shared lock, which
+     * is then released. The sibling index is queried under the course
+     * manager's shared lock. An enrollment, drop, hold or schedule change
+     * that lands in between can make a returned section full or
+     * conflicting by the time the caller acts on it. Callers should treat
+     * the result as suggestions and rely on enrollInCourse() or
+     * swapSection() to re-check.
+     *
+     * @param student_id The unique identifier for the student.
+     * @param course_id The unique identifier for the full course.
+     * @return Course IDs of open, non-conflicting sibling sections.
+     */
+    std::vector<int> findOpenSections(int student_id, int course_id) const;
+
+    /**
+     * @brief Reserve a seat in a course for a limited time, e.g. while it sits in a cart.
+     *
+     * Logged to the write-ahead log as WalOp::HoldSeat once it succeeds.
+     *
+     * @param student_id The unique identifier for the student.
+     * @param course_id The unique identifier for the course.
+     * @param ttl How long the seat is held.
+     * @return Handle of the hold.
+     * @throws std::runtime_error if the student or course does not exist or the course has no open seat.
+     */
+    SeatHoldId holdSeat(int student_id, int course_id, std::chrono::milliseconds ttl);
+
+    /**
+     * @brief Release a hold early, returning its seat.
+     *
+     * Logged as WalOp::ReleaseHold if the hold was still active.
+     *
+     * @param hold Handle returned by holdSeat().
+     * @return true if the hold was still active.
+     */
+    bool releaseHold(SeatHoldId hold);
+
+    /**
+     * @brief Enroll the student of a hold in its course using the held seat.
+     *
+     * Logged as WalOp::ConfirmHold once it succeeds; replay applies it as
+     * an enrollment.
+     *
+     * @param hold Handle returned by holdSeat().
+     * @throws std::runtime_error if the hold has expired or was released.
+     */
+    void confirmHold(SeatHoldId hold);
+
+    /**
+     * @brief Expire every hold whose time-to-live has passed, returning the seats.
+     *
+     * Call periodically, e.g. every CourseManager::kHoldTick from a timer
+     * thread. Each expired hold is logged as a WalOp::ExpireHolds record.
+     *
+     * @return Number of holds expired.
+     */
+    std::size_t expireHolds();
+
+    /**
+     * @brief Get the IDs of all courses.
+     * @return A vector of course IDs in unspecified order.
+     */
+    std::vector<int> getCourseIds() const;
+
+    /**
+     * @brief Visit every course record in place under the shared lock.
+     *
+     * The visitor must not call back into this university.
+     *
+     * @param visitor Called once per record, in unspecified order.
+     */
+    void forEachCourse(const std::function<void(const Course &)> &visitor) const;
+
+    /**
+     * @brief Visit one course record in place under the shared lock.
+     * @param id The unique identifier for the record.
+     * @param visitor Called with the record if it exists.
+     * @return true if the record exists and was visited.
+     */
+    bool visitCourse(int id, const std::function<void(const Course &)> &visitor) const;
+
+    /**
+     * @brief Copy the student IDs enrolled in a course into a caller-provided buffer without allocating.
+     * @param course_id The unique identifier for the course.
+     * @param out Buffer receiving up to @p capacity IDs.
+     * @param capacity Number of elements available in @p out.
+     * @return The total number of IDs, which may exceed @p capacity if the buffer was too small.
+     */
+    std::size_t getCourseStudents(int course_id, int *out, std::size_t capacity) const;
+
+    /**
+     * @brief Pre-size all managers for an expected dataset.
+     *
+     * After reserving, onboarding up to these counts never rehashes the
+     * record tables or dirty-mark sets, so no single add stalls the other
+     * callers behind a whole-table rehash. Each add still allocates its
+     * record.
+     *
+     * A drop keeps the set nodes it removes, up to kSpareNodeLimit per
+     * pool, and later enrollments, swaps and open-section updates reuse
+     * them. A pooled ByName node keeps its name's capacity. Once add/drop
+     * churn has warmed the pools, enrolling and dropping allocate nothing,
+     * provided the records involved are already dirty-marked since the
+     * last committed checkpoint. The buffer-based getters never allocate.
+     *
+     * @param students Expected number of students.
+     * @param faculty Expected number of faculty members.
+     * @param courses Expected number of courses.
+     */
+    void reserve(std::size_t students, std::size_t faculty, std::size_t courses);
+
+    /**
+     * @brief Enable the query-result cache for roster and course-list queries.
+     *
+     * Replaces any existing cache with an empty one. Safe to call while
+     * other threads call getCachedResult().
+     *
+     * @param max_bytes Memory bound for cached results.
+     */
+    void enableResultCache(std::size_t max_bytes);
+
+    /**
+     * @brief Disable the query-result cache and release its memory.
+     *
+     * Safe to call while other threads call getCachedResult(); the memory is
+     * released once the last in-flight lookup finishes with the cache.
+     */
+    void disableResultCache();
+
+    /**
+     * @brief Get a query result, served from the result cache when enabled.
+     *
+     * The result is shared and immutable, so repeated requests between
+     * mutations return the same object without recomputing or copying it.
+     * The call copies the cache's shared_ptr under result_cache_mtx and then
+     * uses the cache outside that mutex, so enabling or disabling the cache
+     * concurrently never frees it under a lookup.
+     *
+     * Record versions restart when records are reloaded, so restoreSnapshot()
+     * and replayWriteAheadLog() replace the cache with an empty one. A lookup
+     * racing with the reload can only fill the discarded cache, and no entry
+     * computed before the reload is ever served after it.
+     *
+     * @param query The query kind.
+     * @param id The student, faculty or course ID the query is keyed by.
+     * @return The query result as a shared immutable vector of IDs.
+     */
+    QueryResultCache::Result getCachedResult(CachedQuery query, int id) const;
+
+    /**
+     * @brief Get query-result cache statistics.
+     * @return A snapshot of the cache counters, all zero if the cache is disabled.
+     */
+    ResultCacheStats getResultCacheStats() const;
+
+    /**
+     * @brief Save a snapshot of all managers to a file.
+     *
+     * A Full snapshot writes every record and starts a new base image. An
+     * Incremental snapshot writes only records dirtied since the previous
+     * snapshot of either kind.
+     *
+     * The snapshot is written to a temporary file, which is fsynced and
+     * renamed over @p path before the directory is fsynced. Only then are
+     * the managers' dirty marks committed, so if any step fails the marks
+     * are kept and the next snapshot writes those records again.
+     *
+     * Each manager is serialized under its own shared lock in turn, students
+     * first, then faculty, then courses. The three sections are therefore
+     * captured at slightly different instants, and an enrollment made during
+     * the save may appear in the course section but not the student section.
+     * Such a mutation keeps its dirty mark and is written again by the next
+     * incremental snapshot. Use forkSnapshot() for a single-instant image.
+     *
+     * @param path Destination file path.
+     * @param mode Whether to write a full base image or an incremental delta.
+     * @return Record count, write volume and elapsed time.
+     * @throws std::runtime_error if the file cannot be written.
+     */
+    SnapshotStats saveSnapshot(const std::string &path, SnapshotMode mode);
+
+    /**
+     * @brief Restore state from a base image and its incremental snapshots.
+     *
+     * Replaces the query-result cache, if enabled, with an empty one.
+     *
+     * @param base_path Path of the full snapshot.
+     * @param incremental_paths Paths of incremental snapshots, oldest first.
+     * @return Record count, read volume and elapsed time.
+     * @throws std::runtime_error if a file cannot be read or is malformed.
+     */
+    SnapshotStats restoreSnapshot(const std::string &base_path, const std::vector<std::string> &incremental_paths);
+
+    /**
+     * @brief Fold a base image and its incremental snapshots into a new base image.
+     *
+     * Runs offline against the files only, so the live managers are not locked.
+     *
+     * @param base_path Path of the full snapshot.
+     * @param incremental_paths Paths of incremental snapshots, oldest first.
+     * @param output_path Path of the compacted full snapshot.
+     * @return Record count, write volume and elapsed time of the compacted image.
+     * @throws std::runtime_error if a file cannot be read or written.
+     */
+    static SnapshotStats compactSnapshots(const std::string &base_path, const std::vector<std::string> &incremental_paths, const std::string &output_path);
+
+    /**
+     * @brief Get one page of a course roster in a stable order.
+     * @param course_id The unique identifier for the course.
+     * @param order The sort order of the roster.
+     * @param after Cursor returned with the previous page, or a default cursor for the first page.
+     * @param page_size Maximum number of students to return.
+     * @return The requested page and the cursor for the next one.
+     */
+    RosterPage getCourseRoster(int course_id, RosterOrder order, const RosterCursor &after, std::size_t page_size) const;
+
+    /**
+     * @brief Get negative-lookup filter statistics for the student manager.
+     * @return A snapshot of the filter counters.
+     */
+    LookupFilterStats getStudentLookupFilterStats() const;
+
+    /**
+     * @brief Get negative-lookup filter statistics for the faculty manager.
+     * @return A snapshot of the filter counters.
+     */
+    LookupFilterStats getFacultyLookupFilterStats() const;
+
+    /**
+     * @brief Get negative-lookup filter statistics for the course manager.
+     * @return A snapshot of the filter counters.
+     */
+    LookupFilterStats getCourseLookupFilterStats() const;
+
+    /**
+     * @brief Log every successful mutation to a write-ahead log.
+     * @param wal The log writer, or nullptr to stop logging. Not owned; must outlive the attachment.
+     */
+    void setWriteAheadLog(WalWriter *wal);
+
+    /**
+     * @brief Recover state by replaying write-ahead log segments on all cores.
+     *
+     * The log is never held in memory as a whole. Each phase streams the
+     * segments through a WalReader on the calling thread, which pushes every
+     * record it decodes to the bounded WalShardQueue of each worker that
+     * applies it, so memory use stays bounded by one segment mapping plus
+     * the queues however long the log is.
+     *
+     * Replay runs in two phases, each a pass over the segments. First, add*
+     * records are applied, partitioned by ID across @p threads workers. Then
+     * the remaining records are applied twice in parallel, once partitioned
+     * by student or faculty shard to the StudentManager/FacultyManager side
+     * and once by course shard to the CourseManager side. SetCourseFaculty goes to the shards
+     * of both the previous and the new faculty member on the first side,
+     * and SetFacultyName has no course side. SwapSection goes to the
+     * student's shard on the first side; on the course side it is applied
+     * as a drop in the source course's shard and an enrollment in the
+     * target course's shard, which keeps each course's roster changes in
+     * LSN order. SetCourseSchedule has only a course side. ConfirmHold is applied as an
+     * enrollment. HoldSeat, ReleaseHold and ExpireHolds records are skipped:
+     * holds are not durable, so a recovered university starts with none and
+     * every seat held at the crash is open again. Each worker applies its
+     * partition in LSN order, so every entity sees its mutations in the
+     * original order. Creation always precedes use in a valid log, so
+     * applying all creations first preserves that order too. The
+     * query-result cache, if enabled, is replaced with an empty one.
+     *
+     * @param segments Segment file paths in LSN order.
+     * @param threads Worker threads, 0 for std::thread::hardware_concurrency().
+     * @return Record count and decode/apply timings.
+     * @throws std::runtime_error if a segment cannot be read or is corrupt; records
+     *         queued before the error are still applied.
+     */
+    WalReplayStats replayWriteAheadLog(const std::vector<std::string> &segments, unsigned threads = 0);
+
+    /**
+     * @brief Write a full snapshot from a fork()ed copy-on-write image.
+     *
+     * Quiesces the managers by taking each one's exclusive mtx directly, in
+     * the order student, faculty, course, so no writer is mid-mutation;
+     * then forks and releases the locks in the parent, so writers are
+     * paused only for lock acquisition and the fork itself. The child
+     * inherits the locks held and never touches them: it writes the
+     * snapshot through ForkedUniversityView::writeSnapshot(), which uses
+     * the managers' unlocked serializers and leaves dirty marks alone, and
+     * exits with _exit(). The parent's dirty marks are unaffected, so
+     * incremental snapshots continue from the last saveSnapshot().
+     *
+     * @param path Destination file path.
+     * @return A future completed when the child exits, with its status and the parent-side cost.
+     * @throws std::runtime_error if fork() fails.
+     */
+    std::future<ForkSnapshotReport> forkSnapshot(const std::string &path) const;
+
+    /**
+     * @brief Run a read-only job against a fork()ed copy-on-write image.
+     *
+     * As forkSnapshot(), but the child runs @p job instead, e.g. a heavy
+     * report. The job gets a ForkedUniversityView, whose readers take no
+     * locks; it must not reach the UniversityManager itself, whose locks
+     * are held in the child, nor start threads that expect the parent's
+     * other threads to exist.
+     *
+     * @param job Called in the child; its return value becomes the exit status.
+     * @return A future completed when the child exits, with its status and the parent-side cost.
+     * @throws std::runtime_error if fork() fails.
+     */
+    std::future<ForkSnapshotReport> forkAnalyze(const std::function<int(const ForkedUniversityView &)> &job) const;
+
+    /**
+     * @brief Freeze the course catalog at the start of a term.
+     * @return Build statistics of the catalog.
+     */
+    CatalogFreezeStats freezeCourseCatalog();
+
+    /**
+     * @brief Unfreeze the course catalog so courses can be added again.
+     */
+    void thawCourseCatalog();
+
+    /**
+     * @brief Check whether a user may perform a read.
+     *
+     * Evaluated in O(1) from Course::faculty_id and Faculty::courses, with
+     * decisions memoized until the requester's assignments change.
+     *
+     * @param requester_id The unique identifier for the requesting user.
+     * @param action The requested action.
+     * @param target_id The course ID (ReadRoster) or faculty ID (ReadFacultySchedule).
+     * @return true if the read is permitted.
+     */
+    bool isAuthorized(int requester_id, AccessAction action, int target_id) const;
+
+    /**
+     * @brief Get the list of students enrolled in a course on behalf of a user.
+     * @param requester_id The unique identifier for the requesting user.
+     * @param course_id The unique identifier for the course.
+     * @return A set of student IDs.
+     * @throws std::runtime_error if the requester may not read the roster.
+     */
+    std::unordered_set<int> getCourseStudentsAs(int requester_id, int course_id) const;
+
+    /**
+     * @brief Get the list of courses a faculty member is teaching on behalf of a user.
+     * @param requester_id The unique identifier for the requesting user.
+     * @param faculty_id The unique identifier for the faculty member.
+     * @return A set of course IDs.
+     * @throws std::runtime_error if the requester may not read the schedule.
+     */
+    std::unordered_set<int> getFacultyCoursesAs(int requester_id, int faculty_id) const;
+
+    /**
+     * @brief Get the access control registry of administrators and cached decisions.
+     * @return The access control component.
+     */
+    AccessControl &accessControl();
+
+    /**
+     * @brief Limit the approximate memory held by this university's records.
+     *
+     * add* calls that would exceed the quota throw std::runtime_error. An
+     * add reserves its bytes before inserting, with a compare-and-swap loop
+     * that advances memory_usage only while the result stays within the
+     * quota, and returns them if the insert then fails. Concurrent adds
+     * therefore cannot overshoot the quota together. Safe to call while
+     * other threads add records; lowering the quota below current usage
+     * rejects further adds but frees nothing.
+     *
+     * @param max_bytes Memory quota in bytes, 0 for unlimited.
+     */
+    void setMemoryQuota(std::size_t max_bytes);
+
+    /**
+     * @brief Get the approximate memory held by this university's records.
+     * @return Bytes accounted to records, names and enrollment sets.
+     */
+    std::size_t getMemoryUsage() const;
+
+    /**
+     * @brief Get the number of calls that failed with DeadlineExceeded, per operation.
+     * @return Miss counts indexed by OperationKind.
+     */
+    std::array<std::uint64_t, static_cast<std::size_t>(OperationKind::Count)> getDeadlineMisses() const;
+
+    /**
+     * @brief Get read and write counters for throughput metrics.
+     * @return A snapshot of the counters.
+     */
+    OperationCounters getOperationCounters() const;
+
+    /**
+     * @brief Attach a trace recorder that captures every public call.
+     * @param recorder The recorder, or nullptr to stop recording. Not owned; must outlive the attachment.
+     */
+    void setTraceRecorder(TraceRecorder *recorder);
+
+    /**
+     * @brief Attach a billing engine to be notified of every enroll and drop.
+     *
+     * The engine is notified after enrollInCourse(), confirmHold(),
+     * dropCourse() and swapSection() succeed. Calls that add an enrollment
+     * first check BillingEngine::isBillable() and fail without changing
+     * anything if the course has no billing metadata, so a notification
+     * never fails after the enrollment was applied. Safe to call while
+     * other threads enroll and drop; a call in flight notifies the engine
+     * it loaded when it started.
+     *
+     * @param engine The billing engine, or nullptr to detach. Not owned; must outlive the attachment.
+     */
+    void setBillingEngine(BillingEngine *engine);
+
+private:
+    /**
+     * @brief Reserve memory for a record against the quota.
+     * @param bytes Approximate size of the record.
+     * @throws std::runtime_error if the reservation would exceed the quota; nothing is reserved.
+     */
+    void reserveMemory(std::size_t bytes);
+
+    /**
+     * @brief Return memory reserved by reserveMemory(), e.g. after a failed insert.
+     * @param bytes The reserved size.
+     */
+    void releaseMemory(std::size_t bytes);
+
+    /**
+     * @brief Recount memory_usage from the records, after a restore or replay replaced them.
+     */
+    void recountMemory();
+
+    /**
+     * @brief Run a public call, counting it in deadline_misses if it throws DeadlineExceeded.
+     * @param kind The operation.
+     * @param body The call's implementation.
+     * @return What @p body returns.
+     */
+    template <typename Body>
+    auto track(OperationKind kind, Body &&body) const -> decltype(body());
+
+    /**
+     * @brief isAuthorized() without tracing, for the *As wrappers.
+     */
+    bool authorize(int requester_id, AccessAction action, int target_id) const;
+
+    /**
+     * @brief Record a call with the attached trace recorder, if any.
+     * @param kind The operation.
+     * @param arg0 First integer argument.
+     * @param arg1 Second integer argument.
+     * @param arg2 Third integer argument.
+     * @param name Name argument, or the encoded mask of SetCourseSchedule.
+     */
+    void trace(OperationKind kind, std::int32_t arg0, std::int32_t arg1 = 0, std::int32_t arg2 = 0, const std::string &name = std::string()) const;
+
+    /**
+     * @brief Append a mutation to the attached write-ahead log, if any.
+     *
+     * Called while the locks of the mutated records are still held, so the
+     * LSN order of records touching one entity is the order they were applied.
+     *
+     * @param op The mutation.
+     * @param arg0 First argument.
+     * @param arg1 Second argument.
+     * @param arg2 Third argument.
+     * @param name Name for add* and set*Name mutations.
+     * @param payload Payload bytes, e.g. the MeetingMask of SetCourseSchedule.
+     */
+    void logMutation(WalOp op, std::int32_t arg0, std::int32_t arg1, std::int32_t arg2 = 0, const std::string &name = std::string(), const std::string &payload = std::string());
+
+    /**
+     * @brief Replace the query-result cache, if enabled, with an empty one of the same bound.
+     */
+    void resetResultCache();
+
+    StudentManager student_manager; ///< Manager for student records
+    FacultyManager faculty_manager; ///< Manager for faculty records
+    CourseManager course_manager;   ///< Manager for course records
+    std::shared_ptr<QueryResultCache> result_cache; ///< Optional query-result cache, null when disabled; guarded by result_cache_mtx
+    mutable std::mutex result_cache_mtx; ///< Guards the result_cache pointer, not the cache's contents
+    std::atomic<BillingEngine *> billing_engine{nullptr}; ///< Optional billing engine notified on enroll/drop
+    std::atomic<TraceRecorder *> trace_recorder{nullptr}; ///< Optional recorder of public calls
+    std::atomic<WalWriter *> write_ahead_log{nullptr};    ///< Optional log of successful mutations
+    mutable AccessControl access_control; ///< Administrators and memoized authorization decisions
+    std::atomic<std::size_t> memory_quota{0}; ///< Memory quota in bytes, 0 for unlimited
+    std::atomic<std::size_t> memory_usage{0}; ///< Approximate bytes held or reserved by records
+    mutable std::atomic<std::uint64_t> read_count{0};  ///< Completed query calls
+    std::atomic<std::uint64_t> write_count{0};         ///< Completed mutation calls
+    std::atomic<std::uint64_t> quota_rejection_count{0}; ///< Mutations rejected by the memory quota
+    mutable std::array<std::atomic<std::uint64_t>, static_cast<std::size_t>(OperationKind::Count)> deadline_misses{}; ///< DeadlineExceeded failures per operation
+};
+
+// Inline definitions. BillingEngine and TraceRecorder are included before
+// the UniversityManager definitions, which notify them, and after the free
+// helpers, which trace replay uses.
+
+constexpr std::size_t kEnrollmentBytes = 160; ///< Approximate memory of one enrollment across the student set and the course's three roster indexes
+constexpr std::size_t kSpareNodeLimit = 4096; ///< Set nodes of dropped enrollments kept per pool for reuse by later enrollments
+
+constexpr std::uint32_t kStudentSnapshotMagic = 0x54535553; ///< "SUST": student section of a snapshot
+constexpr std::uint32_t kFacultySnapshotMagic = 0x43465553; ///< "SUFC": faculty section of a snapshot
+constexpr std::uint32_t kCourseSnapshotMagic = 0x4F435553;  ///< "SUCO": course section of a snapshot
+
+inline IdBloomFilter::IdBloomFilter(std::size_t expected_ids, std::size_t bits_per_id)
+    : expected(expected_ids == 0 ? 1 : expected_ids) {
+    std::size_t bits = expected * (bits_per_id == 0 ? 1 : bits_per_id);
+    word_count = (bits + 63) / 64;
+    // k = bits_per_id * ln 2 minimizes the false-positive rate.
+    hash_count = static_cast<unsigned>(static_cast<double>(bits_per_id) * 0.693 + 0.5);
+    if (hash_count == 0) {
+        hash_count = 1;
+    }
+    words.reset(new std::atomic<std::uint64_t>[word_count]);
+    for (std::size_t i = 0; i < word_count; ++i) {
+        words[i].store(0, std::memory_order_relaxed);
+    }
+}
+
+inline void IdBloomFilter::insert(int id) {
+    std::uint64_t h = static_cast<std::uint64_t>(static_cast<std::uint32_t>(id)) * 0x9E3779B97F4A7C15ULL;
+    std::uint64_t h1 = h ^ (h >> 29);
+    std::uint64_t h2 = (h * 0xBF58476D1CE4E5B9ULL) | 1;
+    std::uint64_t bits = static_cast<std::uint64_t>(word_count) * 64;
+    for (unsigned i = 0; i < hash_count; ++i) {
+        std::uint64_t bit = (h1 + i * h2) % bits;
+        words[bit >> 6].fetch_or(std::uint64_t(1) << (bit & 63), std::memory_order_relaxed);
+    }
+}
+
+inline bool IdBloomFilter::mayContain(int id) const {
+    std::uint64_t h = static_cast<std::uint64_t>(static_cast<std::uint32_t>(id)) * 0x9E3779B97F4A7C15ULL;
+    std::uint64_t h1 = h ^ (h >> 29);
+    std::uint64_t h2 = (h * 0xBF58476D1CE4E5B9ULL) | 1;
+    std::uint64_t bits = static_cast<std::uint64_t>(word_count) * 64;
+    for (unsigned i = 0; i < hash_count; ++i) {
+        std::uint64_t bit = (h1 + i * h2) % bits;
+        if (!(words[bit >> 6].load(std::memory_order_relaxed) & (std::uint64_t(1) << (bit & 63)))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+inline std::size_t IdBloomFilter::capacity() const {
+    return expected;
+}
+
+inline DeadlineScope::DeadlineScope(Clock::time_point deadline) : previous(slot()) {
+    if (deadline < previous) {
+        slot() = deadline;
+    }
+}
+
+inline DeadlineScope::DeadlineScope(Clock::duration budget) : DeadlineScope(Clock::now() + budget) {}
+
+inline DeadlineScope::~DeadlineScope() {
+    slot() = previous;
+}
+
+inline DeadlineScope::Clock::time_point DeadlineScope::current() {
+    return slot();
+}
+
+inline DeadlineScope::Clock::time_point &DeadlineScope::slot() {
+    static thread_local Clock::time_point deadline = Clock::time_point::max();
+    return deadline;
+}
+
+/**
+ * @brief Throw DeadlineExceeded if the calling thread's deadline has passed.
+ *
+ * Called between the steps of multi-step operations.
+ */
+inline void checkDeadline() {
+    DeadlineScope::Clock::time_point deadline = DeadlineScope::current();
+    if (deadline != DeadlineScope::Clock::time_point::max() && DeadlineScope::Clock::now() >= deadline) {
+        throw DeadlineExceeded("Deadline exceeded");
+    }
+}
+
+/**
+ * @brief Take a shared lock, waiting no later than the calling thread's deadline.
+ * @param mtx The mutex.
+ * @return The held lock.
+ * @throws DeadlineExceeded if the deadline passes first.
+ */
+inline std::shared_lock<std::shared_timed_mutex> lockSharedWithDeadline(std::shared_timed_mutex &mtx) {
+    DeadlineScope::Clock::time_point deadline = DeadlineScope::current();
+    if (deadline == DeadlineScope::Clock::time_point::max()) {
+        return std::shared_lock<std::shared_timed_mutex>(mtx);
+    }
+    std::shared_lock<std::shared_timed_mutex> lock(mtx, deadline);
+    if (!lock.owns_lock()) {
+        throw DeadlineExceeded("Deadline exceeded waiting for a shared lock");
+    }
+    return lock;
+}
+
+/**
+ * @brief Take an exclusive lock, waiting no later than the calling thread's deadline.
+ * @param mtx The mutex.
+ * @return The held lock.
+ * @throws DeadlineExceeded if the deadline passes first.
+ */
+inline std::unique_lock<std::shared_timed_mutex> lockExclusiveWithDeadline(std::shared_timed_mutex &mtx) {
+    DeadlineScope::Clock::time_point deadline = DeadlineScope::current();
+    if (deadline == DeadlineScope::Clock::time_point::max()) {
+        return std::unique_lock<std::shared_timed_mutex>(mtx);
+    }
+    std::unique_lock<std::shared_timed_mutex> lock(mtx, deadline);
+    if (!lock.owns_lock()) {
+        throw DeadlineExceeded("Deadline exceeded waiting for an exclusive lock");
+    }
+    return lock;
+}
+
+/**
+ * @brief Build the seqlock-published metadata of a course.
+ * @param course The course record.
+ * @return The metadata, with the name truncated to kMetadataNameLength bytes.
+ */
+inline CourseMetadata makeCourseMetadata(const Course &course) {
+    CourseMetadata metadata{};
+    metadata.faculty_id = course.faculty_id;
+    metadata.capacity = course.capacity;
+    std::size_t length = std::min(course.name.size(), kMetadataNameLength);
+    std::memcpy(metadata.name, course.name.data(), length);
+    metadata.name[length] = '\0';
+    metadata.name_truncated = length < course.name.size();
+    return metadata;
+}
+
+/**
+ * @brief Build the seqlock-published metadata of a faculty member.
+ * @param faculty The faculty record.
+ * @return The metadata, with the name truncated to kMetadataNameLength bytes.
+ */
+inline FacultyMetadata makeFacultyMetadata(const Faculty &faculty) {
+    FacultyMetadata metadata{};
+    std::size_t length = std::min(faculty.name.size(), kMetadataNameLength);
+    std::memcpy(metadata.name, faculty.name.data(), length);
+    metadata.name[length] = '\0';
+    metadata.name_truncated = length < faculty.name.size();
+    return metadata;
+}
+
+/**
+ * @brief Number of seats a course can still give out.
+ * @param course The course record.
+ * @return capacity - enrolled - held, clamped at 0, or INT_MAX if the capacity is unlimited.
+ */
+inline int openSeatsOf(const Course &course) {
+    if (course.capacity == 0) {
+        return INT_MAX;
+    }
+    long long open = static_cast<long long>(course.capacity) - static_cast<long long>(course.students.size()) - course.held_seats;
+    return open > 0 ? static_cast<int>(open) : 0;
+}
+
+/**
+ * @brief Encode a meeting mask as the write-ahead log and trace payload.
+ * @param mask The meeting mask.
+ * @return kWeekSlots / 8 bytes, slot 0 in the low bit of byte 0.
+ */
+inline std::string encodeMeetingMask(const MeetingMask &mask) {
+    std::string bytes(kWeekSlots / 8, '\0');
+    for (std::size_t slot = 0; slot < kWeekSlots; ++slot) {
+        if (mask.test(slot)) {
+            bytes[slot / 8] = static_cast<char>(static_cast<unsigned char>(bytes[slot / 8]) | (1u << (slot % 8)));
+        }
+    }
+    return bytes;
+}
+
+/**
+ * @brief Decode a meeting mask written by encodeMeetingMask().
+ * @param bytes The encoded mask.
+ * @return The meeting mask.
+ * @throws std::runtime_error if @p bytes has the wrong length.
+ */
+inline MeetingMask decodeMeetingMask(const std::string &bytes) {
+    if (bytes.size() != kWeekSlots / 8) {
+        throw std::runtime_error("Malformed meeting mask");
+    }
+    MeetingMask mask;
+    for (std::size_t slot = 0; slot < kWeekSlots; ++slot) {
+        if (static_cast<unsigned char>(bytes[slot / 8]) & (1u << (slot % 8))) {
+            mask.set(slot);
+        }
+    }
+    return mask;
+}
+
+/**
+ * @brief Write a fixed-size value to a snapshot stream.
+ * @param out Destination stream.
+ * @param value The value, written in host byte order.
+ * @param bytes Incremented by the bytes written.
+ */
+template <typename T>
+inline void writeSnapshotValue(std::ostream &out, const T &value, std::size_t &bytes) {
+    out.write(reinterpret_cast<const char *>(&value), sizeof(T));
+    bytes += sizeof(T);
+}
+
+/**
+ * @brief Write a length-prefixed string to a snapshot stream.
+ * @param out Destination stream.
+ * @param text The string.
+ * @param bytes Incremented by the bytes written.
+ */
+inline void writeSnapshotString(std::ostream &out, const std::string &text, std::size_t &bytes) {
+    writeSnapshotValue(out, static_cast<std::uint32_t>(text.size()), bytes);
+    out.write(text.data(), static_cast<std::streamsize>(text.size()));
+    bytes += text.size();
+}
+
+/**
+ * @brief Read a fixed-size value from a snapshot stream.
+ * @param in Source stream.
+ * @param bytes Incremented by the bytes read.
+ * @return The value.
+ * @throws std::runtime_error if the stream ends early.
+ */
+template <typename T>
+inline T readSnapshotValue(std::istream &in, std::size_t &bytes) {
+    T value;
+    if (!in.read(reinterpret_cast<char *>(&value), sizeof(T))) {
+        throw std::runtime_error("Truncated snapshot");
+    }
+    bytes += sizeof(T);
+    return value;
+}
+
+/**
+ * @brief Read a length-prefixed string from a snapshot stream.
+ * @param in Source stream.
+ * @param bytes Incremented by the bytes read.
+ * @return The string.
+ * @throws std::runtime_error if the stream ends early.
+ */
+inline std::string readSnapshotString(std::istream &in, std::size_t &bytes) {
+    std::uint32_t length = readSnapshotValue<std::uint32_t>(in, bytes);
+    std::string text(length, '\0');
+    if (length != 0 && !in.read(&text[0], length)) {
+        throw std::runtime_error("Truncated snapshot");
+    }
+    bytes += length;
+    return text;
+}
+
+/**
+ * @brief Read and check the header of one manager's snapshot section.
+ * @param in Source stream.
+ * @param magic The section's magic number.
+ * @param bytes Incremented by the bytes read.
+ * @throws std::runtime_error if the header does not match.
+ */
+inline void readSnapshotHeader(std::istream &in, std::uint32_t magic, std::size_t &bytes) {
+    if (readSnapshotValue<std::uint32_t>(in, bytes) != magic) {
+        throw std::runtime_error("Malformed snapshot section");
+    }
+    readSnapshotValue<std::uint8_t>(in, bytes); // SnapshotMode, informational
+}
+
+/**
+ * @brief fsync a file or directory by path.
+ * @param path The path.
+ * @throws std::runtime_error if it cannot be opened or synced.
+ */
+inline void syncPath(const std::string &path) {
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw std::runtime_error("Cannot open " + path + " for fsync");
+    }
+    int result = ::fsync(fd);
+    ::close(fd);
+    if (result != 0) {
+        throw std::runtime_error("fsync failed for " + path);
+    }
+}
+
+/**
+ * @brief Write a snapshot file durably: to a temporary file, fsynced, renamed over @p path, then the directory fsynced.
+ * @param path Destination file path.
+ * @param write Serializes the snapshot into the stream it is given.
+ * @return What @p write returned.
+ * @throws std::runtime_error if any step fails; @p path is then left as it was.
+ */
+inline SnapshotStats writeSnapshotFile(const std::string &path, const std::function<SnapshotStats(std::ostream &)> &write) {
+    std::string temporary = path + ".tmp";
+    SnapshotStats stats;
+    {
+        std::ofstream out(temporary, std::ios::binary | std::ios::trunc);
+        if (!out) {
+            throw std::runtime_error("Cannot open snapshot file " + temporary);
+        }
+        stats = write(out);
+        out.flush();
+        if (!out) {
+            throw std::runtime_error("Cannot write snapshot file " + temporary);
+        }
+    }
+    syncPath(temporary);
+    if (std::rename(temporary.c_str(), path.c_str()) != 0) {
+        throw std::runtime_error("Cannot rename snapshot file to " + path);
+    }
+    std::string::size_type slash = path.rfind('/');
+    syncPath(slash == std::string::npos ? std::string(".") : slash == 0 ? std::string("/") : path.substr(0, slash));
+    return stats;
+}
+
+/**
+ * @brief Add one manager's snapshot counts to a running total.
+ * @param total The running total.
+ * @param part One manager's counts.
+ */
+inline void addSnapshotStats(SnapshotStats &total, const SnapshotStats &part) {
+    total.records += part.records;
+    total.bytes += part.bytes;
+}
+
+/**
+ * @brief Keep an extracted set node for reuse, or free it if the pool is full.
+ * @tparam Node The set's node_type.
+ * @param spare The pool.
+ * @param node The node, possibly empty.
+ */
+template <typename Node>
+void recycleNode(std::vector<Node> &spare, Node &&node) {
+    if (!node.empty() && spare.size() < kSpareNodeLimit) {
+        spare.push_back(std::move(node));
+    }
+}
+
+/**
+ * @brief Insert into a set, reusing a pooled node instead of allocating one.
+ * @tparam Set std::set or std::unordered_set.
+ * @tparam Value The value type, or something assignable to it.
+ * @param set The set.
+ * @param spare Pool of nodes extracted from sets of the same type.
+ * @param value The value to insert; assigned into the node, so a pooled string keeps its capacity.
+ * @return true if the value was inserted.
+ */
+template <typename Set, typename Value>
+bool insertRecycled(Set &set, std::vector<typename Set::node_type> &spare, Value &&value) {
+    if (spare.empty()) {
+        return set.insert(std::forward<Value>(value)).second;
+    }
+    typename Set::node_type node = std::move(spare.back());
+    spare.pop_back();
+    node.value() = std::forward<Value>(value);
+    auto result = set.insert(std::move(node));
+    recycleNode(spare, std::move(result.node));
+    return result.inserted;
+}
+
+/**
+ * @brief Write one course record of a snapshot section.
+ *
+ * Layout: ID, name, faculty ID, capacity, family ID, encoded meeting mask,
+ * then the roster as (name, student ID) pairs in ByName order.
+ *
+ * @param out Destination stream.
+ * @param course The course record.
+ * @param bytes Incremented by the bytes written.
+ */
+inline void writeCourseRecord(std::ostream &out, const Course &course, std::size_t &bytes) {
+    writeSnapshotValue(out, static_cast<std::int32_t>(course.course_id), bytes);
+    writeSnapshotString(out, course.name, bytes);
+    writeSnapshotValue(out, static_cast<std::int32_t>(course.faculty_id), bytes);
+    writeSnapshotValue(out, static_cast<std::int32_t>(course.capacity), bytes);
+    writeSnapshotValue(out, static_cast<std::int32_t>(course.family_id), bytes);
+    writeSnapshotString(out, encodeMeetingMask(course.meetings), bytes);
+    writeSnapshotValue(out, static_cast<std::uint32_t>(course.roster_by_name.size()), bytes);
+    for (const auto &entry : course.roster_by_name) {
+        writeSnapshotString(out, entry.first, bytes);
+        writeSnapshotValue(out, static_cast<std::int32_t>(entry.second), bytes);
+    }
+}
+
+inline void StudentManager::addStudent(int student_id, const std::string &name) {
+    addStudent(student_id, std::string(name));
+}
+
+inline void StudentManager::addStudent(int student_id, std::string &&name) {
+    std::shared_ptr<Student> record = std::make_shared<Student>();
+    record->student_id = student_id;
+    record->name = std::move(name);
+    auto lock = lockExclusiveWithDeadline(mtx);
+    if (!student_records.emplace(student_id, std::move(record)).second) {
+        throw std::runtime_error("Student already exists");
+    }
+    filterInsert(student_id);
+    markDirty(student_id);
+}
+
+inline void StudentManager::enrollInCourse(int student_id, int course_id) {
+    if (filterRejects(student_id)) {
+        throw std::runtime_error("Student not found");
+    }
+    auto lock = lockExclusiveWithDeadline(mtx);
+    checkEnrollLocked(lock, student_id, course_id);
+    enrollInCourseLocked(lock, student_id, course_id);
+}
+
+inline void StudentManager::dropCourse(int student_id, int course_id) {
+    if (filterRejects(student_id)) {
+        throw std::runtime_error("Student not found");
+    }
+    auto lock = lockExclusiveWithDeadline(mtx);
+    dropCourseLocked(lock, student_id, course_id);
+}
+
+inline void StudentManager::replaceCourse(int student_id, int from_course_id, int to_course_id) {
+    if (filterRejects(student_id)) {
+        throw std::runtime_error("Student not found");
+    }
+    auto lock = lockExclusiveWithDeadline(mtx);
+    checkReplaceLocked(lock, student_id, from_course_id);
+    replaceCourseLocked(lock, student_id, from_course_id, to_course_id);
+}
+
+inline std::unordered_set<int> StudentManager::getStudentCourses(int student_id) const {
+    if (filterRejects(student_id)) {
+        return {};
+    }
+    auto lock = lockSharedWithDeadline(mtx);
+    const Student *student = findRecord(student_id);
+    if (student == nullptr) {
+        filter_false_positives.fetch_add(1, std::memory_order_relaxed);
+        return {};
+    }
+    return student->courses;
+}
+
+inline std::vector<int> StudentManager::getStudentIds() const {
+    std::vector<int> ids;
+    auto lock = lockSharedWithDeadline(mtx);
+    ids.reserve(student_records.size());
+    student_records.forEach([&ids](int id, const std::shared_ptr<Student> &) { ids.push_back(id); });
+    return ids;
+}
+
+inline void StudentManager::forEachStudent(const std::function<void(const Student &)> &visitor) const {
+    auto lock = lockSharedWithDeadline(mtx);
+    forEachStudentUnlocked(visitor);
+}
+
+inline bool StudentManager::visitStudent(int id, const std::function<void(const Student &)> &visitor) const {
+    if (filterRejects(id)) {
+        return false;
+    }
+    auto lock = lockSharedWithDeadline(mtx);
+    if (visitStudentUnlocked(id, visitor)) {
+        return true;
+    }
+    filter_false_positives.fetch_add(1, std::memory_order_relaxed);
+    return false;
+}
+
+inline std::size_t StudentManager::getStudentCourses(int student_id, int *out, std::size_t capacity) const {
+    if (filterRejects(student_id)) {
+        return 0;
+    }
+    auto lock = lockSharedWithDeadline(mtx);
+    const Student *student = findRecord(student_id);
+    if (student == nullptr) {
+        filter_false_positives.fetch_add(1, std::memory_order_relaxed);
+        return 0;
+    }
+    std::size_t count = 0;
+    for (int course_id : student->courses) {
+        if (count < capacity) {
+            out[count] = course_id;
+        }
+        ++count;
+    }
+    return count;
+}
+
+inline void StudentManager::reserve(std::size_t count) {
+    auto lock = lockExclusiveWithDeadline(mtx);
+    student_records.reserve(count);
+    dirty_ids.reserve(count);
+    if (id_filters.empty() || id_filters.back()->capacity() < count) {
+        rebuildFilter(count);
+    }
+}
+
+inline std::string StudentManager::getStudentName(int student_id) const {
+    if (filterRejects(student_id)) {
+        throw std::runtime_error("Student not found");
+    }
+    auto lock = lockSharedWithDeadline(mtx);
+    return requireRecord(student_id).name;
+}
+
+inline SnapshotStats StudentManager::writeSnapshot(std::ostream &out, SnapshotMode mode, std::uint64_t &checkpoint) {
+    auto lock = lockSharedWithDeadline(mtx);
+    checkpoint = mutation_sequence;
+    if (mode == SnapshotMode::Full) {
+        return writeFullSnapshotUnlocked(out);
+    }
+    SnapshotStats stats;
+    writeSnapshotValue(out, kStudentSnapshotMagic, stats.bytes);
+    writeSnapshotValue(out, static_cast<std::uint8_t>(mode), stats.bytes);
+    for (const auto &dirty : dirty_ids) {
+        const Student *student = findRecord(dirty.first);
+        if (student == nullptr) {
+            continue;
+        }
+        writeSnapshotValue(out, std::uint8_t(1), stats.bytes);
+        writeSnapshotValue(out, static_cast<std::int32_t>(student->student_id), stats.bytes);
+        writeSnapshotString(out, student->name, stats.bytes);
+        writeSnapshotValue(out, static_cast<std::uint32_t>(student->courses.size()), stats.bytes);
+        for (int course_id : student->courses) {
+            writeSnapshotValue(out, static_cast<std::int32_t>(course_id), stats.bytes);
+        }
+        ++stats.records;
+    }
+    writeSnapshotValue(out, std::uint8_t(0), stats.bytes);
+    return stats;
+}
+
+inline void StudentManager::commitSnapshot(std::uint64_t checkpoint) {
+    auto lock = lockExclusiveWithDeadline(mtx);
+    for (auto it = dirty_ids.begin(); it != dirty_ids.end();) {
+        if (it->second <= checkpoint) {
+            it = dirty_ids.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+inline SnapshotStats StudentManager::loadSnapshot(std::istream &in) {
+    SnapshotStats stats;
+    auto lock = lockExclusiveWithDeadline(mtx);
+    readSnapshotHeader(in, kStudentSnapshotMagic, stats.bytes);
+    while (readSnapshotValue<std::uint8_t>(in, stats.bytes) != 0) {
+        std::shared_ptr<Student> record = std::make_shared<Student>();
+        record->student_id = readSnapshotValue<std::int32_t>(in, stats.bytes);
+        record->name = readSnapshotString(in, stats.bytes);
+        std::uint32_t courses = readSnapshotValue<std::uint32_t>(in, stats.bytes);
+        record->courses.reserve(courses);
+        for (std::uint32_t i = 0; i < courses; ++i) {
+            record->courses.insert(readSnapshotValue<std::int32_t>(in, stats.bytes));
+        }
+        int id = record->student_id;
+        student_records.assign(id, std::move(record));
+        filterInsert(id);
+        ++stats.records;
+    }
+    return stats;
+}
+
+inline std::uint64_t StudentManager::getRecordVersion(int id) const {
+    if (filterRejects(id)) {
+        return 0;
+    }
+    auto lock = lockSharedWithDeadline(mtx);
+    const Student *student = findRecord(id);
+    return student == nullptr ? 0 : student->version;
+}
+
+inline LookupFilterStats StudentManager::getLookupFilterStats() const {
+    LookupFilterStats stats;
+    stats.lookups = filter_lookups.load(std::memory_order_relaxed);
+    stats.filtered = filter_rejections.load(std::memory_order_relaxed);
+    stats.false_positives = filter_false_positives.load(std::memory_order_relaxed);
+    return stats;
+}
+
+inline void StudentManager::forEachStudentUnlocked(const std::function<void(const Student &)> &visitor) const {
+    student_records.forEach([&visitor](int, const std::shared_ptr<Student> &student) { visitor(*student); });
+}
+
+inline bool StudentManager::visitStudentUnlocked(int id, const std::function<void(const Student &)> &visitor) const {
+    const Student *student = findRecord(id);
+    if (student == nullptr) {
+        return false;
+    }
+    visitor(*student);
+    return true;
+}
+
+inline SnapshotStats StudentManager::writeFullSnapshotUnlocked(std::ostream &out) const {
+    SnapshotStats stats;
+    writeSnapshotValue(out, kStudentSnapshotMagic, stats.bytes);
+    writeSnapshotValue(out, static_cast<std::uint8_t>(SnapshotMode::Full), stats.bytes);
+    student_records.forEach([&out, &stats](int, const std::shared_ptr<Student> &student) {
+        writeSnapshotValue(out, std::uint8_t(1), stats.bytes);
+        writeSnapshotValue(out, static_cast<std::int32_t>(student->student_id), stats.bytes);
+        writeSnapshotString(out, student->name, stats.bytes);
+        writeSnapshotValue(out, static_cast<std::uint32_t>(student->courses.size()), stats.bytes);
+        for (int course_id : student->courses) {
+            writeSnapshotValue(out, static_cast<std::int32_t>(course_id), stats.bytes);
+        }
+        ++stats.records;
+    });
+    writeSnapshotValue(out, std::uint8_t(0), stats.bytes);
+    return stats;
+}
+
+inline const std::string &StudentManager::checkReplaceLocked(const std::unique_lock<std::shared_timed_mutex> &, int student_id, int from_course_id) const {
+    const Student &student = requireRecord(student_id);
+    if (student.courses.count(from_course_id) == 0) {
+        throw std::runtime_error("Student is not enrolled in the course being dropped");
+    }
+    return student.name;
+}
+
+inline void StudentManager::replaceCourseLocked(const std::unique_lock<std::shared_timed_mutex> &, int student_id, int from_course_id, int to_course_id) {
+    Student *student = findRecord(student_id);
+    if (student == nullptr) {
+        return;
+    }
+    recycleNode(spare_course_nodes, student->courses.extract(from_course_id));
+    insertRecycled(student->courses, spare_course_nodes, to_course_id);
+    ++student->version;
+    markDirty(student_id);
+}
+
+inline const std::string &StudentManager::checkEnrollLocked(const std::unique_lock<std::shared_timed_mutex> &, int student_id, int course_id) const {
+    const Student &student = requireRecord(student_id);
+    if (student.courses.count(course_id) != 0) {
+        throw std::runtime_error("Student is already enrolled in the course");
+    }
+    return student.name;
+}
+
+inline void StudentManager::enrollInCourseLocked(const std::unique_lock<std::shared_timed_mutex> &, int student_id, int course_id) {
+    Student *student = findRecord(student_id);
+    if (student == nullptr) {
+        return;
+    }
+    insertRecycled(student->courses, spare_course_nodes, course_id);
+    ++student->version;
+    markDirty(student_id);
+}
+
+inline bool StudentManager::dropCourseLocked(const std::unique_lock<std::shared_timed_mutex> &, int student_id, int course_id) {
+    Student &student = requireRecord(student_id);
+    std::unordered_set<int>::node_type node = student.courses.extract(course_id);
+    if (node.empty()) {
+        return false;
+    }
+    recycleNode(spare_course_nodes, std::move(node));
+    ++student.version;
+    markDirty(student_id);
+    return true;
+}
+
+inline Student *StudentManager::findRecord(int id) const {
+    const std::shared_ptr<Student> *record = student_records.find(id);
+    return record == nullptr ? nullptr : record->get();
+}
+
+inline Student &StudentManager::requireRecord(int id) const {
+    Student *student = findRecord(id);
+    if (student == nullptr) {
+        filter_false_positives.fetch_add(1, std::memory_order_relaxed);
+        throw std::runtime_error("Student not found");
+    }
+    return *student;
+}
+
+inline bool StudentManager::filterRejects(int id) const {
+    const IdBloomFilter *filter = id_filter.load(std::memory_order_acquire);
+    if (filter == nullptr) {
+        return false;
+    }
+    filter_lookups.fetch_add(1, std::memory_order_relaxed);
+    if (filter->mayContain(id)) {
+        return false;
+    }
+    filter_rejections.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+inline void StudentManager::filterInsert(int id) {
+    if (id_filters.empty() || student_records.size() > id_filters.back()->capacity()) {
+        std::size_t expected = id_filters.empty() ? std::size_t(1) << 16 : id_filters.back()->capacity() * 2;
+        rebuildFilter(std::max(expected, student_records.size()));
+        return;
+    }
+    id_filters.back()->insert(id);
+}
+
+inline void StudentManager::rebuildFilter(std::size_t expected_ids) {
+    std::unique_ptr<IdBloomFilter> filter(new IdBloomFilter(expected_ids));
+    student_records.forEach([&filter](int id, const std::shared_ptr<Student> &) { filter->insert(id); });
+    id_filter.store(filter.get(), std::memory_order_release);
+    id_filters.push_back(std::move(filter));
+}
+
+inline void StudentManager::markDirty(int id) {
+    dirty_ids[id] = ++mutation_sequence;
+}
+
+inline void FacultyManager::addFaculty(int faculty_id, const std::string &name) {
+    addFaculty(faculty_id, std::string(name));
+}
+
+inline void FacultyManager::addFaculty(int faculty_id, std::string &&name) {
+    std::shared_ptr<Faculty> record = std::make_shared<Faculty>();
+    record->faculty_id = faculty_id;
+    record->name = std::move(name);
+    record->metadata.store(makeFacultyMetadata(*record));
+    auto lock = lockExclusiveWithDeadline(mtx);
+    if (!faculty_records.emplace(faculty_id, std::move(record)).second) {
+        throw std::runtime_error("Faculty already exists");
+    }
+    filterInsert(faculty_id);
+    markDirty(faculty_id);
+}
+
+inline void FacultyManager::assignCourse(int faculty_id, int course_id) {
+    if (filterRejects(faculty_id)) {
+        throw std::runtime_error("Faculty not found");
+    }
+    auto lock = lockExclusiveWithDeadline(mtx);
+    assignCourseLocked(lock, faculty_id, course_id);
+}
+
+inline std::unordered_set<int> FacultyManager::getFacultyCourses(int faculty_id) const {
+    if (filterRejects(faculty_id)) {
+        return {};
+    }
+    auto lock = lockSharedWithDeadline(mtx);
+    const Faculty *faculty = findRecord(faculty_id);
+    if (faculty == nullptr) {
+        filter_false_positives.fetch_add(1, std::memory_order_relaxed);
+        return {};
+    }
+    return faculty->courses;
+}
+
+inline void FacultyManager::forEachFaculty(const std::function<void(const Faculty &)> &visitor) const {
+    auto lock = lockSharedWithDeadline(mtx);
+    forEachFacultyUnlocked(visitor);
+}
+
+inline bool FacultyManager::visitFaculty(int id, const std::function<void(const Faculty &)> &visitor) const {
+    if (filterRejects(id)) {
+        return false;
+    }
+    auto lock = lockSharedWithDeadline(mtx);
+    if (visitFacultyUnlocked(id, visitor)) {
+        return true;
+    }
+    filter_false_positives.fetch_add(1, std::memory_order_relaxed);
+    return false;
+}
+
+inline std::size_t FacultyManager::getFacultyCourses(int faculty_id, int *out, std::size_t capacity) const {
+    if (filterRejects(faculty_id)) {
+        return 0;
+    }
+    auto lock = lockSharedWithDeadline(mtx);
+    const Faculty *faculty = findRecord(faculty_id);
+    if (faculty == nullptr) {
+        filter_false_positives.fetch_add(1, std::memory_order_relaxed);
+        return 0;
+    }
+    std::size_t count = 0;
+    for (int course_id : faculty->courses) {
+        if (count < capacity) {
+            out[count] = course_id;
+        }
+        ++count;
+    }
+    return count;
+}
+
+inline FacultyMetadata FacultyManager::getFacultyMetadata(int faculty_id) const {
+    if (filterRejects(faculty_id)) {
+        throw std::runtime_error("Faculty not found");
+    }
+#if defined(UNIVERSITY_LOCKFREE_RECORDS)
+    EpochDomain::Guard guard = faculty_records.pin();
+#else
+    auto lock = lockSharedWithDeadline(mtx);
+#endif
+    return requireRecord(faculty_id).metadata.load();
+}
+
+inline void FacultyManager::setFacultyName(int faculty_id, const std::string &name) {
+    if (filterRejects(faculty_id)) {
+        throw std::runtime_error("Faculty not found");
+    }
+    auto lock = lockExclusiveWithDeadline(mtx);
+    setFacultyNameLocked(lock, faculty_id, name);
+}
+
+inline void FacultyManager::reserve(std::size_t count) {
+    auto lock = lockExclusiveWithDeadline(mtx);
+    faculty_records.reserve(count);
+    dirty_ids.reserve(count);
+    if (id_filters.empty() || id_filters.back()->capacity() < count) {
+        rebuildFilter(count);
+    }
+}
+
+inline SnapshotStats FacultyManager::writeSnapshot(std::ostream &out, SnapshotMode mode, std::uint64_t &checkpoint) {
+    auto lock = lockSharedWithDeadline(mtx);
+    checkpoint = mutation_sequence;
+    if (mode == SnapshotMode::Full) {
+        return writeFullSnapshotUnlocked(out);
+    }
+    SnapshotStats stats;
+    writeSnapshotValue(out, kFacultySnapshotMagic, stats.bytes);
+    writeSnapshotValue(out, static_cast<std::uint8_t>(mode), stats.bytes);
+    for (const auto &dirty : dirty_ids) {
+        const Faculty *faculty = findRecord(dirty.first);
+        if (faculty == nullptr) {
+            continue;
+        }
+        writeSnapshotValue(out, std::uint8_t(1), stats.bytes);
+        writeSnapshotValue(out, static_cast<std::int32_t>(faculty->faculty_id), stats.bytes);
+        writeSnapshotString(out, faculty->name, stats.bytes);
+        writeSnapshotValue(out, static_cast<std::uint32_t>(faculty->courses.size()), stats.bytes);
+        for (int course_id : faculty->courses) {
+            writeSnapshotValue(out, static_cast<std::int32_t>(course_id), stats.bytes);
+        }
+        ++stats.records;
+    }
+    writeSnapshotValue(out, std::uint8_t(0), stats.bytes);
+    return stats;
+}
+
+inline void FacultyManager::commitSnapshot(std::uint64_t checkpoint) {
+    auto lock = lockExclusiveWithDeadline(mtx);
+    for (auto it = dirty_ids.begin(); it != dirty_ids.end();) {
+        if (it->second <= checkpoint) {
+            it = dirty_ids.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+inline SnapshotStats FacultyManager::loadSnapshot(std::istream &in) {
+    SnapshotStats stats;
+    auto lock = lockExclusiveWithDeadline(mtx);
+    readSnapshotHeader(in, kFacultySnapshotMagic, stats.bytes);
+    while (readSnapshotValue<std::uint8_t>(in, stats.bytes) != 0) {
+        std::shared_ptr<Faculty> record = std::make_shared<Faculty>();
+        record->faculty_id = readSnapshotValue<std::int32_t>(in, stats.bytes);
+        record->name = readSnapshotString(in, stats.bytes);
+        std::uint32_t courses = readSnapshotValue<std::uint32_t>(in, stats.bytes);
+        record->courses.reserve(courses);
+        for (std::uint32_t i = 0; i < courses; ++i) {
+            record->courses.insert(readSnapshotValue<std::int32_t>(in, stats.bytes));
+        }
+        record->metadata.store(makeFacultyMetadata(*record));
+        int id = record->faculty_id;
+        faculty_records.assign(id, std::move(record));
+        filterInsert(id);
+        ++stats.records;
+    }
+    return stats;
+}
+
+inline std::uint64_t FacultyManager::getRecordVersion(int id) const {
+    if (filterRejects(id)) {
+        return 0;
+    }
+    auto lock = lockSharedWithDeadline(mtx);
+    const Faculty *faculty = findRecord(id);
+    return faculty == nullptr ? 0 : faculty->version;
+}
+
+inline LookupFilterStats FacultyManager::getLookupFilterStats() const {
+    LookupFilterStats stats;
+    stats.lookups = filter_lookups.load(std::memory_order_relaxed);
+    stats.filtered = filter_rejections.load(std::memory_order_relaxed);
+    stats.false_positives = filter_false_positives.load(std::memory_order_relaxed);
+    return stats;
+}
+
+inline void FacultyManager::forEachFacultyUnlocked(const std::function<void(const Faculty &)> &visitor) const {
+    faculty_records.forEach([&visitor](int, const std::shared_ptr<Faculty> &faculty) { visitor(*faculty); });
+}
+
+inline bool FacultyManager::visitFacultyUnlocked(int id, const std::function<void(const Faculty &)> &visitor) const {
+    const Faculty *faculty = findRecord(id);
+    if (faculty == nullptr) {
+        return false;
+    }
+    visitor(*faculty);
+    return true;
+}
+
+inline SnapshotStats FacultyManager::writeFullSnapshotUnlocked(std::ostream &out) const {
+    SnapshotStats stats;
+    writeSnapshotValue(out, kFacultySnapshotMagic, stats.bytes);
+    writeSnapshotValue(out, static_cast<std::uint8_t>(SnapshotMode::Full), stats.bytes);
+    faculty_records.forEach([&out, &stats](int, const std::shared_ptr<Faculty> &faculty) {
+        writeSnapshotValue(out, std::uint8_t(1), stats.bytes);
+        writeSnapshotValue(out, static_cast<std::int32_t>(faculty->faculty_id), stats.bytes);
+        writeSnapshotString(out, faculty->name, stats.bytes);
+        writeSnapshotValue(out, static_cast<std::uint32_t>(faculty->courses.size()), stats.bytes);
+        for (int course_id : faculty->courses) {
+            writeSnapshotValue(out, static_cast<std::int32_t>(course_id), stats.bytes);
+        }
+        ++stats.records;
+    });
+    writeSnapshotValue(out, std::uint8_t(0), stats.bytes);
+    return stats;
+}
+
+inline void FacultyManager::assignCourseLocked(const std::unique_lock<std::shared_timed_mutex> &, int faculty_id, int course_id) {
+    Faculty &faculty = requireRecord(faculty_id);
+    if (faculty.courses.insert(course_id).second) {
+        ++faculty.version;
+        markDirty(faculty_id);
+    }
+}
+
+inline void FacultyManager::unassignCourseLocked(const std::unique_lock<std::shared_timed_mutex> &, int faculty_id, int course_id) {
+    Faculty *faculty = findRecord(faculty_id);
+    if (faculty != nullptr && faculty->courses.erase(course_id) != 0) {
+        ++faculty->version;
+        markDirty(faculty_id);
+    }
+}
+
+inline void FacultyManager::setFacultyNameLocked(const std::unique_lock<std::shared_timed_mutex> &, int faculty_id, const std::string &name) {
+    Faculty &faculty = requireRecord(faculty_id);
+    faculty.name = name;
+    faculty.metadata.store(makeFacultyMetadata(faculty));
+    ++faculty.version;
+    markDirty(faculty_id);
+}
+
+inline Faculty *FacultyManager::findRecord(int id) const {
+    const std::shared_ptr<Faculty> *record = faculty_records.find(id);
+    return record == nullptr ? nullptr : record->get();
+}
+
+inline Faculty &FacultyManager::requireRecord(int id) const {
+    Faculty *faculty = findRecord(id);
+    if (faculty == nullptr) {
+        filter_false_positives.fetch_add(1, std::memory_order_relaxed);
+        throw std::runtime_error("Faculty not found");
+    }
+    return *faculty;
+}
+
+inline bool FacultyManager::filterRejects(int id) const {
+    const IdBloomFilter *filter = id_filter.load(std::memory_order_acquire);
+    if (filter == nullptr) {
+        return false;
+    }
+    filter_lookups.fetch_add(1, std::memory_order_relaxed);
+    if (filter->mayContain(id)) {
+        return false;
+    }
+    filter_rejections.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+inline void FacultyManager::filterInsert(int id) {
+    if (id_filters.empty() || faculty_records.size() > id_filters.back()->capacity()) {
+        std::size_t expected = id_filters.empty() ? std::size_t(1) << 16 : id_filters.back()->capacity() * 2;
+        rebuildFilter(std::max(expected, faculty_records.size()));
+        return;
+    }
+    id_filters.back()->insert(id);
+}
+
+inline void FacultyManager::rebuildFilter(std::size_t expected_ids) {
+    std::unique_ptr<IdBloomFilter> filter(new IdBloomFilter(expected_ids));
+    faculty_records.forEach([&filter](int id, const std::shared_ptr<Faculty> &) { filter->insert(id); });
+    id_filter.store(filter.get(), std::memory_order_release);
+    id_filters.push_back(std::move(filter));
+}
+
+inline void FacultyManager::markDirty(int id) {
+    dirty_ids[id] = ++mutation_sequence;
+}
+
+inline void CourseManager::addCourse(int course_id, const std::string &name, int faculty_id) {
+    addCourse(course_id, std::string(name), faculty_id);
+}
+
+inline void CourseManager::addCourse(int course_id, std::string &&name, int faculty_id) {
+    std::shared_ptr<Course> record = std::make_shared<Course>();
+    record->course_id = course_id;
+    record->name = std::move(name);
+    record->faculty_id = faculty_id;
+    record->metadata.store(makeCourseMetadata(*record));
+    auto lock = lockExclusiveWithDeadline(mtx);
+    if (frozen_catalog) {
+        throw std::runtime_error("Course catalog is frozen");
+    }
+    if (!course_records.emplace(course_id, std::move(record)).second) {
+        throw std::runtime_error("Course already exists");
+    }
+    filterInsert(course_id);
+    markDirty(course_id);
+}
+
+inline void CourseManager::enrollStudent(int course_id, int student_id) {
+    enrollStudent(course_id, student_id, std::string());
+}
+
+inline void CourseManager::enrollStudent(int course_id, int student_id, const std::string &student_name) {
+    if (filterRejects(course_id)) {
+        throw std::runtime_error("Course not found");
+    }
+    auto lock = lockExclusiveWithDeadline(mtx);
+    checkEnrollLocked(lock, course_id, student_id);
+    enrollStudentLocked(lock, course_id, student_id, student_name);
+}
+
+inline void CourseManager::dropStudent(int course_id, int student_id) {
+    if (filterRejects(course_id)) {
+        throw std::runtime_error("Course not found");
+    }
+    auto lock = lockExclusiveWithDeadline(mtx);
+    dropStudentLocked(lock, course_id, student_id, std::string());
+}
+
+inline void CourseManager::swapStudent(int student_id, int from_course_id, int to_course_id, const std::string &student_name) {
+    if (filterRejects(from_course_id) || filterRejects(to_course_id)) {
+        throw std::runtime_error("Course not found");
+    }
+    auto lock = lockExclusiveWithDeadline(mtx);
+    checkSwapLocked(lock, student_id, from_course_id, to_course_id);
+    swapStudentLocked(lock, student_id, from_course_id, to_course_id, student_name);
+}
+
+inline std::unordered_set<int> CourseManager::getCourseStudents(int course_id) const {
+    if (filterRejects(course_id)) {
+        return {};
+    }
+    auto lock = lockSharedWithDeadline(mtx);
+    const Course *course = findRecord(course_id);
+    if (course == nullptr) {
+        filter_false_positives.fetch_add(1, std::memory_order_relaxed);
+        return {};
+    }
+    return course->students;
+}
+
+inline bool CourseManager::isEnrolled(int course_id, int student_id) const {
+    if (filterRejects(course_id)) {
+        return false;
+    }
+    auto lock = lockSharedWithDeadline(mtx);
+    const Course *course = findRecord(course_id);
+    if (course == nullptr) {
+        filter_false_positives.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    return course->students.count(student_id) != 0;
+}
+
+inline int CourseManager::getCourseFaculty(int course_id) const {
+    if (filterRejects(course_id)) {
+        throw std::runtime_error("Course not found");
+    }
+    auto lock = lockSharedWithDeadline(mtx);
+    return requireRecord(course_id).faculty_id;
+}
+
+inline CourseMetadata CourseManager::getCourseMetadata(int course_id) const {
+    if (filterRejects(course_id)) {
+        throw std::runtime_error("Course not found");
+    }
+#if defined(UNIVERSITY_LOCKFREE_RECORDS)
+    // course_records holds every course even while the catalog is frozen.
+    EpochDomain::Guard guard = course_records.pin();
+    const std::shared_ptr<Course> *record = course_records.find(course_id);
+    if (record == nullptr) {
+        filter_false_positives.fetch_add(1, std::memory_order_relaxed);
+        throw std::runtime_error("Course not found");
+    }
+    return (*record)->metadata.load();
+#else
+    auto lock = lockSharedWithDeadline(mtx);
+    return requireRecord(course_id).metadata.load();
+#endif
+}
+
+inline std::string CourseManager::getCourseName(int course_id) const {
+    if (filterRejects(course_id)) {
+        throw std::runtime_error("Course not found");
+    }
+    auto lock = lockSharedWithDeadline(mtx);
+    return requireRecord(course_id).name;
+}
+
+inline void CourseManager::setCourseName(int course_id, const std::string &name) {
+    if (filterRejects(course_id)) {
+        throw std::runtime_error("Course not found");
+    }
+    auto lock = lockExclusiveWithDeadline(mtx);
+    setCourseNameLocked(lock, course_id, name);
+}
+
+inline void CourseManager::setCourseFaculty(int course_id, int faculty_id) {
+    if (filterRejects(course_id)) {
+        throw std::runtime_error("Course not found");
+    }
+    auto lock = lockExclusiveWithDeadline(mtx);
+    setCourseFacultyLocked(lock, course_id, faculty_id);
+}
+
+inline void CourseManager::setCourseCapacity(int course_id, int capacity) {
+    if (filterRejects(course_id)) {
+        throw std::runtime_error("Course not found");
+    }
+    auto lock = lockExclusiveWithDeadline(mtx);
+    setCourseCapacityLocked(lock, course_id, capacity);
+}
+
+inline int CourseManager::getCourseCapacity(int course_id) const {
+    if (filterRejects(course_id)) {
+        throw std::runtime_error("Course not found");
+    }
+    auto lock = lockSharedWithDeadline(mtx);
+    return requireRecord(course_id).capacity;
+}
+
+inline int CourseManager::getOpenSeats(int course_id) const {
+    if (filterRejects(course_id)) {
+        throw std::runtime_error("Course not found");
+    }
+    auto lock = lockSharedWithDeadline(mtx);
+    if (!holdsBehind()) {
+        return openSeatsOf(requireRecord(course_id));
+    }
+    lock.unlock();
+    auto exclusive = lockExclusiveWithDeadline(mtx);
+    advanceHolds();
+    return openSeatsOf(requireRecord(course_id));
+}
+
+inline void CourseManager::setCourseSchedule(int course_id, int family_id, const MeetingMask &meetings) {
+    if (filterRejects(course_id)) {
+        throw std::runtime_error("Course not found");
+    }
+    auto lock = lockExclusiveWithDeadline(mtx);
+    setCourseScheduleLocked(lock, course_id, family_id, meetings);
+}
+
+inline MeetingMask CourseManager::getCourseMeetings(int course_id) const {
+    if (filterRejects(course_id)) {
+        throw std::runtime_error("Course not found");
+    }
+    auto lock = lockSharedWithDeadline(mtx);
+    return requireRecord(course_id).meetings;
+}
+
+inline std::vector<int> CourseManager::getFamilySections(int family_id) const {
+    auto lock = lockSharedWithDeadline(mtx);
+    auto it = family_sections.find(family_id);
+    return it == family_sections.end() ? std::vector<int>() : it->second;
+}
+
+inline std::vector<int> CourseManager::findOpenSiblings(int course_id, const MeetingMask &busy) const {
+    if (filterRejects(course_id)) {
+        throw std::runtime_error("Course not found");
+    }
+    auto shared = lockSharedWithDeadline(mtx);
+    std::unique_lock<std::shared_timed_mutex> exclusive;
+    if (holdsBehind()) {
+        shared.unlock();
+        exclusive = lockExclusiveWithDeadline(mtx);
+        advanceHolds();
+    }
+    const Course &course = requireRecord(course_id);
+    std::vector<std::pair<std::size_t, int>> candidates;
+    auto open = family_open_sections.find(course.family_id);
+    if (course.family_id != -1 && open != family_open_sections.end()) {
+        for (int sibling_id : open->second) {
+            const Course *sibling = sibling_id == course_id ? nullptr : findRecord(sibling_id);
+            if (sibling != nullptr && !(sibling->meetings & busy).any()) {
+                candidates.emplace_back(sibling->meetings.count(), sibling_id);
+            }
+        }
+    }
+    std::sort(candidates.begin(), candidates.end());
+    std::vector<int> siblings;
+    siblings.reserve(candidates.size());
+    for (const auto &candidate : candidates) {
+        siblings.push_back(candidate.second);
+    }
+    return siblings;
+}
+
+inline SeatHoldId CourseManager::holdSeat(int course_id, int student_id, std::chrono::milliseconds ttl) {
+    if (filterRejects(course_id)) {
+        throw std::runtime_error("Course not found");
+    }
+    auto lock = lockExclusiveWithDeadline(mtx);
+    return holdSeatLocked(lock, course_id, student_id, ttl);
+}
+
+inline bool CourseManager::releaseHold(SeatHoldId hold) {
+    auto lock = lockExclusiveWithDeadline(mtx);
+    SeatHold released;
+    return releaseHoldLocked(lock, hold, released);
+}
+
+inline SeatHold CourseManager::confirmHold(SeatHoldId hold, const std::string &student_name) {
+    auto lock = lockExclusiveWithDeadline(mtx);
+    if (findHoldLocked(lock, hold) == nullptr) {
+        throw std::runtime_error("Seat hold has expired or was released");
+    }
+    return confirmHoldLocked(lock, hold, student_name);
+}
+
+inline std::size_t CourseManager::expireHolds() {
+    auto lock = lockExclusiveWithDeadline(mtx);
+    return advanceHolds();
+}
+
+inline std::vector<int> CourseManager::getCourseIds() const {
+    std::vector<int> ids;
+    auto lock = lockSharedWithDeadline(mtx);
+    ids.reserve(course_records.size());
+    course_records.forEach([&ids](int id, const std::shared_ptr<Course> &) { ids.push_back(id); });
+    return ids;
+}
+
+inline void CourseManager::forEachCourse(const std::function<void(const Course &)> &visitor) const {
+    auto lock = lockSharedWithDeadline(mtx);
+    forEachCourseUnlocked(visitor);
+}
+
+inline bool CourseManager::visitCourse(int id, const std::function<void(const Course &)> &visitor) const {
+    if (filterRejects(id)) {
+        return false;
+    }
+    auto lock = lockSharedWithDeadline(mtx);
+    if (visitCourseUnlocked(id, visitor)) {
+        return true;
+    }
+    filter_false_positives.fetch_add(1, std::memory_order_relaxed);
+    return false;
+}
+
+inline std::size_t CourseManager::getCourseStudents(int course_id, int *out, std::size_t capacity) const {
+    if (filterRejects(course_id)) {
+        return 0;
+    }
+    auto lock = lockSharedWithDeadline(mtx);
+    const Course *course = findRecord(course_id);
+    if (course == nullptr) {
+        filter_false_positives.fetch_add(1, std::memory_order_relaxed);
+        return 0;
+    }
+    std::size_t count = 0;
+    for (int student_id : course->students) {
+        if (count < capacity) {
+            out[count] = student_id;
+        }
+        ++count;
+    }
+    return count;
+}
+
+inline void CourseManager::reserve(std::size_t count) {
+    auto lock = lockExclusiveWithDeadline(mtx);
+    course_records.reserve(count);
+    dirty_ids.reserve(count);
+    if (id_filters.empty() || id_filters.back()->capacity() < count) {
+        rebuildFilter(count);
+    }
+}
+
+inline RosterPage CourseManager::getCourseRoster(int course_id, RosterOrder order, const RosterCursor &after, std::size_t page_size) const {
+    if (filterRejects(course_id)) {
+        throw std::runtime_error("Course not found");
+    }
+    auto lock = lockSharedWithDeadline(mtx);
+    const Course &course = requireRecord(course_id);
+    RosterPage page;
+    page.next = after;
+    page.student_ids.reserve(std::min(page_size, course.students.size()));
+    if (order == RosterOrder::ByName) {
+        auto it = after.student_id == -1 ? course.roster_by_name.begin()
+                                         : course.roster_by_name.upper_bound(std::make_pair(after.name, after.student_id));
+        for (; it != course.roster_by_name.end() && page.student_ids.size() < page_size; ++it) {
+            page.student_ids.push_back(it->second);
+            page.next.name = it->first;
+            page.next.student_id = it->second;
+        }
+        page.has_more = it != course.roster_by_name.end();
+    } else {
+        auto it = after.student_id == -1 ? course.roster_by_id.begin() : course.roster_by_id.upper_bound(after.student_id);
+        for (; it != course.roster_by_id.end() && page.student_ids.size() < page_size; ++it) {
+            page.student_ids.push_back(*it);
+            page.next.name.clear();
+            page.next.student_id = *it;
+        }
+        page.has_more = it != course.roster_by_id.end();
+    }
+    return page;
+}
+
+inline SnapshotStats CourseManager::writeSnapshot(std::ostream &out, SnapshotMode mode, std::uint64_t &checkpoint) {
+    auto lock = lockSharedWithDeadline(mtx);
+    checkpoint = mutation_sequence;
+    if (mode == SnapshotMode::Full) {
+        return writeFullSnapshotUnlocked(out);
+    }
+    SnapshotStats stats;
+    writeSnapshotValue(out, kCourseSnapshotMagic, stats.bytes);
+    writeSnapshotValue(out, static_cast<std::uint8_t>(mode), stats.bytes);
+    for (const auto &dirty : dirty_ids) {
+        const Course *course = findRecord(dirty.first);
+        if (course == nullptr) {
+            continue;
+        }
+        writeSnapshotValue(out, std::uint8_t(1), stats.bytes);
+        writeCourseRecord(out, *course, stats.bytes);
+        ++stats.records;
+    }
+    writeSnapshotValue(out, std::uint8_t(0), stats.bytes);
+    return stats;
+}
+
+inline void CourseManager::commitSnapshot(std::uint64_t checkpoint) {
+    auto lock = lockExclusiveWithDeadline(mtx);
+    for (auto it = dirty_ids.begin(); it != dirty_ids.end();) {
+        if (it->second <= checkpoint) {
+            it = dirty_ids.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+inline SnapshotStats CourseManager::loadSnapshot(std::istream &in) {
+    SnapshotStats stats;
+    auto lock = lockExclusiveWithDeadline(mtx);
+    readSnapshotHeader(in, kCourseSnapshotMagic, stats.bytes);
+    while (readSnapshotValue<std::uint8_t>(in, stats.bytes) != 0) {
+        int id = readSnapshotValue<std::int32_t>(in, stats.bytes);
+        std::string name = readSnapshotString(in, stats.bytes);
+        int faculty_id = readSnapshotValue<std::int32_t>(in, stats.bytes);
+        int capacity = readSnapshotValue<std::int32_t>(in, stats.bytes);
+        int family_id = readSnapshotValue<std::int32_t>(in, stats.bytes);
+        MeetingMask meetings = decodeMeetingMask(readSnapshotString(in, stats.bytes));
+        std::uint32_t enrolled = readSnapshotValue<std::uint32_t>(in, stats.bytes);
+        std::set<std::pair<std::string, int>> roster_by_name;
+        for (std::uint32_t i = 0; i < enrolled; ++i) {
+            std::string student_name = readSnapshotString(in, stats.bytes);
+            int student_id = readSnapshotValue<std::int32_t>(in, stats.bytes);
+            roster_by_name.emplace(std::move(student_name), student_id);
+        }
+
+        // Existing records are updated in place so a frozen catalog, which
+        // shares the record pointers, sees the restored contents.
+        Course *course = findRecord(id);
+        if (course == nullptr) {
+            if (frozen_catalog) {
+                throw std::runtime_error("Course catalog is frozen");
+            }
+            std::shared_ptr<Course> record = std::make_shared<Course>();
+            record->course_id = id;
+            course = record.get();
+            course_records.emplace(id, std::move(record));
+            filterInsert(id);
+        } else {
+            ++course->version;
+        }
+        course->name = std::move(name);
+        course->faculty_id = faculty_id;
+        course->capacity = capacity;
+        course->held_seats = 0;
+        course->students.clear();
+        course->roster_by_id.clear();
+        for (const auto &entry : roster_by_name) {
+            course->students.insert(entry.second);
+            course->roster_by_id.insert(entry.second);
+        }
+        course->roster_by_name = std::move(roster_by_name);
+        course->metadata.store(makeCourseMetadata(*course));
+        moveToFamily(*course, family_id);
+        course->meetings = meetings;
+        refreshOpenSection(*course);
+        ++stats.records;
+    }
+    return stats;
+}
+
+inline std::uint64_t CourseManager::getRecordVersion(int id) const {
+    if (filterRejects(id)) {
+        return 0;
+    }
+    auto lock = lockSharedWithDeadline(mtx);
+    const Course *course = findRecord(id);
+    return course == nullptr ? 0 : course->version;
+}
+
+inline LookupFilterStats CourseManager::getLookupFilterStats() const {
+    LookupFilterStats stats;
+    stats.lookups = filter_lookups.load(std::memory_order_relaxed);
+    stats.filtered = filter_rejections.load(std::memory_order_relaxed);
+    stats.false_positives = filter_false_positives.load(std::memory_order_relaxed);
+    return stats;
+}
+
+inline CatalogFreezeStats CourseManager::freezeCatalog() {
+    auto lock = lockExclusiveWithDeadline(mtx);
+    std::vector<std::shared_ptr<Course>> courses;
+    courses.reserve(course_records.size());
+    course_records.forEach([&courses](int, const std::shared_ptr<Course> &course) { courses.push_back(course); });
+    std::shared_ptr<const FrozenCourseCatalog> catalog = std::make_shared<const FrozenCourseCatalog>(std::move(courses));
+    frozen_catalog = catalog;
+    return catalog->getStats();
+}
+
+inline void CourseManager::thawCatalog() {
+    auto lock = lockExclusiveWithDeadline(mtx);
+    frozen_catalog.reset();
+}
+
+inline void CourseManager::forEachCourseUnlocked(const std::function<void(const Course &)> &visitor) const {
+    course_records.forEach([&visitor](int, const std::shared_ptr<Course> &course) { visitor(*course); });
+}
+
+inline bool CourseManager::visitCourseUnlocked(int id, const std::function<void(const Course &)> &visitor) const {
+    const Course *course = findRecord(id);
+    if (course == nullptr) {
+        return false;
+    }
+    visitor(*course);
+    return true;
+}
+
+inline SnapshotStats CourseManager::writeFullSnapshotUnlocked(std::ostream &out) const {
+    SnapshotStats stats;
+    writeSnapshotValue(out, kCourseSnapshotMagic, stats.bytes);
+    writeSnapshotValue(out, static_cast<std::uint8_t>(SnapshotMode::Full), stats.bytes);
+    course_records.forEach([&out, &stats](int, const std::shared_ptr<Course> &course) {
+        writeSnapshotValue(out, std::uint8_t(1), stats.bytes);
+        writeCourseRecord(out, *course, stats.bytes);
+        ++stats.records;
+    });
+    writeSnapshotValue(out, std::uint8_t(0), stats.bytes);
+    return stats;
+}
+
+inline void CourseManager::checkSwapLocked(const std::unique_lock<std::shared_timed_mutex> &, int student_id, int from_course_id, int to_course_id) const {
+    advanceHolds();
+    const Course &from = requireRecord(from_course_id);
+    const Course &to = requireRecord(to_course_id);
+    if (from.students.count(student_id) == 0) {
+        throw std::runtime_error("Student is not enrolled in the course being dropped");
+    }
+    if (to.students.count(student_id) != 0) {
+        throw std::runtime_error("Student is already enrolled in the course");
+    }
+    if (openSeatsOf(to) == 0) {
+        throw std::runtime_error("Course is full");
+    }
+}
+
+inline void CourseManager::swapStudentLocked(const std::unique_lock<std::shared_timed_mutex> &, int student_id, int from_course_id, int to_course_id, const std::string &student_name) {
+    Course *from = findRecord(from_course_id);
+    Course *to = findRecord(to_course_id);
+    if (from == nullptr || to == nullptr) {
+        return;
+    }
+    // Nodes move from one course's sets to the other's, so a swap allocates nothing.
+    recycleNode(spare_id_nodes, from->students.extract(student_id));
+    recycleNode(spare_roster_name_nodes, extractRosterName(*from, student_id, student_name));
+    recycleNode(spare_roster_id_nodes, from->roster_by_id.extract(student_id));
+    ++from->version;
+    markDirty(from_course_id);
+    insertRecycled(to->students, spare_id_nodes, student_id);
+    roster_key.first = student_name;
+    roster_key.second = student_id;
+    insertRecycled(to->roster_by_name, spare_roster_name_nodes, static_cast<const std::pair<std::string, int> &>(roster_key));
+    insertRecycled(to->roster_by_id, spare_roster_id_nodes, student_id);
+    ++to->version;
+    markDirty(to_course_id);
+    refreshOpenSection(*from);
+    refreshOpenSection(*to);
+}
+
+inline std::uint64_t CourseManager::currentHoldTick() const {
+    return static_cast<std::uint64_t>((std::chrono::steady_clock::now() - hold_epoch) / kHoldTick);
+}
+
+inline std::size_t CourseManager::advanceHolds(const std::function<void(const SeatHold &)> &on_expire) const {
+    return hold_wheel.advance(currentHoldTick(), [this, &on_expire](SeatHold &&hold) {
+        Course *course = findRecord(hold.course_id);
+        if (course != nullptr) {
+            if (course->held_seats > 0) {
+                --course->held_seats;
+            }
+            refreshOpenSection(*course);
+        }
+        if (on_expire) {
+            on_expire(hold);
+        }
+    });
+}
+
+inline bool CourseManager::holdsBehind() const {
+    return hold_wheel.size() != 0 && hold_wheel.currentTick() < currentHoldTick();
+}
+
+inline void CourseManager::checkEnrollLocked(const std::unique_lock<std::shared_timed_mutex> &, int course_id, int student_id) const {
+    advanceHolds();
+    const Course &course = requireRecord(course_id);
+    if (course.students.count(student_id) != 0) {
+        throw std::runtime_error("Student is already enrolled in the course");
+    }
+    if (openSeatsOf(course) == 0) {
+        throw std::runtime_error("Course is full");
+    }
+}
+
+inline void CourseManager::enrollStudentLocked(const std::unique_lock<std::shared_timed_mutex> &, int course_id, int student_id, const std::string &student_name) {
+    Course *course = findRecord(course_id);
+    if (course == nullptr || !insertRecycled(course->students, spare_id_nodes, student_id)) {
+        return;
+    }
+    roster_key.first = student_name;
+    roster_key.second = student_id;
+    insertRecycled(course->roster_by_name, spare_roster_name_nodes, static_cast<const std::pair<std::string, int> &>(roster_key));
+    insertRecycled(course->roster_by_id, spare_roster_id_nodes, student_id);
+    ++course->version;
+    markDirty(course_id);
+    refreshOpenSection(*course);
+}
+
+inline bool CourseManager::dropStudentLocked(const std::unique_lock<std::shared_timed_mutex> &, int course_id, int student_id, const std::string &student_name) {
+    Course &course = requireRecord(course_id);
+    std::unordered_set<int>::node_type node = course.students.extract(student_id);
+    if (node.empty()) {
+        return false;
+    }
+    recycleNode(spare_id_nodes, std::move(node));
+    recycleNode(spare_roster_name_nodes, extractRosterName(course, student_id, student_name));
+    recycleNode(spare_roster_id_nodes, course.roster_by_id.extract(student_id));
+    ++course.version;
+    markDirty(course_id);
+    refreshOpenSection(course);
+    return true;
+}
+
+inline void CourseManager::setCourseNameLocked(const std::unique_lock<std::shared_timed_mutex> &, int course_id, const std::string &name) {
+    Course &course = requireRecord(course_id);
+    course.name = name;
+    course.metadata.store(makeCourseMetadata(course));
+    ++course.version;
+    markDirty(course_id);
+}
+
+inline int CourseManager::setCourseFacultyLocked(const std::unique_lock<std::shared_timed_mutex> &, int course_id, int faculty_id) {
+    Course &course = requireRecord(course_id);
+    int previous = course.faculty_id;
+    course.faculty_id = faculty_id;
+    course.metadata.store(makeCourseMetadata(course));
+    ++course.version;
+    markDirty(course_id);
+    return previous;
+}
+
+inline void CourseManager::setCourseCapacityLocked(const std::unique_lock<std::shared_timed_mutex> &, int course_id, int capacity) {
+    if (capacity < 0) {
+        throw std::runtime_error("Course capacity must not be negative");
+    }
+    Course &course = requireRecord(course_id);
+    course.capacity = capacity;
+    course.metadata.store(makeCourseMetadata(course));
+    ++course.version;
+    markDirty(course_id);
+    refreshOpenSection(course);
+}
+
+inline void CourseManager::setCourseScheduleLocked(const std::unique_lock<std::shared_timed_mutex> &, int course_id, int family_id, const MeetingMask &meetings) {
+    Course &course = requireRecord(course_id);
+    moveToFamily(course, family_id);
+    course.meetings = meetings;
+    ++course.version;
+    markDirty(course_id);
+    refreshOpenSection(course);
+}
+
+inline SeatHoldId CourseManager::holdSeatLocked(const std::unique_lock<std::shared_timed_mutex> &, int course_id, int student_id, std::chrono::milliseconds ttl) {
+    advanceHolds();
+    Course &course = requireRecord(course_id);
+    if (openSeatsOf(course) == 0) {
+        throw std::runtime_error("Course is full");
+    }
+    std::uint64_t ticks = ttl.count() <= 0 ? 0 : static_cast<std::uint64_t>((ttl.count() + kHoldTick.count() - 1) / kHoldTick.count());
+    SeatHoldId hold = hold_wheel.schedule(currentHoldTick() + ticks, SeatHold{student_id, course_id});
+    ++course.held_seats;
+    refreshOpenSection(course);
+    return hold;
+}
+
+inline const SeatHold *CourseManager::findHoldLocked(const std::unique_lock<std::shared_timed_mutex> &, SeatHoldId hold) const {
+    advanceHolds();
+    return hold_wheel.find(hold);
+}
+
+inline SeatHold CourseManager::confirmHoldLocked(const std::unique_lock<std::shared_timed_mutex> &held, SeatHoldId hold, const std::string &student_name) {
+    SeatHold confirmed = *hold_wheel.find(hold);
+    hold_wheel.cancel(hold);
+    Course *course = findRecord(confirmed.course_id);
+    if (course != nullptr) {
+        if (course->held_seats > 0) {
+            --course->held_seats;
+        }
+        enrollStudentLocked(held, confirmed.course_id, confirmed.student_id, student_name);
+        refreshOpenSection(*course);
+    }
+    return confirmed;
+}
+
+inline bool CourseManager::releaseHoldLocked(const std::unique_lock<std::shared_timed_mutex> &, SeatHoldId hold, SeatHold &released) {
+    advanceHolds();
+    const SeatHold *active = hold_wheel.find(hold);
+    if (active == nullptr) {
+        return false;
+    }
+    released = *active;
+    hold_wheel.cancel(hold);
+    Course *course = findRecord(released.course_id);
+    if (course != nullptr) {
+        if (course->held_seats > 0) {
+            --course->held_seats;
+        }
+        refreshOpenSection(*course);
+    }
+    return true;
+}
+
+inline void CourseManager::refreshOpenSection(const Course &course) const {
+    if (course.family_id == -1) {
+        return;
+    }
+    if (openSeatsOf(course) > 0) {
+        insertRecycled(family_open_sections[course.family_id], spare_id_nodes, course.course_id);
+        return;
+    }
+    auto open = family_open_sections.find(course.family_id);
+    if (open != family_open_sections.end()) {
+        recycleNode(spare_id_nodes, open->second.extract(course.course_id));
+    }
+}
+
+inline std::set<std::pair<std::string, int>>::node_type CourseManager::extractRosterName(Course &course, int student_id, const std::string &student_name) {
+    roster_key.first = student_name;
+    roster_key.second = student_id;
+    auto it = course.roster_by_name.find(roster_key);
+    if (it == course.roster_by_name.end()) {
+        it = std::find_if(course.roster_by_name.begin(), course.roster_by_name.end(), [student_id](const std::pair<std::string, int> &entry) { return entry.second == student_id; });
+    }
+    if (it == course.roster_by_name.end()) {
+        return std::set<std::pair<std::string, int>>::node_type();
+    }
+    return course.roster_by_name.extract(it);
+}
+
+inline void CourseManager::moveToFamily(Course &course, int family_id) {
+    if (course.family_id == family_id) {
+        return;
+    }
+    if (course.family_id != -1) {
+        std::vector<int> &sections = family_sections[course.family_id];
+        sections.erase(std::remove(sections.begin(), sections.end(), course.course_id), sections.end());
+        auto open = family_open_sections.find(course.family_id);
+        if (open != family_open_sections.end()) {
+            open->second.erase(course.course_id);
+        }
+    }
+    course.family_id = family_id;
+    if (family_id != -1) {
+        family_sections[family_id].push_back(course.course_id);
+    }
+}
+
+inline Course *CourseManager::findRecord(int id) const {
+    const std::shared_ptr<Course> *record = frozen_catalog ? frozen_catalog->find(id) : course_records.find(id);
+    return record == nullptr ? nullptr : record->get();
+}
+
+inline Course &CourseManager::requireRecord(int id) const {
+    Course *course = findRecord(id);
+    if (course == nullptr) {
+        filter_false_positives.fetch_add(1, std::memory_order_relaxed);
+        throw std::runtime_error("Course not found");
+    }
+    return *course;
+}
+
+inline bool CourseManager::filterRejects(int id) const {
+    const IdBloomFilter *filter = id_filter.load(std::memory_order_acquire);
+    if (filter == nullptr) {
+        return false;
+    }
+    filter_lookups.fetch_add(1, std::memory_order_relaxed);
+    if (filter->mayContain(id)) {
+        return false;
+    }
+    filter_rejections.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+inline void CourseManager::filterInsert(int id) {
+    if (id_filters.empty() || course_records.size() > id_filters.back()->capacity()) {
+        std::size_t expected = id_filters.empty() ? std::size_t(1) << 16 : id_filters.back()->capacity() * 2;
+        rebuildFilter(std::max(expected, course_records.size()));
+        return;
+    }
+    id_filters.back()->insert(id);
+}
+
+inline void CourseManager::rebuildFilter(std::size_t expected_ids) {
+    std::unique_ptr<IdBloomFilter> filter(new IdBloomFilter(expected_ids));
+    course_records.forEach([&filter](int id, const std::shared_ptr<Course> &) { filter->insert(id); });
+    id_filter.store(filter.get(), std::memory_order_release);
+    id_filters.push_back(std::move(filter));
+}
+
+inline void CourseManager::markDirty(int id) {
+    dirty_ids[id] = ++mutation_sequence;
+}
+
+inline AccessControl::AccessControl(std::size_t max_decisions)
+    : max_decisions(max_decisions == 0 ? 1 : max_decisions), ring(new Decision[this->max_decisions]) {}
+
+inline void AccessControl::grantAdmin(int user_id) {
+    auto lock = lockExclusiveWithDeadline(mtx);
+    admins.insert(user_id);
+    invalidateLocked(user_id);
+}
+
+inline void AccessControl::revokeAdmin(int user_id) {
+    auto lock = lockExclusiveWithDeadline(mtx);
+    admins.erase(user_id);
+    invalidateLocked(user_id);
+}
+
+inline bool AccessControl::isAdmin(int user_id) const {
+    auto lock = lockSharedWithDeadline(mtx);
+    return admins.count(user_id) != 0;
+}
+
+inline bool AccessControl::findDecision(int requester_id, AccessAction action, int target_id, bool &allowed) const {
+    check_count.fetch_add(1, std::memory_order_relaxed);
+    std::uint64_t key = (static_cast<std::uint64_t>(action) << 32) | static_cast<std::uint32_t>(target_id);
+    auto lock = lockSharedWithDeadline(mtx);
+    auto requester = decisions.find(requester_id);
+    if (requester == decisions.end()) {
+        return false;
+    }
+    auto it = requester->second.find(key);
+    if (it == requester->second.end()) {
+        return false;
+    }
+    const Decision &decision = ring[it->second];
+    decision.referenced.store(true, std::memory_order_relaxed);
+    allowed = decision.allowed;
+    cached_count.fetch_add(1, std::memory_order_relaxed);
+    if (!allowed) {
+        denied_count.fetch_add(1, std::memory_order_relaxed);
+    }
+    return true;
+}
+
+inline std::uint64_t AccessControl::generation() const {
+    return invalidation_generation.load(std::memory_order_acquire);
+}
+
+inline void AccessControl::storeDecision(int requester_id, AccessAction action, int target_id, bool allowed, std::uint64_t computed_at) {
+    if (!allowed) {
+        denied_count.fetch_add(1, std::memory_order_relaxed);
+    }
+    std::uint64_t key = (static_cast<std::uint64_t>(action) << 32) | static_cast<std::uint32_t>(target_id);
+    auto lock = lockExclusiveWithDeadline(mtx);
+    if (invalidation_generation.load(std::memory_order_relaxed) != computed_at) {
+        return;
+    }
+    std::unordered_map<std::uint64_t, std::size_t> &keys = decisions[requester_id];
+    auto existing = keys.find(key);
+    if (existing != keys.end()) {
+        ring[existing->second].allowed = allowed;
+        return;
+    }
+    std::size_t position;
+    if (ring_used < max_decisions) {
+        position = ring_used++;
+    } else {
+        // CLOCK: clear referenced bits until an unreferenced or dead slot comes round.
+        for (;;) {
+            Decision &candidate = ring[hand];
+            if (!candidate.live) {
+                break;
+            }
+            if (!candidate.referenced.exchange(false, std::memory_order_relaxed)) {
+                auto owner = decisions.find(candidate.requester_id);
+                owner->second.erase(candidate.key);
+                // keys may be this same map, so only drop other requesters' empty maps.
+                if (owner->second.empty() && candidate.requester_id != requester_id) {
+                    decisions.erase(owner);
+                }
+                candidate.live = false;
+                eviction_count.fetch_add(1, std::memory_order_relaxed);
+                break;
+            }
+            hand = (hand + 1) % max_decisions;
+        }
+        position = hand;
+        hand = (hand + 1) % max_decisions;
+    }
+    Decision &decision = ring[position];
+    decision.requester_id = requester_id;
+    decision.key = key;
+    decision.allowed = allowed;
+    decision.live = true;
+    decision.referenced.store(false, std::memory_order_relaxed);
+    keys.emplace(key, position);
+}
+
+inline void AccessControl::invalidate(int requester_id) {
+    auto lock = lockExclusiveWithDeadline(mtx);
+    invalidateLocked(requester_id);
+}
+
+inline AccessStats AccessControl::getStats() const {
+    AccessStats stats;
+    stats.checks = check_count.load(std::memory_order_relaxed);
+    stats.cached = cached_count.load(std::memory_order_relaxed);
+    stats.denied = denied_count.load(std::memory_order_relaxed);
+    stats.invalidations = invalidation_count.load(std::memory_order_relaxed);
+    stats.evictions = eviction_count.load(std::memory_order_relaxed);
+    return stats;
+}
+
+inline void AccessControl::invalidateLocked(int requester_id) {
+    invalidation_generation.fetch_add(1, std::memory_order_release);
+    auto requester = decisions.find(requester_id);
+    if (requester == decisions.end()) {
+        return;
+    }
+    for (const auto &entry : requester->second) {
+        ring[entry.second].live = false;
+    }
+    invalidation_count.fetch_add(requester->second.size(), std::memory_order_relaxed);
+    decisions.erase(requester);
+}
+
+inline QueryResultCache::QueryResultCache(std::size_t max_bytes) {
+    stats.max_bytes = max_bytes;
+}
+
+inline QueryResultCache::Result QueryResultCache::find(CachedQuery query, int id, std::uint64_t version) {
+    std::lock_guard<std::mutex> lock(mtx);
+    auto it = index.find((static_cast<std::uint64_t>(query) << 32) | static_cast<std::uint32_t>(id));
+    if (it == index.end()) {
+        ++stats.misses;
+        return nullptr;
+    }
+    Slot &slot = slots[it->second];
+    if (slot.version != version) {
+        ++stats.invalidations;
+        ++stats.misses;
+        return nullptr;
+    }
+    slot.referenced = true;
+    ++stats.hits;
+    return slot.result;
+}
+
+inline void QueryResultCache::insert(CachedQuery query, int id, std::uint64_t version, Result result) {
+    auto slotBytes = [](const Result &cached) {
+        return sizeof(Slot) + sizeof(std::vector<int>) + cached->capacity() * sizeof(int);
+    };
+    std::size_t bytes = slotBytes(result);
+    std::uint64_t key = (static_cast<std::uint64_t>(query) << 32) | static_cast<std::uint32_t>(id);
+    std::lock_guard<std::mutex> lock(mtx);
+    if (bytes > stats.max_bytes) {
+        return;
+    }
+    auto it = index.find(key);
+    if (it != index.end()) {
+        Slot &slot = slots[it->second];
+        stats.bytes -= slotBytes(slot.result);
+        slot.version = version;
+        slot.result = std::move(result);
+        slot.referenced = true;
+        stats.bytes += bytes;
+        return;
+    }
+    // CLOCK: clear referenced bits until an unreferenced slot comes round, then evict it.
+    while (stats.entries != 0 && stats.bytes + bytes > stats.max_bytes) {
+        if (hand >= slots.size()) {
+            hand = 0;
+        }
+        Slot &slot = slots[hand];
+        if (slot.result && slot.referenced) {
+            slot.referenced = false;
+        } else if (slot.result) {
+            stats.bytes -= slotBytes(slot.result);
+            index.erase((static_cast<std::uint64_t>(slot.query) << 32) | static_cast<std::uint32_t>(slot.id));
+            slot.result.reset();
+            free_slots.push_back(hand);
+            --stats.entries;
+            ++stats.evictions;
+        }
+        ++hand;
+    }
+    std::size_t position;
+    if (free_slots.empty()) {
+        position = slots.size();
+        slots.push_back(Slot{query, id, version, std::move(result), true});
+    } else {
+        position = free_slots.back();
+        free_slots.pop_back();
+        slots[position] = Slot{query, id, version, std::move(result), true};
+    }
+    index.emplace(key, position);
+    ++stats.entries;
+    stats.bytes += bytes;
+}
+
+inline ResultCacheStats QueryResultCache::getStats() const {
+    std::lock_guard<std::mutex> lock(mtx);
+    return stats;
+}
+
+inline ForkedUniversityView::ForkedUniversityView(const StudentManager &students, const FacultyManager &faculty, const CourseManager &courses)
+    : student_manager(students), faculty_manager(faculty), course_manager(courses) {}
+
+inline void ForkedUniversityView::forEachStudent(const std::function<void(const Student &)> &visitor) const {
+    student_manager.forEachStudentUnlocked(visitor);
+}
+
+inline bool ForkedUniversityView::visitStudent(int id, const std::function<void(const Student &)> &visitor) const {
+    return student_manager.visitStudentUnlocked(id, visitor);
+}
+
+inline void ForkedUniversityView::forEachFaculty(const std::function<void(const Faculty &)> &visitor) const {
+    faculty_manager.forEachFacultyUnlocked(visitor);
+}
+
+inline bool ForkedUniversityView::visitFaculty(int id, const std::function<void(const Faculty &)> &visitor) const {
+    return faculty_manager.visitFacultyUnlocked(id, visitor);
+}
+
+inline void ForkedUniversityView::forEachCourse(const std::function<void(const Course &)> &visitor) const {
+    course_manager.forEachCourseUnlocked(visitor);
+}
+
+inline bool ForkedUniversityView::visitCourse(int id, const std::function<void(const Course &)> &visitor) const {
+    return course_manager.visitCourseUnlocked(id, visitor);
+}
+
+inline SnapshotStats ForkedUniversityView::writeSnapshot(std::ostream &out) const {
+    SnapshotStats total;
+    addSnapshotStats(total, student_manager.writeFullSnapshotUnlocked(out));
+    addSnapshotStats(total, faculty_manager.writeFullSnapshotUnlocked(out));
+    addSnapshotStats(total, course_manager.writeFullSnapshotUnlocked(out));
+    return total;
+}
+
+#include "billing.h"
+#include "trace.h"
+
+inline void UniversityManager::addStudent(int student_id, const std::string &name) {
+    addStudent(student_id, std::string(name));
+}
+
+inline void UniversityManager::addStudent(int student_id, std::string &&name) {
+    trace(OperationKind::AddStudent, student_id, 0, 0, name);
+    track(OperationKind::AddStudent, [&] {
+        std::size_t bytes = sizeof(Student) + name.size();
+        reserveMemory(bytes);
+        std::string logged = write_ahead_log.load(std::memory_order_acquire) != nullptr ? name : std::string();
+        try {
+            student_manager.addStudent(student_id, std::move(name));
+        } catch (...) {
+            releaseMemory(bytes);
+            throw;
+        }
+        logMutation(WalOp::AddStudent, student_id, 0, 0, logged);
+        write_count.fetch_add(1, std::memory_order_relaxed);
+    });
+}
+
+inline void UniversityManager::enrollInCourse(int student_id, int course_id) {
+    trace(OperationKind::EnrollInCourse, student_id, course_id);
+    track(OperationKind::EnrollInCourse, [&] {
+        if (student_manager.filterRejects(student_id)) {
+            throw std::runtime_error("Student not found");
+        }
+        if (course_manager.filterRejects(course_id)) {
+            throw std::runtime_error("Course not found");
+        }
+        BillingEngine *billing = billing_engine.load(std::memory_order_acquire);
+        if (billing != nullptr && !billing->isBillable(course_id)) {
+            throw std::runtime_error("Course has no billing metadata");
+        }
+        {
+            auto student_lock = lockExclusiveWithDeadline(student_manager.mtx);
+            auto course_lock = lockExclusiveWithDeadline(course_manager.mtx);
+            const std::string &name = student_manager.checkEnrollLocked(student_lock, student_id, course_id);
+            course_manager.checkEnrollLocked(course_lock, course_id, student_id);
+            student_manager.enrollInCourseLocked(student_lock, student_id, course_id);
+            course_manager.enrollStudentLocked(course_lock, course_id, student_id, name);
+            memory_usage.fetch_add(kEnrollmentBytes, std::memory_order_relaxed);
+            logMutation(WalOp::EnrollInCourse, student_id, course_id);
+        }
+        if (billing != nullptr) {
+            billing->onEnroll(student_id, course_id);
+        }
+        write_count.fetch_add(1, std::memory_order_relaxed);
+    });
+}
+
+inline void UniversityManager::dropCourse(int student_id, int course_id) {
+    trace(OperationKind::DropCourse, student_id, course_id);
+    track(OperationKind::DropCourse, [&] {
+        if (student_manager.filterRejects(student_id)) {
+            throw std::runtime_error("Student not found");
+        }
+        if (course_manager.filterRejects(course_id)) {
+            throw std::runtime_error("Course not found");
+        }
+        BillingEngine *billing = billing_engine.load(std::memory_order_acquire);
+        bool dropped;
+        {
+            auto student_lock = lockExclusiveWithDeadline(student_manager.mtx);
+            auto course_lock = lockExclusiveWithDeadline(course_manager.mtx);
+            course_manager.requireRecord(course_id);
+            const Student &student = student_manager.requireRecord(student_id);
+            dropped = student_manager.dropCourseLocked(student_lock, student_id, course_id);
+            if (dropped) {
+                course_manager.dropStudentLocked(course_lock, course_id, student_id, student.name);
+                memory_usage.fetch_sub(kEnrollmentBytes, std::memory_order_relaxed);
+                logMutation(WalOp::DropCourse, student_id, course_id);
+            }
+        }
+        if (dropped && billing != nullptr) {
+            billing->onDrop(student_id, course_id);
+        }
+        write_count.fetch_add(1, std::memory_order_relaxed);
+    });
+}
+
+inline void UniversityManager::swapSection(int student_id, int from_course_id, int to_course_id) {
+    trace(OperationKind::SwapSection, student_id, from_course_id, to_course_id);
+    track(OperationKind::SwapSection, [&] {
+        if (student_manager.filterRejects(student_id)) {
+            throw std::runtime_error("Student not found");
+        }
+        if (course_manager.filterRejects(from_course_id) || course_manager.filterRejects(to_course_id)) {
+            throw std::runtime_error("Course not found");
+        }
+        BillingEngine *billing = billing_engine.load(std::memory_order_acquire);
+        if (billing != nullptr && !billing->isBillable(to_course_id)) {
+            throw std::runtime_error("Course has no billing metadata");
+        }
+        {
+            auto student_lock = lockExclusiveWithDeadline(student_manager.mtx);
+            auto course_lock = lockExclusiveWithDeadline(course_manager.mtx);
+            const std::string &name = student_manager.checkReplaceLocked(student_lock, student_id, from_course_id);
+            course_manager.checkSwapLocked(course_lock, student_id, from_course_id, to_course_id);
+            student_manager.replaceCourseLocked(student_lock, student_id, from_course_id, to_course_id);
+            course_manager.swapStudentLocked(course_lock, student_id, from_course_id, to_course_id, name);
+            logMutation(WalOp::SwapSection, student_id, from_course_id, to_course_id);
+        }
+        if (billing != nullptr) {
+            billing->onDrop(student_id, from_course_id);
+            billing->onEnroll(student_id, to_course_id);
+        }
+        write_count.fetch_add(1, std::memory_order_relaxed);
+    });
+}
+
+inline std::vector<int> UniversityManager::getStudentIds() const {
+    trace(OperationKind::GetStudentIds, 0);
+    return track(OperationKind::GetStudentIds, [&] {
+        std::vector<int> ids = student_manager.getStudentIds();
+        read_count.fetch_add(1, std::memory_order_relaxed);
+        return ids;
+    });
+}
+
+inline void UniversityManager::forEachStudent(const std::function<void(const Student &)> &visitor) const {
+    trace(OperationKind::ForEachStudent, 0);
+    track(OperationKind::ForEachStudent, [&] {
+        student_manager.forEachStudent(visitor);
+        read_count.fetch_add(1, std::memory_order_relaxed);
+    });
+}
+
+inline bool UniversityManager::visitStudent(int id, const std::function<void(const Student &)> &visitor) const {
+    trace(OperationKind::VisitStudent, id);
+    return track(OperationKind::VisitStudent, [&] {
+        bool found = student_manager.visitStudent(id, visitor);
+        read_count.fetch_add(1, std::memory_order_relaxed);
+        return found;
+    });
+}
+
+inline std::unordered_set<int> UniversityManager::getStudentCourses(int student_id) const {
+    trace(OperationKind::GetStudentCourses, student_id);
+    return track(OperationKind::GetStudentCourses, [&] {
+        std::unordered_set<int> courses = student_manager.getStudentCourses(student_id);
+        read_count.fetch_add(1, std::memory_order_relaxed);
+        return courses;
+    });
+}
+
+inline std::size_t UniversityManager::getStudentCourses(int student_id, int *out, std::size_t capacity) const {
+    trace(OperationKind::GetStudentCourses, student_id);
+    return track(OperationKind::GetStudentCourses, [&] {
+        std::size_t count = student_manager.getStudentCourses(student_id, out, capacity);
+        read_count.fetch_add(1, std::memory_order_relaxed);
+        return count;
+    });
+}
+
+inline void UniversityManager::addFaculty(int faculty_id, const std::string &name) {
+    addFaculty(faculty_id, std::string(name));
+}
+
+inline void UniversityManager::addFaculty(int faculty_id, std::string &&name) {
+    trace(OperationKind::AddFaculty, faculty_id, 0, 0, name);
+    track(OperationKind::AddFaculty, [&] {
+        std::size_t bytes = sizeof(Faculty) + name.size();
+        reserveMemory(bytes);
+        std::string logged = write_ahead_log.load(std::memory_order_acquire) != nullptr ? name : std::string();
+        try {
+            faculty_manager.addFaculty(faculty_id, std::move(name));
+        } catch (...) {
+            releaseMemory(bytes);
+            throw;
+        }
+        logMutation(WalOp::AddFaculty, faculty_id, 0, 0, logged);
+        write_count.fetch_add(1, std::memory_order_relaxed);
+    });
+}
+
+inline void UniversityManager::assignCourse(int faculty_id, int course_id) {
+    trace(OperationKind::AssignCourse, faculty_id, course_id);
+    track(OperationKind::AssignCourse, [&] {
+        if (faculty_manager.filterRejects(faculty_id)) {
+            throw std::runtime_error("Faculty not found");
+        }
+        {
+            auto lock = lockExclusiveWithDeadline(faculty_manager.mtx);
+            faculty_manager.assignCourseLocked(lock, faculty_id, course_id);
+            logMutation(WalOp::AssignCourse, faculty_id, course_id);
+        }
+        access_control.invalidate(faculty_id);
+        write_count.fetch_add(1, std::memory_order_relaxed);
+    });
+}
+
+inline std::unordered_set<int> UniversityManager::getFacultyCourses(int faculty_id) const {
+    trace(OperationKind::GetFacultyCourses, faculty_id);
+    return track(OperationKind::GetFacultyCourses, [&] {
+        std::unordered_set<int> courses = faculty_manager.getFacultyCourses(faculty_id);
+        read_count.fetch_add(1, std::memory_order_relaxed);
+        return courses;
+    });
+}
+
+inline void UniversityManager::forEachFaculty(const std::function<void(const Faculty &)> &visitor) const {
+    trace(OperationKind::ForEachFaculty, 0);
+    track(OperationKind::ForEachFaculty, [&] {
+        faculty_manager.forEachFaculty(visitor);
+        read_count.fetch_add(1, std::memory_order_relaxed);
+    });
+}
+
+inline bool UniversityManager::visitFaculty(int id, const std::function<void(const Faculty &)> &visitor) const {
+    trace(OperationKind::VisitFaculty, id);
+    return track(OperationKind::VisitFaculty, [&] {
+        bool found = faculty_manager.visitFaculty(id, visitor);
+        read_count.fetch_add(1, std::memory_order_relaxed);
+        return found;
+    });
+}
+
+inline std::size_t UniversityManager::getFacultyCourses(int faculty_id, int *out, std::size_t capacity) const {
+    trace(OperationKind::GetFacultyCourses, faculty_id);
+    return track(OperationKind::GetFacultyCourses, [&] {
+        std::size_t count = faculty_manager.getFacultyCourses(faculty_id, out, capacity);
+        read_count.fetch_add(1, std::memory_order_relaxed);
+        return count;
+    });
+}
+
+inline void UniversityManager::addCourse(int course_id, const std::string &name, int faculty_id) {
+    addCourse(course_id, std::string(name), faculty_id);
+}
+
+inline void UniversityManager::addCourse(int course_id, std::string &&name, int faculty_id) {
+    trace(OperationKind::AddCourse, course_id, faculty_id, 0, name);
+    track(OperationKind::AddCourse, [&] {
+        std::size_t bytes = sizeof(Course) + name.size();
+        reserveMemory(bytes);
+        std::string logged = write_ahead_log.load(std::memory_order_acquire) != nullptr ? name : std::string();
+        try {
+            course_manager.addCourse(course_id, std::move(name), faculty_id);
+        } catch (...) {
+            releaseMemory(bytes);
+            throw;
+        }
+        logMutation(WalOp::AddCourse, course_id, faculty_id, 0, logged);
+        write_count.fetch_add(1, std::memory_order_relaxed);
+    });
+}
+
+inline std::unordered_set<int> UniversityManager::getCourseStudents(int course_id) const {
+    trace(OperationKind::GetCourseStudents, course_id);
+    return track(OperationKind::GetCourseStudents, [&] {
+        std::unordered_set<int> students = course_manager.getCourseStudents(course_id);
+        read_count.fetch_add(1, std::memory_order_relaxed);
+        return students;
+    });
+}
+
+inline bool UniversityManager::isEnrolled(int student_id, int course_id) const {
+    trace(OperationKind::IsEnrolled, student_id, course_id);
+    return track(OperationKind::IsEnrolled, [&] {
+        bool enrolled = course_manager.isEnrolled(course_id, student_id);
+        read_count.fetch_add(1, std::memory_order_relaxed);
+        return enrolled;
+    });
+}
+
+inline int UniversityManager::getCourseFaculty(int course_id) const {
+    trace(OperationKind::GetCourseFaculty, course_id);
+    return track(OperationKind::GetCourseFaculty, [&] {
+        int faculty_id = course_manager.getCourseFaculty(course_id);
+        read_count.fetch_add(1, std::memory_order_relaxed);
+        return faculty_id;
+    });
+}
+
+inline CourseMetadata UniversityManager::getCourseMetadata(int course_id) const {
+    trace(OperationKind::GetCourseMetadata, course_id);
+    return track(OperationKind::GetCourseMetadata, [&] {
+        CourseMetadata metadata = course_manager.getCourseMetadata(course_id);
+        read_count.fetch_add(1, std::memory_order_relaxed);
+        return metadata;
+    });
+}
+
+inline FacultyMetadata UniversityManager::getFacultyMetadata(int faculty_id) const {
+    trace(OperationKind::GetFacultyMetadata, faculty_id);
+    return track(OperationKind::GetFacultyMetadata, [&] {
+        FacultyMetadata metadata = faculty_manager.getFacultyMetadata(faculty_id);
+        read_count.fetch_add(1, std::memory_order_relaxed);
+        return metadata;
+    });
+}
+
+inline void UniversityManager::setCourseName(int course_id, const std::string &name) {
+    trace(OperationKind::SetCourseName, course_id, 0, 0, name);
+    track(OperationKind::SetCourseName, [&] {
+        if (course_manager.filterRejects(course_id)) {
+            throw std::runtime_error("Course not found");
+        }
+        auto lock = lockExclusiveWithDeadline(course_manager.mtx);
+        course_manager.setCourseNameLocked(lock, course_id, name);
+        logMutation(WalOp::SetCourseName, course_id, 0, 0, name);
+        write_count.fetch_add(1, std::memory_order_relaxed);
+    });
+}
+
+inline void UniversityManager::setCourseFaculty(int course_id, int faculty_id) {
+    trace(OperationKind::SetCourseFaculty, course_id, faculty_id);
+    track(OperationKind::SetCourseFaculty, [&] {
+        if (course_manager.filterRejects(course_id)) {
+            throw std::runtime_error("Course not found");
+        }
+        if (faculty_manager.filterRejects(faculty_id)) {
+            throw std::runtime_error("Faculty not found");
+        }
+        int previous;
+        {
+            auto faculty_lock = lockExclusiveWithDeadline(faculty_manager.mtx);
+            auto course_lock = lockExclusiveWithDeadline(course_manager.mtx);
+            faculty_manager.requireRecord(faculty_id);
+            previous = course_manager.setCourseFacultyLocked(course_lock, course_id, faculty_id);
+            faculty_manager.unassignCourseLocked(faculty_lock, previous, course_id);
+            faculty_manager.assignCourseLocked(faculty_lock, faculty_id, course_id);
+            logMutation(WalOp::SetCourseFaculty, course_id, faculty_id, previous);
+        }
+        access_control.invalidate(previous);
+        access_control.invalidate(faculty_id);
+        write_count.fetch_add(1, std::memory_order_relaxed);
+    });
+}
+
+inline void UniversityManager::setFacultyName(int faculty_id, const std::string &name) {
+    trace(OperationKind::SetFacultyName, faculty_id, 0, 0, name);
+    track(OperationKind::SetFacultyName, [&] {
+        if (faculty_manager.filterRejects(faculty_id)) {
+            throw std::runtime_error("Faculty not found");
+        }
+        auto lock = lockExclusiveWithDeadline(faculty_manager.mtx);
+        faculty_manager.setFacultyNameLocked(lock, faculty_id, name);
+        logMutation(WalOp::SetFacultyName, faculty_id, 0, 0, name);
+        write_count.fetch_add(1, std::memory_order_relaxed);
+    });
+}
+
+inline void UniversityManager::setCourseCapacity(int course_id, int capacity) {
+    trace(OperationKind::SetCourseCapacity, course_id, capacity);
+    track(OperationKind::SetCourseCapacity, [&] {
+        if (course_manager.filterRejects(course_id)) {
+            throw std::runtime_error("Course not found");
+        }
+        auto lock = lockExclusiveWithDeadline(course_manager.mtx);
+        course_manager.setCourseCapacityLocked(lock, course_id, capacity);
+        logMutation(WalOp::SetCourseCapacity, course_id, capacity);
+        write_count.fetch_add(1, std::memory_order_relaxed);
+    });
+}
+
+inline int UniversityManager::getCourseCapacity(int course_id) const {
+    trace(OperationKind::GetCourseCapacity, course_id);
+    return track(OperationKind::GetCourseCapacity, [&] {
+        int capacity = course_manager.getCourseCapacity(course_id);
+        read_count.fetch_add(1, std::memory_order_relaxed);
+        return capacity;
+    });
+}
+
+inline int UniversityManager::getOpenSeats(int course_id) const {
+    trace(OperationKind::GetOpenSeats, course_id);
+    return track(OperationKind::GetOpenSeats, [&] {
+        int open = course_manager.getOpenSeats(course_id);
+        read_count.fetch_add(1, std::memory_order_relaxed);
+        return open;
+    });
+}
+
+inline void UniversityManager::setCourseSchedule(int course_id, int family_id, const MeetingMask &meetings) {
+    std::string mask = encodeMeetingMask(meetings);
+    trace(OperationKind::SetCourseSchedule, course_id, family_id, 0, mask);
+    track(OperationKind::SetCourseSchedule, [&] {
+        if (course_manager.filterRejects(course_id)) {
+            throw std::runtime_error("Course not found");
+        }
+        auto lock = lockExclusiveWithDeadline(course_manager.mtx);
+        course_manager.setCourseScheduleLocked(lock, course_id, family_id, meetings);
+        logMutation(WalOp::SetCourseSchedule, course_id, family_id, 0, std::string(), mask);
+        write_count.fetch_add(1, std::memory_order_relaxed);
+    });
+}
+
+inline std::vector<int> UniversityManager::getFamilySections(int family_id) const {
+    trace(OperationKind::GetFamilySections, family_id);
+    return track(OperationKind::GetFamilySections, [&] {
+        std::vector<int> sections = course_manager.getFamilySections(family_id);
+        read_count.fetch_add(1, std::memory_order_relaxed);
+        return sections;
+    });
+}
+
+inline std::vector<int> UniversityManager::findOpenSections(int student_id, int course_id) const {
+    trace(OperationKind::FindOpenSections, student_id, course_id);
+    return track(OperationKind::FindOpenSections, [&] {
+        if (student_manager.filterRejects(student_id)) {
+            throw std::runtime_error("Student not found");
+        }
+        MeetingMask busy;
+        {
+            auto student_lock = lockSharedWithDeadline(student_manager.mtx);
+            const Student &student = student_manager.requireRecord(student_id);
+            auto course_lock = lockSharedWithDeadline(course_manager.mtx);
+            for (int enrolled_id : student.courses) {
+                const Course *enrolled = course_manager.findRecord(enrolled_id);
+                if (enrolled != nullptr) {
+                    busy |= enrolled->meetings;
+                }
+            }
+        }
+        std::vector<int> sections = course_manager.findOpenSiblings(course_id, busy);
+        read_count.fetch_add(1, std::memory_order_relaxed);
+        return sections;
+    });
+}
+
+inline SeatHoldId UniversityManager::holdSeat(int student_id, int course_id, std::chrono::milliseconds ttl) {
+    trace(OperationKind::HoldSeat, student_id, course_id, static_cast<std::int32_t>(ttl.count()));
+    return track(OperationKind::HoldSeat, [&] {
+        if (student_manager.filterRejects(student_id)) {
+            throw std::runtime_error("Student not found");
+        }
+        if (course_manager.filterRejects(course_id)) {
+            throw std::runtime_error("Course not found");
+        }
+        SeatHoldId hold;
+        {
+            auto student_lock = lockSharedWithDeadline(student_manager.mtx);
+            student_manager.requireRecord(student_id);
+            auto course_lock = lockExclusiveWithDeadline(course_manager.mtx);
+            hold = course_manager.holdSeatLocked(course_lock, course_id, student_id, ttl);
+            logMutation(WalOp::HoldSeat, student_id, course_id, static_cast<std::int32_t>(ttl.count()));
+        }
+        write_count.fetch_add(1, std::memory_order_relaxed);
+        return hold;
+    });
+}
+
+inline bool UniversityManager::releaseHold(SeatHoldId hold) {
+    return track(OperationKind::ReleaseHold, [&] {
+        bool released;
+        {
+            auto lock = lockExclusiveWithDeadline(course_manager.mtx);
+            SeatHold seat{0, 0};
+            released = course_manager.releaseHoldLocked(lock, hold, seat);
+            // Traced by (student, course), which the replayer maps back to
+            // its own handle; an unknown handle is traced as (0, 0).
+            trace(OperationKind::ReleaseHold, seat.student_id, seat.course_id);
+            if (released) {
+                logMutation(WalOp::ReleaseHold, seat.student_id, seat.course_id);
+            }
+        }
+        write_count.fetch_add(1, std::memory_order_relaxed);
+        return released;
+    });
+}
+
+inline void UniversityManager::confirmHold(SeatHoldId hold) {
+    track(OperationKind::ConfirmHold, [&] {
+        BillingEngine *billing = billing_engine.load(std::memory_order_acquire);
+        SeatHold confirmed;
+        {
+            auto student_lock = lockExclusiveWithDeadline(student_manager.mtx);
+            auto course_lock = lockExclusiveWithDeadline(course_manager.mtx);
+            const SeatHold *active = course_manager.findHoldLocked(course_lock, hold);
+            if (active == nullptr) {
+                trace(OperationKind::ConfirmHold, 0, 0);
+                throw std::runtime_error("Seat hold has expired or was released");
+            }
+            trace(OperationKind::ConfirmHold, active->student_id, active->course_id);
+            if (billing != nullptr && !billing->isBillable(active->course_id)) {
+                throw std::runtime_error("Course has no billing metadata");
+            }
+            const std::string &name = student_manager.checkEnrollLocked(student_lock, active->student_id, active->course_id);
+            confirmed = course_manager.confirmHoldLocked(course_lock, hold, name);
+            student_manager.enrollInCourseLocked(student_lock, confirmed.student_id, confirmed.course_id);
+            memory_usage.fetch_add(kEnrollmentBytes, std::memory_order_relaxed);
+            logMutation(WalOp::ConfirmHold, confirmed.student_id, confirmed.course_id);
+        }
+        if (billing != nullptr) {
+            billing->onEnroll(confirmed.student_id, confirmed.course_id);
+        }
+        write_count.fetch_add(1, std::memory_order_relaxed);
+    });
+}
+
+inline std::size_t UniversityManager::expireHolds() {
+    trace(OperationKind::ExpireHolds, 0);
+    return track(OperationKind::ExpireHolds, [&] {
+        std::size_t expired;
+        {
+            auto lock = lockExclusiveWithDeadline(course_manager.mtx);
+            expired = course_manager.advanceHolds([this](const SeatHold &seat) {
+                logMutation(WalOp::ExpireHolds, seat.student_id, seat.course_id);
+            });
+        }
+        write_count.fetch_add(1, std::memory_order_relaxed);
+        return expired;
+    });
+}
+
+inline std::vector<int> UniversityManager::getCourseIds() const {
+    trace(OperationKind::GetCourseIds, 0);
+    return track(OperationKind::GetCourseIds, [&] {
+        std::vector<int> ids = course_manager.getCourseIds();
+        read_count.fetch_add(1, std::memory_order_relaxed);
+        return ids;
+    });
+}
+
+inline void UniversityManager::forEachCourse(const std::function<void(const Course &)> &visitor) const {
+    trace(OperationKind::ForEachCourse, 0);
+    track(OperationKind::ForEachCourse, [&] {
+        course_manager.forEachCourse(visitor);
+        read_count.fetch_add(1, std::memory_order_relaxed);
+    });
+}
+
+inline bool UniversityManager::visitCourse(int id, const std::function<void(const Course &)> &visitor) const {
+    trace(OperationKind::VisitCourse, id);
+    return track(OperationKind::VisitCourse, [&] {
+        bool found = course_manager.visitCourse(id, visitor);
+        read_count.fetch_add(1, std::memory_order_relaxed);
+        return found;
+    });
+}
+
+inline std::size_t UniversityManager::getCourseStudents(int course_id, int *out, std::size_t capacity) const {
+    trace(OperationKind::GetCourseStudents, course_id);
+    return track(OperationKind::GetCourseStudents, [&] {
+        std::size_t count = course_manager.getCourseStudents(course_id, out, capacity);
+        read_count.fetch_add(1, std::memory_order_relaxed);
+        return count;
+    });
+}
+
+inline void UniversityManager::reserve(std::size_t students, std::size_t faculty, std::size_t courses) {
+    student_manager.reserve(students);
+    faculty_manager.reserve(faculty);
+    course_manager.reserve(courses);
+}
+
+inline void UniversityManager::enableResultCache(std::size_t max_bytes) {
+    std::shared_ptr<QueryResultCache> cache = std::make_shared<QueryResultCache>(max_bytes);
+    std::lock_guard<std::mutex> lock(result_cache_mtx);
+    result_cache = std::move(cache);
+}
+
+inline void UniversityManager::disableResultCache() {
+    std::shared_ptr<QueryResultCache> released;
+    std::lock_guard<std::mutex> lock(result_cache_mtx);
+    released = std::move(result_cache);
+}
+
+inline QueryResultCache::Result UniversityManager::getCachedResult(CachedQuery query, int id) const {
+    trace(OperationKind::GetCachedResult, static_cast<std::int32_t>(query), id);
+    return track(OperationKind::GetCachedResult, [&]() -> QueryResultCache::Result {
+        std::shared_ptr<QueryResultCache> cache;
+        {
+            std::lock_guard<std::mutex> lock(result_cache_mtx);
+            cache = result_cache;
+        }
+        if (cache) {
+            std::uint64_t version = query == CachedQuery::StudentCourses   ? student_manager.getRecordVersion(id)
+                                    : query == CachedQuery::FacultyCourses ? faculty_manager.getRecordVersion(id)
+                                                                           : course_manager.getRecordVersion(id);
+            QueryResultCache::Result hit = cache->find(query, id, version);
+            if (hit) {
+                read_count.fetch_add(1, std::memory_order_relaxed);
+                return hit;
+            }
+        }
+
+        // The result and the version it is cached under come from one visit,
+        // so an entry never pairs a result with a later version.
+        std::shared_ptr<std::vector<int>> computed;
+        std::uint64_t computed_version = 0;
+        auto collect = [&computed, &computed_version](const std::unordered_set<int> &ids, std::uint64_t version) {
+            computed = std::make_shared<std::vector<int>>(ids.begin(), ids.end());
+            computed_version = version;
+        };
+        switch (query) {
+        case CachedQuery::StudentCourses:
+            student_manager.visitStudent(id, [&collect](const Student &student) { collect(student.courses, student.version); });
+            break;
+        case CachedQuery::FacultyCourses:
+            faculty_manager.visitFaculty(id, [&collect](const Faculty &faculty) { collect(faculty.courses, faculty.version); });
+            break;
+        case CachedQuery::CourseStudents:
+            course_manager.visitCourse(id, [&collect](const Course &course) { collect(course.students, course.version); });
+            break;
+        }
+        read_count.fetch_add(1, std::memory_order_relaxed);
+        if (!computed) {
+            return std::make_shared<const std::vector<int>>();
+        }
+        std::sort(computed->begin(), computed->end());
+        QueryResultCache::Result result = std::move(computed);
+        if (cache) {
+            cache->insert(query, id, computed_version, result);
+        }
+        return result;
+    });
+}
+
+inline ResultCacheStats UniversityManager::getResultCacheStats() const {
+    std::shared_ptr<QueryResultCache> cache;
+    {
+        std::lock_guard<std::mutex> lock(result_cache_mtx);
+        cache = result_cache;
+    }
+    return cache ? cache->getStats() : ResultCacheStats();
+}
+
+inline SnapshotStats UniversityManager::saveSnapshot(const std::string &path, SnapshotMode mode) {
+    auto start = std::chrono::steady_clock::now();
+    std::uint64_t student_checkpoint = 0;
+    std::uint64_t faculty_checkpoint = 0;
+    std::uint64_t course_checkpoint = 0;
+    SnapshotStats stats = writeSnapshotFile(path, [&](std::ostream &out) {
+        SnapshotStats total;
+        addSnapshotStats(total, student_manager.writeSnapshot(out, mode, student_checkpoint));
+        addSnapshotStats(total, faculty_manager.writeSnapshot(out, mode, faculty_checkpoint));
+        addSnapshotStats(total, course_manager.writeSnapshot(out, mode, course_checkpoint));
+        return total;
+    });
+    student_manager.commitSnapshot(student_checkpoint);
+    faculty_manager.commitSnapshot(faculty_checkpoint);
+    course_manager.commitSnapshot(course_checkpoint);
+    stats.elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+    return stats;
+}
+
+inline SnapshotStats UniversityManager::restoreSnapshot(const std::string &base_path, const std::vector<std::string> &incremental_paths) {
+    auto start = std::chrono::steady_clock::now();
+    SnapshotStats total;
+    auto load = [this, &total](const std::string &path) {
+        std::ifstream in(path, std::ios::binary);
+        if (!in) {
+            throw std::runtime_error("Cannot open snapshot file " + path);
+        }
+        addSnapshotStats(total, student_manager.loadSnapshot(in));
+        addSnapshotStats(total, faculty_manager.loadSnapshot(in));
+        addSnapshotStats(total, course_manager.loadSnapshot(in));
+    };
+    load(base_path);
+    for (const std::string &path : incremental_paths) {
+        load(path);
+    }
+    resetResultCache();
+    recountMemory();
+    total.elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+    return total;
+}
+
+inline SnapshotStats UniversityManager::compactSnapshots(const std::string &base_path, const std::vector<std::string> &incremental_paths, const std::string &output_path) {
+    UniversityManager scratch;
+    scratch.restoreSnapshot(base_path, incremental_paths);
+    return scratch.saveSnapshot(output_path, SnapshotMode::Full);
+}
+
+inline RosterPage UniversityManager::getCourseRoster(int course_id, RosterOrder order, const RosterCursor &after, std::size_t page_size) const {
+    // Order in bit 0 and page size above it, so the cursor's ID fits in arg2.
+    std::int32_t order_and_size = static_cast<std::int32_t>(std::min<std::size_t>(page_size, INT32_MAX >> 1) << 1) | static_cast<std::int32_t>(order);
+    trace(OperationKind::GetCourseRoster, course_id, order_and_size, after.student_id, after.name);
+    return track(OperationKind::GetCourseRoster, [&] {
+        RosterPage page = course_manager.getCourseRoster(course_id, order, after, page_size);
+        read_count.fetch_add(1, std::memory_order_relaxed);
+        return page;
+    });
+}
+
+inline LookupFilterStats UniversityManager::getStudentLookupFilterStats() const {
+    return student_manager.getLookupFilterStats();
+}
+
+inline LookupFilterStats UniversityManager::getFacultyLookupFilterStats() const {
+    return faculty_manager.getLookupFilterStats();
+}
+
+inline LookupFilterStats UniversityManager::getCourseLookupFilterStats() const {
+    return course_manager.getLookupFilterStats();
+}
+
+inline void UniversityManager::setWriteAheadLog(WalWriter *wal) {
+    write_ahead_log.store(wal, std::memory_order_release);
+}
+
+inline WalReplayStats UniversityManager::replayWriteAheadLog(const std::vector<std::string> &segments, unsigned threads) {
+    if (threads == 0) {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    WalReplayStats stats;
+    stats.threads = threads;
+    auto start = std::chrono::steady_clock::now();
+    std::chrono::steady_clock::duration decode_time{0};
+    auto shardOf = [threads](std::int32_t id) {
+        return static_cast<std::size_t>((static_cast<std::uint32_t>(id) * 0x9E3779B1u) >> 8) % threads;
+    };
+
+    // One pass over the segments: the calling thread decodes records and
+    // route() hands each to the queues of the workers that apply it.
+    auto runPass = [&](std::size_t queue_count, auto &&route, auto &&apply) {
+        std::vector<std::unique_ptr<WalShardQueue>> queues;
+        for (std::size_t q = 0; q < queue_count; ++q) {
+            queues.emplace_back(new WalShardQueue());
+        }
+        std::exception_ptr error;
+        std::mutex error_mtx;
+        std::vector<std::thread> workers;
+        for (std::size_t q = 0; q < queue_count; ++q) {
+            workers.emplace_back([&, q] {
+                WalRecord record;
+                while (queues[q]->pop(record)) {
+                    try {
+                        apply(q, record);
+                    } catch (...) {
+                        std::lock_guard<std::mutex> lock(error_mtx);
+                        if (!error) {
+                            error = std::current_exception();
+                        }
+                    }
+                }
+            });
+        }
+        try {
+            WalReader reader(segments);
+            WalRecord record;
+            for (;;) {
+                auto decode_start = std::chrono::steady_clock::now();
+                bool more = reader.next(record);
+                decode_time += std::chrono::steady_clock::now() - decode_start;
+                if (!more) {
+                    break;
+                }
+                route(record, [&queues](std::size_t q, WalRecord routed) { queues[q]->push(std::move(routed)); });
+            }
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(error_mtx);
+            if (!error) {
+                error = std::current_exception();
+            }
+        }
+        for (auto &queue : queues) {
+            queue->close();
+        }
+        for (std::thread &worker : workers) {
+            worker.join();
+        }
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    };
+
+    // Phase 1: creations, by the created record's shard.
+    runPass(
+        threads,
+        [&](const WalRecord &record, auto &&push) {
+            if (record.op == WalOp::AddStudent || record.op == WalOp::AddFaculty || record.op == WalOp::AddCourse) {
+                ++stats.records;
+                push(shardOf(record.arg0), record);
+            }
+        },
+        [&](std::size_t, WalRecord &record) {
+            switch (record.op) {
+            case WalOp::AddStudent:
+                student_manager.addStudent(record.arg0, std::move(record.name));
+                break;
+            case WalOp::AddFaculty:
+                faculty_manager.addFaculty(record.arg0, std::move(record.name));
+                break;
+            case WalOp::AddCourse:
+                course_manager.addCourse(record.arg0, std::move(record.name), record.arg1);
+                break;
+            default:
+                break;
+            }
+        });
+
+    // Phase 2: queues [0, threads) apply the student/faculty side, queues
+    // [threads, 2 * threads) the course side.
+    runPass(
+        2 * static_cast<std::size_t>(threads),
+        [&](const WalRecord &record, auto &&push) {
+            switch (record.op) {
+            case WalOp::EnrollInCourse:
+            case WalOp::ConfirmHold:
+            case WalOp::DropCourse:
+                push(shardOf(record.arg0), record);
+                push(threads + shardOf(record.arg1), record);
+                break;
+            case WalOp::AssignCourse:
+            case WalOp::SetFacultyName:
+                push(shardOf(record.arg0), record);
+                break;
+            case WalOp::SetCourseFaculty:
+                push(shardOf(record.arg2), record);
+                if (shardOf(record.arg1) != shardOf(record.arg2)) {
+                    push(shardOf(record.arg1), record);
+                }
+                push(threads + shardOf(record.arg0), record);
+                break;
+            case WalOp::SetCourseCapacity:
+            case WalOp::SetCourseName:
+            case WalOp::SetCourseSchedule:
+                push(threads + shardOf(record.arg0), record);
+                break;
+            case WalOp::SwapSection: {
+                push(shardOf(record.arg0), record);
+                WalRecord drop = record;
+                drop.op = WalOp::DropCourse;
+                push(threads + shardOf(record.arg1), std::move(drop));
+                WalRecord enroll = record;
+                enroll.op = WalOp::EnrollInCourse;
+                enroll.arg1 = record.arg2;
+                push(threads + shardOf(record.arg2), std::move(enroll));
+                break;
+            }
+            default:
+                return; // creations were applied in phase 1; holds are not durable
+            }
+            ++stats.records;
+        },
+        [&](std::size_t q, WalRecord &record) {
+            if (q < threads) {
+                switch (record.op) {
+                case WalOp::EnrollInCourse:
+                case WalOp::ConfirmHold: {
+                    auto lock = lockExclusiveWithDeadline(student_manager.mtx);
+                    student_manager.enrollInCourseLocked(lock, record.arg0, record.arg1);
+                    break;
+                }
+                case WalOp::DropCourse: {
+                    auto lock = lockExclusiveWithDeadline(student_manager.mtx);
+                    student_manager.dropCourseLocked(lock, record.arg0, record.arg1);
+                    break;
+                }
+                case WalOp::SwapSection: {
+                    auto lock = lockExclusiveWithDeadline(student_manager.mtx);
+                    student_manager.replaceCourseLocked(lock, record.arg0, record.arg1, record.arg2);
+                    break;
+                }
+                case WalOp::AssignCourse:
+                    faculty_manager.assignCourse(record.arg0, record.arg1);
+                    break;
+                case WalOp::SetFacultyName:
+                    faculty_manager.setFacultyName(record.arg0, record.name);
+                    break;
+                case WalOp::SetCourseFaculty: {
+                    auto lock = lockExclusiveWithDeadline(faculty_manager.mtx);
+                    if (shardOf(record.arg2) == q) {
+                        faculty_manager.unassignCourseLocked(lock, record.arg2, record.arg0);
+                    }
+                    if (shardOf(record.arg1) == q) {
+                        faculty_manager.assignCourseLocked(lock, record.arg1, record.arg0);
+                    }
+                    break;
+                }
+                default:
+                    break;
+                }
+                return;
+            }
+            switch (record.op) {
+            case WalOp::EnrollInCourse:
+            case WalOp::ConfirmHold: {
+                std::string name = student_manager.getStudentName(record.arg0);
+                auto lock = lockExclusiveWithDeadline(course_manager.mtx);
+                course_manager.enrollStudentLocked(lock, record.arg1, record.arg0, name);
+                break;
+            }
+            case WalOp::DropCourse: {
+                std::string name = student_manager.getStudentName(record.arg0);
+                auto lock = lockExclusiveWithDeadline(course_manager.mtx);
+                course_manager.dropStudentLocked(lock, record.arg1, record.arg0, name);
+                break;
+            }
+            case WalOp::SetCourseFaculty: {
+                auto lock = lockExclusiveWithDeadline(course_manager.mtx);
+                course_manager.setCourseFacultyLocked(lock, record.arg0, record.arg1);
+                break;
+            }
+            case WalOp::SetCourseCapacity:
+                course_manager.setCourseCapacity(record.arg0, record.arg1);
+                break;
+            case WalOp::SetCourseName:
+                course_manager.setCourseName(record.arg0, record.name);
+                break;
+            case WalOp::SetCourseSchedule:
+                course_manager.setCourseSchedule(record.arg0, record.arg1, decodeMeetingMask(record.payload));
+                break;
+            default:
+                break;
+            }
+        });
+
+    resetResultCache();
+    recountMemory();
+    stats.decode_time = std::chrono::duration_cast<std::chrono::microseconds>(decode_time);
+    stats.apply_time = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+    return stats;
+}
+
+inline std::future<ForkSnapshotReport> UniversityManager::forkSnapshot(const std::string &path) const {
+    return forkAnalyze([path](const ForkedUniversityView &view) {
+        writeSnapshotFile(path, [&view](std::ostream &out) { return view.writeSnapshot(out); });
+        return 0;
+    });
+}
+
+inline std::future<ForkSnapshotReport> UniversityManager::forkAnalyze(const std::function<int(const ForkedUniversityView &)> &job) const {
+    auto pause_start = std::chrono::steady_clock::now();
+    auto student_lock = lockExclusiveWithDeadline(student_manager.mtx);
+    auto faculty_lock = lockExclusiveWithDeadline(faculty_manager.mtx);
+    auto course_lock = lockExclusiveWithDeadline(course_manager.mtx);
+    struct rusage before;
+    ::getrusage(RUSAGE_SELF, &before);
+    pid_t pid = ::fork();
+    if (pid == 0) {
+        int status = 1;
+        try {
+            status = job(ForkedUniversityView(student_manager, faculty_manager, course_manager));
+        } catch (...) {
+            status = 1;
+        }
+        ::_exit(status);
+    }
+    course_lock.unlock();
+    faculty_lock.unlock();
+    student_lock.unlock();
+    if (pid < 0) {
+        throw std::runtime_error("fork() failed");
+    }
+    auto forked = std::chrono::steady_clock::now();
+    ForkSnapshotReport report;
+    report.fork_pause = std::chrono::duration_cast<std::chrono::microseconds>(forked - pause_start);
+    long faults_before = before.ru_minflt;
+    return std::async(std::launch::async, [pid, report, faults_before, forked]() mutable {
+        int status = 0;
+        while (::waitpid(pid, &status, 0) < 0 && errno == EINTR) {
+        }
+        report.child_elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - forked);
+        report.exit_status = WIFEXITED(status) ? WEXITSTATUS(status) : -1;
+        struct rusage after;
+        ::getrusage(RUSAGE_SELF, &after);
+        report.parent_minor_faults = after.ru_minflt - faults_before;
+        report.parent_extra_bytes = static_cast<std::size_t>(report.parent_minor_faults) * static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+        return report;
+    });
+}
+
+inline CatalogFreezeStats UniversityManager::freezeCourseCatalog() {
+    return course_manager.freezeCatalog();
+}
+
+inline void UniversityManager::thawCourseCatalog() {
+    course_manager.thawCatalog();
+}
+
+inline bool UniversityManager::isAuthorized(int requester_id, AccessAction action, int target_id) const {
+    trace(OperationKind::IsAuthorized, requester_id, static_cast<std::int32_t>(action), target_id);
+    return track(OperationKind::IsAuthorized, [&] {
+        bool allowed = authorize(requester_id, action, target_id);
+        read_count.fetch_add(1, std::memory_order_relaxed);
+        return allowed;
+    });
+}
+
+inline bool UniversityManager::authorize(int requester_id, AccessAction action, int target_id) const {
+    bool allowed = false;
+    std::uint64_t generation = access_control.generation();
+    if (access_control.findDecision(requester_id, action, target_id, allowed)) {
+        return allowed;
+    }
+    allowed = access_control.isAdmin(requester_id);
+    if (!allowed && action == AccessAction::ReadFacultySchedule) {
+        allowed = requester_id == target_id;
+    } else if (!allowed) {
+        auto faculty_lock = lockSharedWithDeadline(faculty_manager.mtx);
+        const Faculty *faculty = faculty_manager.findRecord(requester_id);
+        allowed = faculty != nullptr && faculty->courses.count(target_id) != 0;
+        if (!allowed) {
+            auto course_lock = lockSharedWithDeadline(course_manager.mtx);
+            const Course *course = course_manager.findRecord(target_id);
+            allowed = course != nullptr && course->faculty_id == requester_id;
+        }
+    }
+    access_control.storeDecision(requester_id, action, target_id, allowed, generation);
+    return allowed;
+}
+
+inline std::unordered_set<int> UniversityManager::getCourseStudentsAs(int requester_id, int course_id) const {
+    trace(OperationKind::GetCourseStudentsAs, requester_id, course_id);
+    return track(OperationKind::GetCourseStudentsAs, [&] {
+        if (!authorize(requester_id, AccessAction::ReadRoster, course_id)) {
+            throw std::runtime_error("Not authorized to read the course roster");
+        }
+        std::unordered_set<int> students = course_manager.getCourseStudents(course_id);
+        read_count.fetch_add(1, std::memory_order_relaxed);
+        return students;
+    });
+}
+
+inline std::unordered_set<int> UniversityManager::getFacultyCoursesAs(int requester_id, int faculty_id) const {
+    trace(OperationKind::GetFacultyCoursesAs, requester_id, faculty_id);
+    return track(OperationKind::GetFacultyCoursesAs, [&] {
+        if (!authorize(requester_id, AccessAction::ReadFacultySchedule, faculty_id)) {
+            throw std::runtime_error("Not authorized to read the faculty schedule");
+        }
+        std::unordered_set<int> courses = faculty_manager.getFacultyCourses(faculty_id);
+        read_count.fetch_add(1, std::memory_order_relaxed);
+        return courses;
+    });
+}
+
+inline AccessControl &UniversityManager::accessControl() {
+    return access_control;
+}
+
+inline void UniversityManager::setMemoryQuota(std::size_t max_bytes) {
+    memory_quota.store(max_bytes, std::memory_order_relaxed);
+}
+
+inline std::size_t UniversityManager::getMemoryUsage() const {
+    return memory_usage.load(std::memory_order_relaxed);
+}
+
+inline std::array<std::uint64_t, static_cast<std::size_t>(OperationKind::Count)> UniversityManager::getDeadlineMisses() const {
+    std::array<std::uint64_t, static_cast<std::size_t>(OperationKind::Count)> misses{};
+    for (std::size_t i = 0; i < misses.size(); ++i) {
+        misses[i] = deadline_misses[i].load(std::memory_order_relaxed);
+    }
+    return misses;
+}
+
+inline OperationCounters UniversityManager::getOperationCounters() const {
+    OperationCounters counters;
+    counters.reads = read_count.load(std::memory_order_relaxed);
+    counters.writes = write_count.load(std::memory_order_relaxed);
+    counters.quota_rejections = quota_rejection_count.load(std::memory_order_relaxed);
+    return counters;
+}
+
+inline void UniversityManager::setTraceRecorder(TraceRecorder *recorder) {
+    trace_recorder.store(recorder, std::memory_order_release);
+}
+
+inline void UniversityManager::setBillingEngine(BillingEngine *engine) {
+    billing_engine.store(engine, std::memory_order_release);
+}
+
+inline void UniversityManager::reserveMemory(std::size_t bytes) {
+    std::size_t current = memory_usage.load(std::memory_order_relaxed);
+    do {
+        std::size_t quota = memory_quota.load(std::memory_order_relaxed);
+        if (quota != 0 && current + bytes > quota) {
+            quota_rejection_count.fetch_add(1, std::memory_order_relaxed);
+            throw std::runtime_error("Memory quota exceeded");
+        }
+    } while (!memory_usage.compare_exchange_weak(current, current + bytes, std::memory_order_relaxed));
+}
+
+inline void UniversityManager::releaseMemory(std::size_t bytes) {
+    memory_usage.fetch_sub(bytes, std::memory_order_relaxed);
+}
+
+inline void UniversityManager::recountMemory() {
+    std::size_t bytes = 0;
+    student_manager.forEachStudent([&bytes](const Student &student) {
+        bytes += sizeof(Student) + student.name.size() + student.courses.size() * kEnrollmentBytes;
+    });
+    faculty_manager.forEachFaculty([&bytes](const Faculty &faculty) { bytes += sizeof(Faculty) + faculty.name.size(); });
+    course_manager.forEachCourse([&bytes](const Course &course) { bytes += sizeof(Course) + course.name.size(); });
+    memory_usage.store(bytes, std::memory_order_relaxed);
+}
+
+template <typename Body>
+inline auto UniversityManager::track(OperationKind kind, Body &&body) const -> decltype(body()) {
+    try {
+        return body();
+    } catch (const DeadlineExceeded &) {
+        deadline_misses[static_cast<std::size_t>(kind)].fetch_add(1, std::memory_order_relaxed);
+        throw;
+    }
+}
+
+inline void UniversityManager::trace(OperationKind kind, std::int32_t arg0, std::int32_t arg1, std::int32_t arg2, const std::string &name) const {
+    TraceRecorder *recorder = trace_recorder.load(std::memory_order_acquire);
+    if (recorder != nullptr) {
+        recorder->record(kind, arg0, arg1, arg2, name);
+    }
+}
+
+inline void UniversityManager::logMutation(WalOp op, std::int32_t arg0, std::int32_t arg1, std::int32_t arg2, const std::string &name, const std::string &payload) {
+    WalWriter *wal = write_ahead_log.load(std::memory_order_acquire);
+    if (wal != nullptr) {
+        wal->append(op, arg0, arg1, arg2, name, payload);
+    }
+}
+
+inline void UniversityManager::resetResultCache() {
+    std::lock_guard<std::mutex> lock(result_cache_mtx);
+    if (result_cache) {
+        result_cache = std::make_shared<QueryResultCache>(result_cache->getStats().max_bytes);
+    }
+}
 
 #endif // UNIVERSITY_MANAGEMENT_H
\ No newline at end of file
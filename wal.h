@@ -0,0 +1,563 @@
+/**
+ * @file wal.h
+ * @brief Header file for the write-ahead log
+ *
+ * This file contains the record format, writer and reader of the
+ * write-ahead log of successful UniversityManager mutations, and the
+ * partitioning used to replay it on all cores after a crash.
+ *
+ * @version 1.0
+ * @date 2026-10-18
+ */
+
+#ifndef WAL_H
+#define WAL_H
+
+#include <array>
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/**
+ * @brief Mutations recorded in the write-ahead log.
+ *
+ * Values are part of the on-disk format; append new operations at the end.
+ */
+enum class WalOp : std::uint8_t {
+    AddStudent = 0,
+    AddFaculty = 1,
+    AddCourse = 2,
+    EnrollInCourse = 3,
+    DropCourse = 4,
+    AssignCourse = 5,
+    SetCourseCapacity = 6,
+    SetCourseName = 7,
+    SetCourseFaculty = 8,
+    SetFacultyName = 9,
+    HoldSeat = 10,
+    ReleaseHold = 11,
+    ConfirmHold = 12,
+    ExpireHolds = 13,
+    SwapSection = 14,
+    SetCourseSchedule = 15
+};
+
+/**
+ * @brief Structure to represent one logged mutation.
+ *
+ * Only mutations that succeeded are logged, so replay applies them without
+ * re-validating capacity or existence. Hold records carry the hold's
+ * student in arg0 and course in arg1; an ExpireHolds record is written per
+ * expired hold.
+ *
+ * The payload is length-prefixed like the name. SetCourseSchedule stores
+ * the section's MeetingMask there as kWeekSlots / 8 bytes, slot 0 in the
+ * low bit of byte 0.
+ */
+struct WalRecord {
+    std::uint64_t lsn;  ///< Log sequence number, strictly increasing
+    WalOp op;           ///< The mutation
+    std::int32_t arg0;  ///< Student, faculty or course ID the mutation creates or starts from
+    std::int32_t arg1;  ///< Second ID (course for enroll/drop/assign and hold records, source course for SwapSection, family for SetCourseSchedule, faculty for AddCourse/SetCourseFaculty, capacity), 0 if unused
+    std::int32_t arg2;  ///< Third ID (previous faculty for SetCourseFaculty, TTL in milliseconds for HoldSeat, target course for SwapSection), 0 if unused
+    std::string name;   ///< Name for add* and set*Name mutations, empty otherwise
+    std::string payload; ///< Fixed-layout data too wide for the ID fields, empty if unused; see below
+};
+
+/**
+ * @brief CRC-32 (IEEE 802.3, reflected) of a byte range.
+ * @param data First byte.
+ * @param size Number of bytes.
+ * @return The checksum.
+ */
+inline std::uint32_t walCrc32(const char *data, std::size_t size) {
+    static const std::array<std::uint32_t, 256> table = [] {
+        std::array<std::uint32_t, 256> entries{};
+        for (std::uint32_t i = 0; i < 256; ++i) {
+            std::uint32_t crc = i;
+            for (int bit = 0; bit < 8; ++bit) {
+                crc = (crc >> 1) ^ ((crc & 1u) ? 0xEDB88320u : 0u);
+            }
+            entries[i] = crc;
+        }
+        return entries;
+    }();
+    std::uint32_t crc = 0xFFFFFFFFu;
+    for (std::size_t i = 0; i < size; ++i) {
+        crc = table[(crc ^ static_cast<std::uint8_t>(data[i])) & 0xFFu] ^ (crc >> 8);
+    }
+    return crc ^ 0xFFFFFFFFu;
+}
+
+constexpr std::size_t kWalFrameHeaderBytes = 8;  ///< Body length and CRC32 of the body, both little-endian uint32
+constexpr std::size_t kWalFixedBodyBytes = 29;   ///< lsn, op, arg0..arg2 and the two string lengths
+
+/**
+ * @brief Append one framed record to a buffer.
+ *
+ * The body holds the LSN (8 bytes), the op (1), arg0..arg2 (4 each), then
+ * the name and the payload, each as a 4-byte length and its bytes. All
+ * integers are little-endian.
+ *
+ * @param out The buffer.
+ * @param record The record.
+ */
+inline void encodeWalRecord(std::vector<char> &out, const WalRecord &record) {
+    auto putUint = [&out](std::uint64_t value, int bytes) {
+        for (int i = 0; i < bytes; ++i) {
+            out.push_back(static_cast<char>((value >> (8 * i)) & 0xFFu));
+        }
+    };
+    std::size_t frame = out.size();
+    std::size_t body_size = kWalFixedBodyBytes + record.name.size() + record.payload.size();
+    putUint(body_size, 4);
+    putUint(0, 4);
+    putUint(record.lsn, 8);
+    putUint(static_cast<std::uint8_t>(record.op), 1);
+    putUint(static_cast<std::uint32_t>(record.arg0), 4);
+    putUint(static_cast<std::uint32_t>(record.arg1), 4);
+    putUint(static_cast<std::uint32_t>(record.arg2), 4);
+    putUint(record.name.size(), 4);
+    out.insert(out.end(), record.name.begin(), record.name.end());
+    putUint(record.payload.size(), 4);
+    out.insert(out.end(), record.payload.begin(), record.payload.end());
+    std::uint32_t crc = walCrc32(out.data() + frame + kWalFrameHeaderBytes, body_size);
+    for (int i = 0; i < 4; ++i) {
+        out[frame + 4 + i] = static_cast<char>((crc >> (8 * i)) & 0xFFu);
+    }
+}
+
+/**
+ * @brief Decode the framed record at an offset.
+ * @param data Start of the segment.
+ * @param size Size of the segment.
+ * @param offset Offset of the frame; advanced past it on success.
+ * @param record Receives the record.
+ * @return false if the frame is truncated, fails its CRC or is malformed.
+ */
+inline bool decodeWalRecord(const char *data, std::size_t size, std::size_t &offset, WalRecord &record) {
+    auto getUint = [](const char *at, int bytes) {
+        std::uint64_t value = 0;
+        for (int i = 0; i < bytes; ++i) {
+            value |= static_cast<std::uint64_t>(static_cast<std::uint8_t>(at[i])) << (8 * i);
+        }
+        return value;
+    };
+    if (size - offset < kWalFrameHeaderBytes) {
+        return false;
+    }
+    const char *frame = data + offset;
+    std::uint64_t body_size = getUint(frame, 4);
+    if (body_size < kWalFixedBodyBytes || body_size > size - offset - kWalFrameHeaderBytes) {
+        return false;
+    }
+    const char *body = frame + kWalFrameHeaderBytes;
+    if (walCrc32(body, body_size) != static_cast<std::uint32_t>(getUint(frame + 4, 4))) {
+        return false;
+    }
+    std::uint64_t name_size = getUint(body + 21, 4);
+    if (name_size > body_size - kWalFixedBodyBytes) {
+        return false;
+    }
+    std::uint64_t payload_size = getUint(body + 25 + name_size, 4);
+    if (name_size + payload_size != body_size - kWalFixedBodyBytes) {
+        return false;
+    }
+    record.lsn = getUint(body, 8);
+    record.op = static_cast<WalOp>(static_cast<std::uint8_t>(body[8]));
+    record.arg0 = static_cast<std::int32_t>(static_cast<std::uint32_t>(getUint(body + 9, 4)));
+    record.arg1 = static_cast<std::int32_t>(static_cast<std::uint32_t>(getUint(body + 13, 4)));
+    record.arg2 = static_cast<std::int32_t>(static_cast<std::uint32_t>(getUint(body + 17, 4)));
+    record.name.assign(body + 25, name_size);
+    record.payload.assign(body + 29 + name_size, payload_size);
+    offset += kWalFrameHeaderBytes + body_size;
+    return true;
+}
+
+/**
+ * @brief Durability policy of the log writer.
+ */
+enum class WalSyncMode {
+    EveryRecord, ///< fdatasync after every append
+    Batched,     ///< fdatasync when the group-commit buffer fills or on sync()
+    None         ///< Leave flushing to the OS
+};
+
+/**
+ * @brief Class to append mutations to a write-ahead log segment.
+ *
+ * Records are framed as a length, a CRC32 and the encoded record, and are
+ * grouped in a buffer so concurrent appenders share one write and sync.
+ * The first appender to need its record on disk becomes the leader: it
+ * takes the whole buffer, writes and syncs it outside the lock, and every
+ * appender whose record was in that batch returns once it completes.
+ * Records appended meanwhile accumulate for the next leader.
+ */
+class WalWriter {
+public:
+    static constexpr std::size_t kGroupCommitBytes = 64 * 1024; ///< Buffered bytes that trigger a write in Batched and None modes
+
+    /**
+     * @brief Open or create a log segment for appending.
+     *
+     * An existing segment is scanned: LSNs continue after its last valid
+     * record, and a torn record left by a crash is truncated away so that
+     * new records do not follow it.
+     *
+     * @param path Segment file path.
+     * @param mode Durability policy.
+     * @throws std::runtime_error if the file cannot be opened.
+     */
+    WalWriter(const std::string &path, WalSyncMode mode) : mode(mode) {
+        fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+        if (fd < 0) {
+            throw std::runtime_error("Cannot open write-ahead log " + path + ": " + std::strerror(errno));
+        }
+        struct stat info;
+        if (::fstat(fd, &info) != 0) {
+            ::close(fd);
+            throw std::runtime_error("Cannot stat write-ahead log " + path);
+        }
+        std::size_t size = static_cast<std::size_t>(info.st_size);
+        if (size == 0) {
+            return;
+        }
+        void *mapped = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapped == MAP_FAILED) {
+            ::close(fd);
+            throw std::runtime_error("Cannot map write-ahead log " + path);
+        }
+        std::size_t valid = 0;
+        WalRecord record;
+        while (decodeWalRecord(static_cast<const char *>(mapped), size, valid, record)) {
+            next_lsn = record.lsn + 1;
+        }
+        ::munmap(mapped, size);
+        if (valid != size && ::ftruncate(fd, static_cast<off_t>(valid)) != 0) {
+            ::close(fd);
+            throw std::runtime_error("Cannot truncate torn tail of write-ahead log " + path);
+        }
+        written_lsn = next_lsn - 1;
+        synced_lsn = next_lsn - 1;
+    }
+
+    /**
+     * @brief Flush and close the segment.
+     */
+    ~WalWriter() {
+        try {
+            std::unique_lock<std::mutex> lock(mtx);
+            commit(lock, next_lsn - 1, mode != WalSyncMode::None);
+        } catch (...) {
+            // Destructors must not throw; records not yet written are lost as in a crash.
+        }
+        ::close(fd);
+    }
+
+    WalWriter(const WalWriter &) = delete;
+    WalWriter &operator=(const WalWriter &) = delete;
+
+    /**
+     * @brief Append a mutation, assigning it the next LSN.
+     * @param op The mutation.
+     * @param arg0 First argument.
+     * @param arg1 Second argument.
+     * @param arg2 Third argument.
+     * @param name Name for add* and set*Name mutations.
+     * @param payload Payload bytes, e.g. the MeetingMask of SetCourseSchedule.
+     * @return The record's LSN.
+     * @throws std::runtime_error if the write fails.
+     */
+    std::uint64_t append(WalOp op, std::int32_t arg0, std::int32_t arg1, std::int32_t arg2 = 0, const std::string &name = std::string(), const std::string &payload = std::string()) {
+        std::unique_lock<std::mutex> lock(mtx);
+        std::uint64_t lsn = next_lsn++;
+        encodeWalRecord(buffer, WalRecord{lsn, op, arg0, arg1, arg2, name, payload});
+        if (mode == WalSyncMode::EveryRecord) {
+            commit(lock, lsn, true);
+        } else if (buffer.size() >= kGroupCommitBytes) {
+            commit(lock, lsn, mode == WalSyncMode::Batched);
+        }
+        return lsn;
+    }
+
+    /**
+     * @brief Write and sync everything appended so far.
+     * @throws std::runtime_error if the write fails.
+     */
+    void sync() {
+        std::unique_lock<std::mutex> lock(mtx);
+        commit(lock, next_lsn - 1, true);
+    }
+
+private:
+    /**
+     * @brief Wait until a record is written, and synced if @p durable, leading the write if no one is.
+     * @param lock Lock on mtx, released while writing.
+     * @param lsn The record's LSN.
+     * @param durable Whether the record must also be synced.
+     * @throws std::runtime_error if the write fails.
+     */
+    void commit(std::unique_lock<std::mutex> &lock, std::uint64_t lsn, bool durable) {
+        while ((durable ? synced_lsn : written_lsn) < lsn) {
+            if (flushing) {
+                flushed.wait(lock);
+                continue;
+            }
+            flushing = true;
+            std::vector<char> batch;
+            batch.swap(buffer);
+            std::uint64_t last = next_lsn - 1;
+            lock.unlock();
+            bool ok = writeFully(batch) && (!durable || ::fdatasync(fd) == 0);
+            lock.lock();
+            flushing = false;
+            flushed.notify_all();
+            if (!ok) {
+                throw std::runtime_error(std::string("Write-ahead log write failed: ") + std::strerror(errno));
+            }
+            written_lsn = last;
+            if (durable) {
+                synced_lsn = last;
+            }
+            if (buffer.empty()) {
+                batch.clear();
+                buffer.swap(batch); // keep the batch's capacity for the next group
+            }
+        }
+    }
+
+    /**
+     * @brief Write a batch, retrying short writes and EINTR.
+     * @param batch The encoded records.
+     * @return false if the write failed.
+     */
+    bool writeFully(const std::vector<char> &batch) {
+        std::size_t done = 0;
+        while (done < batch.size()) {
+            ssize_t written = ::write(fd, batch.data() + done, batch.size() - done);
+            if (written < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                return false;
+            }
+            done += static_cast<std::size_t>(written);
+        }
+        return true;
+    }
+
+    int fd = -1;                    ///< Segment file descriptor
+    WalSyncMode mode;               ///< Durability policy
+    std::uint64_t next_lsn = 1;     ///< LSN of the next record
+    std::uint64_t written_lsn = 0;  ///< Last LSN handed to write()
+    std::uint64_t synced_lsn = 0;   ///< Last LSN covered by fdatasync()
+    bool flushing = false;          ///< Whether a leader is writing a batch
+    std::vector<char> buffer;       ///< Group-commit buffer of encoded records
+    std::mutex mtx;                 ///< Mutex guarding the LSNs, flushing and buffer
+    std::condition_variable flushed; ///< Signalled when a leader finishes a batch
+};
+
+/**
+ * @brief Class to stream records out of log segments.
+ *
+ * Segments are memory-mapped one at a time and decoded record by record,
+ * so memory use is bounded by one segment mapping, whose pages the kernel
+ * can drop once read, regardless of the log's length. A torn record at the
+ * end of the last segment, detected by its CRC, ends the log.
+ */
+class WalReader {
+public:
+    /**
+     * @brief Prepare to read log segments; nothing is mapped until next().
+     * @param segments Segment file paths in LSN order.
+     */
+    explicit WalReader(const std::vector<std::string> &segments) : paths(segments) {}
+
+    /**
+     * @brief Unmap the current segment.
+     */
+    ~WalReader() {
+        unmap();
+    }
+
+    WalReader(const WalReader &) = delete;
+    WalReader &operator=(const WalReader &) = delete;
+
+    /**
+     * @brief Decode the next record, mapping the next segment when one is exhausted.
+     * @param record Receives the record.
+     * @return false once the log ends.
+     * @throws std::runtime_error if a segment cannot be read or is corrupt before its end.
+     */
+    bool next(WalRecord &record) {
+        for (;;) {
+            if (offset < mapped_size) {
+                if (decodeWalRecord(mapping, mapped_size, offset, record)) {
+                    ++read_count;
+                    return true;
+                }
+                if (next_segment < paths.size()) {
+                    throw std::runtime_error("Corrupt record in write-ahead log segment " + paths[next_segment - 1]);
+                }
+                unmap(); // torn tail of the last segment: the log ends here
+                return false;
+            }
+            if (!mapNextSegment()) {
+                return false;
+            }
+        }
+    }
+
+    /**
+     * @brief Number of records returned by next() so far.
+     * @return The record count.
+     */
+    std::size_t recordsRead() const {
+        return read_count;
+    }
+
+private:
+    /**
+     * @brief Unmap the current segment and map the next one.
+     * @return false if no segments remain.
+     * @throws std::runtime_error if the segment cannot be opened or mapped.
+     */
+    bool mapNextSegment() {
+        unmap();
+        if (next_segment >= paths.size()) {
+            return false;
+        }
+        const std::string &path = paths[next_segment++];
+        int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) {
+            throw std::runtime_error("Cannot open write-ahead log segment " + path + ": " + std::strerror(errno));
+        }
+        struct stat info;
+        if (::fstat(fd, &info) != 0) {
+            ::close(fd);
+            throw std::runtime_error("Cannot stat write-ahead log segment " + path);
+        }
+        std::size_t size = static_cast<std::size_t>(info.st_size);
+        if (size != 0) {
+            void *mapped = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (mapped == MAP_FAILED) {
+                ::close(fd);
+                throw std::runtime_error("Cannot map write-ahead log segment " + path);
+            }
+            ::madvise(mapped, size, MADV_SEQUENTIAL);
+            mapping = static_cast<const char *>(mapped);
+            mapped_size = size;
+        }
+        ::close(fd);
+        return true;
+    }
+
+    /**
+     * @brief Unmap the current segment, if any.
+     */
+    void unmap() {
+        if (mapping != nullptr) {
+            ::munmap(const_cast<char *>(mapping), mapped_size);
+        }
+        mapping = nullptr;
+        mapped_size = 0;
+        offset = 0;
+    }
+
+    std::vector<std::string> paths;    ///< Segment file paths in LSN order
+    std::size_t next_segment = 0;      ///< Index in paths of the next segment to map
+    const char *mapping = nullptr;     ///< Current segment mapping, null if none
+    std::size_t mapped_size = 0;       ///< Size of the current mapping
+    std::size_t offset = 0;            ///< Offset of the next record in the current mapping
+    std::size_t read_count = 0;        ///< Records returned so far
+};
+
+/**
+ * @brief Bounded queue feeding one replay worker's shard.
+ *
+ * The thread reading the log pushes records and blocks while the queue is
+ * full, so a slow shard throttles reading instead of letting decoded
+ * records pile up in memory.
+ */
+class WalShardQueue {
+public:
+    /**
+     * @brief Construct an empty queue.
+     * @param capacity Maximum number of queued records.
+     */
+    explicit WalShardQueue(std::size_t capacity = 4096) : ring(capacity == 0 ? 1 : capacity) {}
+
+    /**
+     * @brief Queue a record, waiting while the queue is full.
+     * @param record The record.
+     */
+    void push(WalRecord record) {
+        std::unique_lock<std::mutex> lock(mtx);
+        not_full.wait(lock, [this] { return count < ring.size(); });
+        ring[(head + count) % ring.size()] = std::move(record);
+        ++count;
+        not_empty.notify_one();
+    }
+
+    /**
+     * @brief Mark the end of input; pop() returns false once the queue drains.
+     */
+    void close() {
+        std::lock_guard<std::mutex> lock(mtx);
+        closed = true;
+        not_empty.notify_all();
+    }
+
+    /**
+     * @brief Dequeue the oldest record, waiting while the queue is empty and open.
+     * @param record Receives the record.
+     * @return false once the queue is closed and empty.
+     */
+    bool pop(WalRecord &record) {
+        std::unique_lock<std::mutex> lock(mtx);
+        not_empty.wait(lock, [this] { return count != 0 || closed; });
+        if (count == 0) {
+            return false;
+        }
+        record = std::move(ring[head]);
+        head = (head + 1) % ring.size();
+        --count;
+        not_full.notify_one();
+        return true;
+    }
+
+private:
+    std::vector<WalRecord> ring;        ///< Fixed-size ring of queued records
+    std::size_t head = 0;               ///< Position of the oldest record
+    std::size_t count = 0;              ///< Number of queued records
+    bool closed = false;                ///< Set by close()
+    std::mutex mtx;                     ///< Mutex guarding the ring and flags
+    std::condition_variable not_empty;  ///< Signalled by push() and close()
+    std::condition_variable not_full;   ///< Signalled by pop()
+};
+
+/**
+ * @brief Recovery statistics of a parallel replay.
+ */
+struct WalReplayStats {
+    std::size_t records = 0;                  ///< Records applied
+    unsigned threads = 0;                     ///< Worker threads used
+    std::chrono::microseconds decode_time{0}; ///< Time the reading thread spent decoding, summed over both passes
+    std::chrono::microseconds apply_time{0};  ///< Wall time of both passes, decoding and applying overlapped
+};
+
+#endif // WAL_H